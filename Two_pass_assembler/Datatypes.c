@@ -1,65 +1,270 @@
 #include "Datatypes.h"
 
-/* Add new label to labels array.
+#define INITIAL_LABELS_CAPACITY 16
+#define INITIAL_NAMES_CAPACITY 256
+
+unsigned long findBucket(LabelTable *labels, char *symbol, unsigned int hash);
+
+Boolean growBuckets(LabelTable *labels);
+
+/* Initialize empty labels table.
  *
  * Params:
- * Label **labels: pointer to labels linked list.
- * Label *label: label to add the array.
+ * LabelTable *labels: pointer to the labels table.
 */
-void addNewLabel(Label **labels, Label *label) {
-  if (*labels == NULL) {
-    *labels = label;
-  } else {
-    Label *lastLabel = *labels;
-    while (lastLabel->next != NULL) {
-      lastLabel = lastLabel->next;
+void initLabelTable(LabelTable *labels) {
+  labels->names = NULL;
+  labels->namesLength = 0;
+  labels->namesCapacity = 0;
+  labels->items = NULL;
+  labels->length = 0;
+  labels->capacity = 0;
+  labels->buckets = NULL;
+  labels->bucketsLength = 0;
+}
+
+/* Free all the memory of labels table, and leave it empty.
+ *
+ * Params:
+ * LabelTable *labels: pointer to the labels table.
+*/
+void freeLabelTable(LabelTable *labels) {
+  SymbolId id;
+
+  if (labels == NULL) {
+    return;
+  }
+
+  for (id = 0; id < labels->length; id++) {
+    free(labels->items[id].appearances);
+  }
+  free(labels->names);
+  free(labels->items);
+  free(labels->buckets);
+  initLabelTable(labels);
+}
+
+/* Remove all labels from labels table, but keep its memory for the next file.
+ *
+ * Params:
+ * LabelTable *labels: pointer to the labels table.
+*/
+void resetLabelTable(LabelTable *labels) {
+  unsigned long i;
+  SymbolId id;
+
+  for (id = 0; id < labels->length; id++) {
+    free(labels->items[id].appearances);
+  }
+  for (i = 0; i < labels->bucketsLength; i++) {
+    labels->buckets[i] = NO_SYMBOL;
+  }
+  labels->length = 0;
+  labels->namesLength = 0;
+}
+
+/* Hash symbol name (FNV-1a, 32 bits).
+ *
+ * Params:
+ * char *symbol: the symbol name.
+ *
+ * Returns:
+ * unsigned int hash: the hash of the symbol.
+*/
+unsigned int hashSymbol(char *symbol) {
+  unsigned long hash = 2166136261UL;
+
+  while (*symbol != '\0') {
+    hash ^= (unsigned char) *symbol;
+    hash = (hash * 16777619UL) & 0xFFFFFFFFUL;
+    symbol++;
+  }
+  return (unsigned int) hash;
+}
+
+/* Find the bucket of symbol in the hash table of labels table.
+ * Returns the bucket that holds the symbol, or the empty bucket the symbol should be inserted to.
+ *
+ * Params:
+ * LabelTable *labels: pointer to the labels table (with allocated buckets).
+ * char *symbol: the symbol name.
+ * unsigned int hash: the hash of the symbol.
+ *
+ * Returns:
+ * unsigned long bucket: index in buckets array.
+*/
+unsigned long findBucket(LabelTable *labels, char *symbol, unsigned int hash) {
+  unsigned long mask = labels->bucketsLength - 1;
+  unsigned long bucket = hash & mask;
+  Label *label;
+
+  while (labels->buckets[bucket] != NO_SYMBOL) {
+    label = &labels->items[labels->buckets[bucket]];
+    if (label->hash == hash && strcmp(labels->names + label->name, symbol) == 0) {
+      return bucket;
     }
-    lastLabel->next = label;
+    bucket = (bucket + 1) & mask;
   }
+  return bucket;
+}
 
+/* Double the hash table of labels table and rehash all labels by their stored hash.
+ *
+ * Params:
+ * LabelTable *labels: pointer to the labels table.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean growBuckets(LabelTable *labels) {
+  unsigned long length = labels->bucketsLength == 0 ? INITIAL_LABELS_CAPACITY * 2 : labels->bucketsLength * 2;
+  unsigned long i, mask = length - 1, bucket;
+  SymbolId id;
+  SymbolId *buckets = (SymbolId *) malloc(length * sizeof(SymbolId));
+
+  if (buckets == NULL) {
+    return false;
+  }
+
+  for (i = 0; i < length; i++) {
+    buckets[i] = NO_SYMBOL;
+  }
+  for (id = 0; id < labels->length; id++) {
+    bucket = labels->items[id].hash & mask;
+    while (buckets[bucket] != NO_SYMBOL) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets[bucket] = id;
+  }
+  free(labels->buckets);
+  labels->buckets = buckets;
+  labels->bucketsLength = length;
+  return true;
 }
 
-/* Initialize new label.
+/* Find label by its name.
  *
  * Params:
+ * LabelTable *labels: pointer to the labels table.
  * char *symbol: the symbol of the label.
- * int value: the value of the label.
- * Attributes attr: the attributes of the label.
  *
  * Returns:
- * Label *label: the new label with the parameters to init.
+ * SymbolId id: the id of the label, or NO_SYMBOL if label does not exists.
 */
-Label *initLabel(char *symbol, unsigned long value, Attributes *attr) {
-  Label *newLabel = calloc(1, sizeof(Label));
-  if (newLabel == NULL) {
-    return NULL;
+SymbolId findLabel(LabelTable *labels, char *symbol) {
+  if (labels->length == 0 || symbol == NULL) {
+    return NO_SYMBOL;
   }
+  return labels->buckets[findBucket(labels, symbol, hashSymbol(symbol))];
+}
 
-  newLabel->symbol = (char *) calloc(strlen(symbol) + 1, sizeof(char));
-  if (newLabel->symbol == NULL) {
-    return NULL;
+/* Intern the symbol into the labels table and add new label with it.
+ * If label with this symbol already exists, the first label is kept.
+ *
+ * Params:
+ * LabelTable *labels: pointer to the labels table.
+ * char *symbol: the symbol of the label.
+ * unsigned long value: the value of the label.
+ * Attributes attr: the attributes flags of the label.
+ *
+ * Returns:
+ * SymbolId id: the id of the label, or NO_SYMBOL if allocation failed.
+*/
+SymbolId addNewLabel(LabelTable *labels, char *symbol, unsigned long value, Attributes attr) {
+  unsigned int hash = hashSymbol(symbol);
+  unsigned long bucket, symbolLength = strlen(symbol) + 1;
+  unsigned long namesCapacity;
+  SymbolId capacity;
+  Label *label;
+  char *names;
+
+  if ((labels->length + 1) * 2 > labels->bucketsLength && growBuckets(labels) == false) {
+    return NO_SYMBOL;
+  }
+
+  bucket = findBucket(labels, symbol, hash);
+  if (labels->buckets[bucket] != NO_SYMBOL) {
+    return labels->buckets[bucket];
+  }
+
+  if (labels->length == labels->capacity) {
+    capacity = labels->capacity == 0 ? INITIAL_LABELS_CAPACITY : labels->capacity * 2;
+    label = (Label *) realloc(labels->items, capacity * sizeof(Label));
+    if (label == NULL) {
+      return NO_SYMBOL;
+    }
+    labels->items = label;
+    labels->capacity = capacity;
   }
-  strcpy(newLabel->symbol, symbol);
-  newLabel->value = value;
-  newLabel->attr = *attr;
-  newLabel->appearances = NULL;
-  newLabel->appearancesLength = 0;
-  newLabel->next = NULL;
-  return newLabel;
+
+  if (labels->namesLength + symbolLength > labels->namesCapacity) {
+    namesCapacity = labels->namesCapacity == 0 ? INITIAL_NAMES_CAPACITY : labels->namesCapacity;
+    while (labels->namesLength + symbolLength > namesCapacity) {
+      namesCapacity *= 2;
+    }
+    names = (char *) realloc(labels->names, namesCapacity);
+    if (names == NULL) {
+      return NO_SYMBOL;
+    }
+    labels->names = names;
+    labels->namesCapacity = namesCapacity;
+  }
+
+  label = &labels->items[labels->length];
+  label->name = (unsigned int) labels->namesLength;
+  label->hash = hash;
+  label->value = value;
+  label->attr = attr;
+  label->appearances = NULL;
+  label->appearancesLength = 0;
+  label->appearancesCapacity = 0;
+  memcpy(labels->names + labels->namesLength, symbol, symbolLength);
+  labels->namesLength += symbolLength;
+  labels->buckets[bucket] = labels->length;
+  return labels->length++;
 }
 
-/*
- * Prints all the errors to the stderr file.
+/* Get the interned name of label.
  *
  * Params:
- * Error **error: pointer to error's linked list.
- */
-void printErrorStruct(Error **errors) {
-  Error *lastError = *errors;
-  while (lastError != NULL) {
-    fprintf(stderr, "Error! in line: %d: %s \n", lastError->lineNumber, lastError->message);
-    lastError = lastError->next;
+ * LabelTable *labels: pointer to the labels table.
+ * SymbolId id: the id of the label.
+ *
+ * Returns:
+ * char *name: the symbol of the label.
+*/
+char *getLabelName(LabelTable *labels, SymbolId id) {
+  return labels->names + labels->items[id].name;
+}
+
+/* Format errors list, line for each error: "Error! in line: <line>: <message>".
+ *
+ * Params:
+ * Error *errors: errors linked list.
+ * unsigned long *length: pointer to store the length of the text.
+ *
+ * Returns:
+ * char *text: the formatted errors (dynamic memory).
+*/
+char *formatErrors(Error *errors, unsigned long *length) {
+  unsigned long capacity = 1;
+  Error *error;
+  char *text;
+
+  for (error = errors; error != NULL; error = error->next) {
+    capacity += strlen(error->message) + 40;
+  }
+  text = (char *) calloc(capacity, sizeof(char));
+  if (text == NULL) {
+    *length = 0;
+    return NULL;
+  }
+
+  *length = 0;
+  for (error = errors; error != NULL; error = error->next) {
+    *length += sprintf(text + *length, "Error! in line: %d: %s \n", error->lineNumber, error->message);
   }
+  return text;
 }
 
 /* Initialize new Command node for new line of command.
@@ -72,45 +277,55 @@ void printErrorStruct(Error **errors) {
  * Command command: node of the correct type of command.
 */
 Command *initNewCommand(char *commandLine, unsigned long address) {
-  LineParts *lineParts;
+  char storage[LINE_PARTS_SIZE];
+  LineParts lineParts;
   Command *command;
   CmdType commandType;
 
-  lineParts = getCommandParts(commandLine);
+  /* The line is kept without its trailing blanks. */
+  trimStr(commandLine);
+  if (splitCommandParts(commandLine, &lineParts, storage, sizeof(storage)) == false) {
+    return NULL;
+  }
   command = (Command *) calloc(1, sizeof(Command));
 
   if (command == NULL) {
-    printf("Error: Allocation Error! \n");
     return NULL;
   }
 
   command->line = (char *) calloc(strlen(commandLine) + 1, sizeof(char));
-  commandType = getCmdTypeByCommandName(lineParts->cmdName);
+  if (command->line == NULL) {
+    free(command);
+    return NULL;
+  }
+  commandType = getCmdTypeByCommandName(lineParts.cmdName);
 
   command->address = address;
   strcpy(command->line, commandLine);
   command->type = commandType;
+  command->operand = NO_SYMBOL;
   command->next = NULL;
-  freeLinePart(lineParts);
   return command;
 }
 
-/* Add new command node to the end of the commands linked list.
+/* Add new command node to the end of the commands linked list, after its last node - without walking
+ * the list. Node that was not allocated (NULL) is not added.
  *
  * Params:
  * Command **commands: pointer to linked list of commands.
+ * Command **lastCommand: pointer to the last node of the list (NULL if it is empty), it is updated.
  * Command *command: pointer to the command node that want to add.
 */
-void addNewCommand(Command **commands, Command *command) {
-  if (*commands == NULL) {
+void addNewCommand(Command **commands, Command **lastCommand, Command *command) {
+  if (command == NULL) {
+    return;
+  }
+  if (*lastCommand == NULL) {
     *commands = command;
   } else {
-    Command *lastCommand = *commands;
-    while (lastCommand->next != NULL) {
-      lastCommand = lastCommand->next;
-    }
-    lastCommand->next = command;
+    (*lastCommand)->next = command;
   }
+  *lastCommand = command;
 }
 
 /* Initialize new Data Item node.
@@ -126,7 +341,7 @@ void addNewCommand(Command **commands, Command *command) {
 DataItem *initNewDataItem(long value, unsigned long address, DataSize size) {
   DataItem *dataItem = (DataItem *) calloc(1, sizeof(DataItem));
   if (dataItem == NULL) {
-    printf("Error: Allocation Error! \n");
+    return NULL;
   }
 
   (dataItem->item).value = value;
@@ -136,22 +351,24 @@ DataItem *initNewDataItem(long value, unsigned long address, DataSize size) {
   return dataItem;
 }
 
-/* Insert new data item node to the end of data pictur.
+/* Insert new data item node to the end of data pictur, after its last node - without walking the list.
+ * Node that was not allocated (NULL) is not added.
  *
  * Params:
  * DataItem **dataPicture: pointer to linked list of data picture.
+ * DataItem **lastDataItem: pointer to the last node of the list (NULL if it is empty), it is updated.
  * DataItem *dataItem: pointer to the new node.
 */
-void addNewDataItem(DataItem **dataPicture, DataItem *dataItem) {
-  if (*dataPicture == NULL) {
+void addNewDataItem(DataItem **dataPicture, DataItem **lastDataItem, DataItem *dataItem) {
+  if (dataItem == NULL) {
+    return;
+  }
+  if (*lastDataItem == NULL) {
     *dataPicture = dataItem;
   } else {
-    DataItem *lastDataItem = *dataPicture;
-    while (lastDataItem->next != NULL) {
-      lastDataItem = lastDataItem->next;
-    }
-    lastDataItem->next = dataItem;
+    (*lastDataItem)->next = dataItem;
   }
+  *lastDataItem = dataItem;
 }
 
 /* Initialize new error.
@@ -165,10 +382,14 @@ void addNewDataItem(DataItem **dataPicture, DataItem *dataItem) {
 */
 Error *initNewError(char *message, int numberLine) {
   Error *error = (Error *) calloc(1, sizeof(Error));
-  error->message = (char *) calloc(strlen(message) + 1, sizeof(char));
 
-  if (error == NULL || error->message == NULL) {
-    printf("Error: Allocation Error! \n");
+  if (error == NULL) {
+    return NULL;
+  }
+  error->message = (char *) calloc(strlen(message) + 1, sizeof(char));
+  if (error->message == NULL) {
+    free(error);
+    return NULL;
   }
 
   strcpy(error->message, message);
@@ -178,157 +399,97 @@ Error *initNewError(char *message, int numberLine) {
   return error;
 }
 
-/* Add new error to errors array.
+/* Add new error to the end of errors list, after its last node - without walking the list.
+ * Error that was not allocated (NULL) is not added.
  *
  * Params:
- * Label *errors: pointer to errors linked list.
- * Label *error: error to add the array.
+ * Error **errors: pointer to errors linked list.
+ * Error **lastError: pointer to the last error of the list (NULL if it is empty), it is updated.
+ * Error *error: error to add the list.
 */
-void addNewError(Error **errors, Error *error) {
-  if (*errors == NULL) {
+void addNewError(Error **errors, Error **lastError, Error *error) {
+  if (error == NULL) {
+    return;
+  }
+  if (*lastError == NULL) {
     *errors = error;
   } else {
-    Error *lastError = *errors;
-    while (lastError->next != NULL) {
-      lastError = lastError->next;
-    }
-    lastError->next = error;
+    (*lastError)->next = error;
   }
+  *lastError = error;
 }
 
 /* Mark the label with labelName as Entry.
  *
  * Params:
- * Label **label: pointer to linked lise of labels.
+ * LabelTable *labels: pointer to the labels table.
  * char *labelName: the name of the label we want to mark.
 */
-void markLabelAsEntry(Label **labels, char *labelName) {
-  Label *lastLabel = *labels;
-  while (lastLabel != NULL) {
-    if (strcmp(lastLabel->symbol, labelName) == 0) {
-      lastLabel->attr.isEntry = true;
-      return;
-    }
-    lastLabel = lastLabel->next;
+void markLabelAsEntry(LabelTable *labels, char *labelName) {
+  SymbolId id = findLabel(labels, labelName);
+  if (id != NO_SYMBOL) {
+    labels->items[id].attr |= ATTR_ENTRY;
   }
 }
 
 /* Update data labels by adding ICF.
  *
  * Params:
- * Label **label: pointer to linked lise of labels.
+ * LabelTable *labels: pointer to the labels table.
  * int ICF: the starting address of data segment.
 */
-void updateDataLabels(Label **labels, int ICF) {
-  Label *lastLabel = *labels;
-  while (lastLabel != NULL) {
-    if (lastLabel->attr.isData == true) {
-      lastLabel->value += ICF;
-
+void updateDataLabels(LabelTable *labels, int ICF) {
+  SymbolId id;
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_DATA) {
+      labels->items[id].value += ICF;
     }
-    lastLabel = lastLabel->next;
   }
-  return;
 }
 
-/* Add to label with name of labelName appearance.
+/* Add appearance to the label with the id.
  *
  * Params:
- * Label **label: pointer to linked lise of labels.
- * char *labelName: the name of the label we want to mark.
+ * LabelTable *labels: pointer to the labels table.
+ * SymbolId id: the id of the label.
  * unsigned long addressAppearance: the address of appearance of label.
 */
-void addLabelAppearance(Label **labels, char *labelName, unsigned long addressAppearance) {
-  Label *lastLabel = *labels;
-  while (lastLabel != NULL) {
-    if (strcmp(lastLabel->symbol, labelName) == 0) {
-      if (lastLabel->appearancesLength == 0) {
-        lastLabel->appearances = (unsigned long *) calloc(1, sizeof(int));
-      } else {
-        lastLabel->appearances = (unsigned long *) realloc(lastLabel->appearances,
-                                                           (lastLabel->appearancesLength + 1) * sizeof(int));
-      }
-
-      if (lastLabel->appearances == NULL) {
-        printf("Error: Allocation Error! \n");
-        return;
-      }
-
-      lastLabel->appearances[lastLabel->appearancesLength] = addressAppearance;
-      lastLabel->appearancesLength++;
+void addLabelAppearance(LabelTable *labels, SymbolId id, unsigned long addressAppearance) {
+  Label *label = &labels->items[id];
+  unsigned long *appearances;
+  int capacity;
+
+  if (label->appearancesLength == label->appearancesCapacity) {
+    capacity = label->appearancesCapacity == 0 ? 4 : label->appearancesCapacity * 2;
+    appearances = (unsigned long *) realloc(label->appearances, capacity * sizeof(unsigned long));
+    if (appearances == NULL) {
       return;
     }
-    lastLabel = lastLabel->next;
+    label->appearances = appearances;
+    label->appearancesCapacity = capacity;
   }
+
+  label->appearances[label->appearancesLength] = addressAppearance;
+  label->appearancesLength++;
 }
 
-/* Pass commands list, check if labelName is appear in command from type branch/jmp -
- * if it appears- add this appearance to label.
+/* Pass on commands linked list once, and add appearance for every command that its operand
+ * is label marked as external.
  *
  * Params:
  * Command **command: pointer to linked list of command.
- * Label **labels: pointer to linked list of labels.
- * char *labelName: the name of label we want to update its appearances.
+ * LabelTable *labels: pointer to the labels table.
 */
-void updateLabelAppearances(Command **commands, Label **labels, char *labelName) {
-  char *cmdName, **paramsArr;
+void updateExternalAppearancesLabels(Command **commands, LabelTable *labels) {
   Command *lastCommand = *commands;
-  LineParts *lineParts;
-
   while (lastCommand != NULL) {
-    lineParts = getCommandParts((char *) lastCommand->line);
-    cmdName = lineParts->cmdName;
-    if (lineParts->params != NULL) {
-      paramsArr = strSplit(lineParts->params, ',');
-      if (findInArray(cmdName, jCmd, 2) == true) {
-        if (strcmp(*(paramsArr), labelName) == 0) {
-          addLabelAppearance(labels, labelName, lastCommand->address);
-        }
-
-      } else if (findInArray(cmdName, jJCmd, 1) == true) {
-        if (strcmp(*(paramsArr), labelName) == 0) {
-          addLabelAppearance(labels, labelName, lastCommand->address);
-        }
-      } else if (findInArray(cmdName, iBCmd, 4) == true) {
-        if (strcmp(*(paramsArr + 2), labelName) == 0) {
-          addLabelAppearance(labels, labelName, lastCommand->address);
-        }
-      }
-      freeStringArray(paramsArr);
+    if (lastCommand->operand != NO_SYMBOL && (labels->items[lastCommand->operand].attr & ATTR_EXTERNAL)) {
+      addLabelAppearance(labels, lastCommand->operand, lastCommand->address);
     }
-    freeLinePart(lineParts);
     lastCommand = lastCommand->next;
   }
 }
 
-/* Pass on labels linked list, and update appearances for every label that marked as external.
- *
- * Params:
- * Command **command: pointer to linked list of command.
- * Label **labels: pointer to linked list of labels.
-*/
-void updateExternalAppearancesLabels(Command **commands, Label **labels) {
-  Label *lastLabel = *labels;
-  while (lastLabel != NULL) {
-    if (lastLabel->attr.isExternal == true) {
-      updateLabelAppearances(commands, labels, lastLabel->symbol);
-    }
-    lastLabel = lastLabel->next;
-  }
-}
-
-/* Reset Attributes to default (all of them false).
- *
- * Params:
- * Attributes *attributes: attributes we want to reset.
-*/
-void resetAttributes(Attributes *attributes) {
-  attributes->isCode = false;
-  attributes->isEntry = false;
-  attributes->isExternal = false;
-  attributes->isData = false;
-}
-
 /* Get the type of command (R, I Or J) by command name.
  *
  * Params:
@@ -363,53 +524,76 @@ CmdType getCmdTypeByCommandName(char *commandName) {
  * char *item: substring from command represent item(commandName/ label/ params).
 */
 LineParts *getCommandParts(char *command) {
-  char *string = NULL, *found = NULL, *iterator = NULL;
-  size_t found_len;
+  char storage[LINE_PARTS_SIZE];
+  char *string = storage;
+  size_t size = sizeof(storage);
+  LineParts parts;
   LineParts *lineParts;
 
   if (isEmptyLine(command) == true) {
     return NULL;
   }
 
+  command = trimStr(command);
+  if (strlen(command) >= size) {
+    size = strlen(command) + 1;
+    string = (char *) malloc(size);
+    if (string == NULL) {
+      return NULL;
+    }
+  }
+  splitCommandParts(command, &parts, string, size);
+
   lineParts = (LineParts *) calloc(1, sizeof(LineParts));
 
-  if (lineParts == NULL) {
-    return NULL;
+  if (lineParts != NULL) {
+    lineParts->labelName = duplicateStr(parts.labelName);
+    lineParts->cmdName = duplicateStr(parts.cmdName);
+    lineParts->params = duplicateStr(parts.params);
   }
+  if (string != storage) {
+    free(string);
+  }
+  return lineParts;
+}
 
-  command = trimStr(command);
-  string = duplicateStr(command);
+/* Split command into its parts (label / command / params) without allocation - the parts point into
+ * storage of the caller, that the command is copied into.
+ *
+ * Params:
+ * char *command: the whole command.
+ * LineParts *lineParts: the parts (a part that the command does not have is NULL).
+ * char *storage: memory for the copy of the command.
+ * size_t size: the size of storage.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if the line is empty or longer than storage.
+*/
+Boolean splitCommandParts(char *command, LineParts *lineParts, char *storage, size_t size) {
+  char *found, *iterator;
+  size_t found_len;
 
-  if (string == NULL) {
-    freeLinePart(lineParts);
-    return NULL;
+  if (isEmptyLine(command) == true || strlen(command) >= size) {
+    return false;
   }
 
+  strcpy(storage, command);
+  iterator = trimStr(storage);
+  lineParts->labelName = NULL;
 
-  iterator = string;
   /* Fill the part of the command. */
   found = trimStr(myStrsep(&iterator, " "));
   found_len = strlen(found);
-  if (found_len == 0) {
-    printf("\"%c\" %d \n", found[found_len - 1], found_len);
-  }
 
   if (found[found_len - 1] == ':') {
-    lineParts->labelName = (char *) calloc(found_len, sizeof(char));
-    if (lineParts->labelName == NULL) {
-      printf("Error: Allocation error \n");
-      return NULL;
-    }
-    memcpy(lineParts->labelName, found, found_len - 1);
-    lineParts->labelName[found_len - 1] = '\0';
+    found[found_len - 1] = '\0';
+    lineParts->labelName = found;
     found = trimStr(myStrsep(&iterator, " "));
   }
 
-  lineParts->cmdName = duplicateStr(found);
-  found = trimStr(myStrsep(&iterator, "\r\n"));
-  lineParts->params = duplicateStr(found);
-  free(string);
-  return lineParts;
+  lineParts->cmdName = found;
+  lineParts->params = trimStr(myStrsep(&iterator, "\r\n"));
+  return true;
 }
 
 /* Check if commandName is exists in the array.
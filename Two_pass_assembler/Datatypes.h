@@ -5,6 +5,8 @@
 #include "constants.h"
 #include "stringExtension.h"
 
+#define MAX_LABEL_LENGTH 31
+
 typedef enum {
     db, dw, dh, asciz, entry, external
 } OrderType;
@@ -37,7 +39,9 @@ typedef enum {
     memory_Allocation,
     missing_quotations,
     empty_label,
-    label_with_invalid_line
+    label_with_invalid_line,
+    branch_out_of_range,
+    address_out_of_range
 } ErrorType;
 
 typedef enum {
@@ -45,24 +49,47 @@ typedef enum {
     false
 } Boolean;
 
+/* Bit flags of label attributes, packed into one byte. */
+#define ATTR_CODE 1
+#define ATTR_DATA 2
+#define ATTR_ENTRY 4
+#define ATTR_EXTERNAL 8
+
 /*Data structure representing attributes*/
-typedef struct attributes {
-    Boolean isCode;
-    Boolean isData;
-    Boolean isEntry;
-    Boolean isExternal;
-} Attributes;
+typedef unsigned char Attributes;
+
+/* Id of interned symbol - index of the label in the labels table. */
+typedef unsigned int SymbolId;
+
+#define NO_SYMBOL ((SymbolId) -1)
 
 /*Data structure representing label */
 typedef struct label {
-    char *symbol;
+    unsigned int name;
+    unsigned int hash;
     unsigned long value;
-    Attributes attr;
     unsigned long *appearances;
     int appearancesLength;
-    struct label *next;
+    int appearancesCapacity;
+    Attributes attr;
 } Label;
 
+/* Data structure representing labels table - names are interned once into one arena,
+ * labels are stored by SymbolId and found by open addressing hash table. */
+typedef struct labelTable {
+    char *names;
+    unsigned long namesLength;
+    unsigned long namesCapacity;
+    Label *items;
+    SymbolId length;
+    SymbolId capacity;
+    SymbolId *buckets;
+    unsigned long bucketsLength;
+} LabelTable;
+
+/* The size of storage for the parts of line on the stack (longer lines are copied to the heap). */
+#define LINE_PARTS_SIZE 128
+
 typedef struct lineParts {
     char *labelName;
     char *cmdName;
@@ -108,11 +135,28 @@ typedef struct jCommand {
     unsigned int address: 25;
 } JCommand;
 
-/* Data structure representing assembly command */
+/* The largest address that the address field of J command holds (25 bits). */
+#define MAX_ADDRESS 0x1FFFFFFUL
+/* The distances of branch that its immediate holds (16 bits signed). */
+#define MIN_BRANCH_DISTANCE (-32768L)
+#define MAX_BRANCH_DISTANCE 32767L
+
+/* The encoding of command in one of the formats. */
+typedef union commandBits {
+    RCommand r;
+    ICommand i;
+    JCommand j;
+} CommandBits;
+
+/* Data structure representing assembly command.
+ * bits points to encoding (in the command itself) once pass 2 encoded it, otherwise it is NULL. */
 typedef struct command {
     unsigned long address;
     void *bits;
+    CommandBits encoding;
     CmdType type;
+    SymbolId operand;
+    int lineNumber;
     char *line;
     struct command *next;
 } Command;
@@ -134,45 +178,54 @@ typedef struct dataItem {
     unsigned long address;
     Data item;
     DataSize size;
+    int lineNumber;
     struct dataItem *next;
 } DataItem;
 
 Boolean isEmptyLine(char *line);
 
-void addNewLabel(Label **labels, Label *label);
+void initLabelTable(LabelTable *labels);
 
-Label *initLabel(char *symbol, unsigned long value, Attributes *attr);
+void freeLabelTable(LabelTable *labels);
 
-void printErrorStruct(Error **errors);
+void resetLabelTable(LabelTable *labels);
+
+unsigned int hashSymbol(char *symbol);
+
+SymbolId findLabel(LabelTable *labels, char *symbol);
+
+SymbolId addNewLabel(LabelTable *labels, char *symbol, unsigned long value, Attributes attr);
+
+char *getLabelName(LabelTable *labels, SymbolId id);
+
+char *formatErrors(Error *errors, unsigned long *length);
 
 Command *initNewCommand(char *commandLine, unsigned long address);
 
-void addNewCommand(Command **commands, Command *command);
+void addNewCommand(Command **commands, Command **lastCommand, Command *command);
 
 Error *initNewError(char *message, int numberLine);
 
-void addNewError(Error **errors, Error *error);
-
-void markLabelAsEntry(Label **labels, char *labelName);
+void addNewError(Error **errors, Error **lastError, Error *error);
 
-void updateDataLabels(Label **labels, int ICF);
+void markLabelAsEntry(LabelTable *labels, char *labelName);
 
-void addLabelAppearance(Label **labels, char *labelName, unsigned long addressAppearance);
+void updateDataLabels(LabelTable *labels, int ICF);
 
-void updateLabelAppearances(Command **commands, Label **labels, char *labelName);
+void addLabelAppearance(LabelTable *labels, SymbolId id, unsigned long addressAppearance);
 
-void updateExternalAppearancesLabels(Command **commands, Label **labels);
+void updateExternalAppearancesLabels(Command **commands, LabelTable *labels);
 
 DataItem *initNewDataItem(long value, unsigned long address, DataSize size);
 
-void addNewDataItem(DataItem **dataPicture, DataItem *dataItem);
-
-void resetAttributes(Attributes *attributes);
+void addNewDataItem(DataItem **dataPicture, DataItem **lastDataItem, DataItem *dataItem);
 
 CmdType getCmdTypeByCommandName(char *commandName);
 
 LineParts *getCommandParts(char *command);
 
+Boolean splitCommandParts(char *command, LineParts *lineParts, char *storage, size_t size);
+
 Boolean isCommandInArray(int numOfCommands, char **commands, char *commandName);
 
 Boolean findInArray(char *command, char **arr, int length);
@@ -0,0 +1,87 @@
+#include "allocations.h"
+
+void *__real_malloc(size_t size);
+
+void *__real_calloc(size_t count, size_t size);
+
+void *__real_realloc(void *pointer, size_t size);
+
+void __real_free(void *pointer);
+
+Boolean countingAllocations = false;
+
+/* The counters are shared by all the threads. */
+volatile unsigned long allocationsCount = 0;
+volatile unsigned long allocatedBytes = 0;
+volatile long liveAllocations = 0;
+
+/* Start counting the allocations (it is off by default, so the wrappers cost nothing more than a test).
+*/
+void startCountingAllocations(void) {
+  countingAllocations = true;
+}
+
+/* Get the number of allocations since the counting started.
+ *
+ * Returns:
+ * unsigned long count: the number of allocations.
+*/
+unsigned long getAllocationsCount(void) {
+  return allocationsCount;
+}
+
+/* Get the number of bytes that were allocated since the counting started.
+ *
+ * Returns:
+ * unsigned long bytes: the number of bytes.
+*/
+unsigned long getAllocatedBytes(void) {
+  return allocatedBytes;
+}
+
+/* Get the number of blocks that were allocated and not freed since the counting started
+ * (realloc of block that exists does not count). Negative if blocks that were allocated before the
+ * counting were freed.
+ *
+ * Returns:
+ * long count: the number of live blocks.
+*/
+long getLiveAllocations(void) {
+  return liveAllocations;
+}
+
+void *__wrap_malloc(size_t size) {
+  if (countingAllocations == true) {
+    __sync_fetch_and_add(&allocationsCount, 1);
+    __sync_fetch_and_add(&allocatedBytes, size);
+    __sync_fetch_and_add(&liveAllocations, 1);
+  }
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+  if (countingAllocations == true) {
+    __sync_fetch_and_add(&allocationsCount, 1);
+    __sync_fetch_and_add(&allocatedBytes, count * size);
+    __sync_fetch_and_add(&liveAllocations, 1);
+  }
+  return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+  if (countingAllocations == true) {
+    __sync_fetch_and_add(&allocationsCount, 1);
+    __sync_fetch_and_add(&allocatedBytes, size);
+    if (pointer == NULL) {
+      __sync_fetch_and_add(&liveAllocations, 1);
+    }
+  }
+  return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void *pointer) {
+  if (countingAllocations == true && pointer != NULL) {
+    __sync_fetch_and_sub(&liveAllocations, 1);
+  }
+  __real_free(pointer);
+}
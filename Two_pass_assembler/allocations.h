@@ -0,0 +1,21 @@
+#ifndef MAMAN14_ALLOCATIONS_H
+#define MAMAN14_ALLOCATIONS_H
+
+#include "Datatypes.h"
+
+/*
+ * Counting of the allocations of the assembler. The assembler is linked with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free, so every allocation and free of its
+ * objects (and of the library that is linked into it) passes through the wrappers. Allocations of
+ * the C library itself are not counted.
+ */
+
+void startCountingAllocations(void);
+
+unsigned long getAllocationsCount(void);
+
+unsigned long getAllocatedBytes(void);
+
+long getLiveAllocations(void);
+
+#endif
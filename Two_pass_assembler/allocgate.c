@@ -0,0 +1,304 @@
+#include "libassembler.h"
+#include "generator.h"
+#include "allocations.h"
+
+#define DEFAULT_BUDGET "tests/alloc_budget.txt"
+#define DEFAULT_LINES 20000
+#define MAX_BUDGETS 32
+#define MAX_BUDGET_NAME 64
+
+/* Data structure representing one measured count of allocations. */
+typedef struct budget {
+    char name[MAX_BUDGET_NAME];
+    double value;
+} Budget;
+
+/* Data structure representing the allocations of the phases of one run. */
+typedef struct phaseAllocations {
+    unsigned long begin[NUM_OF_PHASES];
+    unsigned long phases[NUM_OF_PHASES];
+} PhaseAllocations;
+
+void countPhase(void *data, AssemblerPhase phase, Boolean begin);
+
+Boolean feedLines(AssemblerContext *context, Buffer *source, unsigned long *maxLine, unsigned long *lines);
+
+Boolean measureAllocations(Budget *budgets, int *length, unsigned long seed, unsigned long numOfLines);
+
+void addBudget(Budget *budgets, int *length, char *name, double value);
+
+Boolean writeBudget(char *path, Budget *budgets, int length);
+
+int compareBudget(char *path, Budget *budgets, int length);
+
+/*
+ * Allocation gate: assemble generated source line by line with every allocation and free counted
+ * (the gate is linked with the wrappers of allocations.h), and compare the allocations of every phase
+ * and of every line with the committed budget. The source is assembled once to warm up the memory
+ * that the context keeps (the buffers of the outputs, the labels table), and the second run - the
+ * steady state - is measured. Pass 2 and the writers of the outputs may not allocate at all, and the
+ * context must free every block that it allocated.
+ *
+ * Usage: allocgate [--budget=FILE] [--seed=N] [--lines=N] [--write]
+ */
+int main(int args, char *argv[]) {
+  char *path = DEFAULT_BUDGET;
+  unsigned long seed = 1;
+  unsigned long numOfLines = DEFAULT_LINES;
+  Boolean write = false;
+  Budget budgets[MAX_BUDGETS];
+  int length = 0;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--budget=", 9) == 0) {
+      path = argv[i] + 9;
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+    } else if (strncmp(argv[i], "--lines=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfLines = strtoul(argv[i] + 8, NULL, 10);
+    } else if (strcmp(argv[i], "--write") == 0) {
+      write = true;
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  startCountingAllocations();
+  if (measureAllocations(budgets, &length, seed, numOfLines) == false) {
+    exit(1);
+  }
+
+  if (write == true) {
+    if (writeBudget(path, budgets, length) == false) {
+      exit(1);
+    }
+    printf("The budget was written to %s \n", path);
+    return 0;
+  }
+  return compareBudget(path, budgets, length);
+}
+
+/* The phase hook of the runs - add the allocations of every phase.
+ *
+ * Params:
+ * void *data: pointer to the allocations of the phases.
+ * AssemblerPhase phase: the phase.
+ * Boolean begin: true at the begin of the phase, false at its end.
+*/
+void countPhase(void *data, AssemblerPhase phase, Boolean begin) {
+  PhaseAllocations *allocations = (PhaseAllocations *) data;
+
+  if (begin == true) {
+    allocations->begin[phase] = getAllocationsCount();
+  } else {
+    allocations->phases[phase] += getAllocationsCount() - allocations->begin[phase];
+  }
+}
+
+/* Assemble the source by feeding its lines one by one, and find the line of pass 1 that allocated
+ * the most.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * Buffer *source: the source.
+ * unsigned long *maxLine: the most allocations of one line.
+ * unsigned long *lines: the number of the lines.
+ *
+ * Returns:
+ * Boolean status: true if the source was assembled, otherwise - false.
+*/
+Boolean feedLines(AssemblerContext *context, Buffer *source, unsigned long *maxLine, unsigned long *lines) {
+  unsigned long position = 0;
+  unsigned long allocations;
+  int length;
+
+  *maxLine = 0;
+  *lines = 0;
+  beginSource(context);
+  while (position < source->length) {
+    for (length = 0; position + length < source->length && length < MAX_LINE_LENGTH; length++) {
+      if (source->data[position + length] == '\n') {
+        length++;
+        break;
+      }
+    }
+    allocations = getAllocationsCount();
+    feedSourceLine(context, source->data + position, length);
+    if (getAllocationsCount() - allocations > *maxLine) {
+      *maxLine = getAllocationsCount() - allocations;
+    }
+    position += length;
+    (*lines)++;
+  }
+  return finishSource(context) == assembled ? true : false;
+}
+
+/* Assemble generated source twice with the same context, and add the allocations of the second run:
+ * of every phase per line (per instruction for pass 2 and the object file), of the line that
+ * allocated the most, and the blocks that were not freed with the context.
+ *
+ * Params:
+ * Budget *budgets: the measured counts.
+ * int *length: pointer to the number of the counts.
+ * unsigned long seed: the seed of the generated source.
+ * unsigned long numOfLines: the number of lines of the generated source.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean measureAllocations(Budget *budgets, int *length, unsigned long seed, unsigned long numOfLines) {
+  char name[MAX_BUDGET_NAME];
+  AssemblerContext context;
+  PhaseAllocations allocations;
+  GeneratorMix mix;
+  Buffer source;
+  unsigned long maxLine, lines, instructions;
+  long live;
+  int run, i;
+
+  initGeneratorMix(&mix);
+  initBuffer(&source);
+  if (generateSource(&source, seed, numOfLines, &mix) == false) {
+    printf("Error: Allocation Error! \n");
+    return false;
+  }
+
+  live = getLiveAllocations();
+  initAssemblerContext(&context);
+  context.sym = true;
+  context.listing = true;
+  context.debug = true;
+  context.phaseHook = countPhase;
+  context.phaseData = &allocations;
+  for (run = 0; run < 2; run++) {
+    for (i = 0; i < NUM_OF_PHASES; i++) {
+      allocations.phases[i] = 0;
+    }
+    if (feedLines(&context, &source, &maxLine, &lines) == false) {
+      printf("The generated source was not assembled \n");
+      freeAssemblerContext(&context);
+      freeBuffer(&source);
+      return false;
+    }
+  }
+  instructions = (context.IC - 100) / 4;
+  freeAssemblerContext(&context);
+  live = getLiveAllocations() - live;
+  freeBuffer(&source);
+
+  /* The phases of the command line (read and save) do not run in the library. */
+  for (i = pass1_phase; i < save_phase; i++) {
+    if (i == pass2_phase || i == object_phase) {
+      sprintf(name, "%s.per_instruction", phaseNames[i]);
+      addBudget(budgets, length, name, instructions > 0 ? (double) allocations.phases[i] / instructions : 0);
+    } else {
+      sprintf(name, "%s.per_line", phaseNames[i]);
+      addBudget(budgets, length, name, (double) allocations.phases[i] / lines);
+    }
+  }
+  addBudget(budgets, length, "line.max", (double) maxLine);
+  addBudget(budgets, length, "leaked_blocks", (double) live);
+  return true;
+}
+
+/* Add measured count.
+ *
+ * Params:
+ * Budget *budgets: the measured counts.
+ * int *length: pointer to the number of the counts.
+ * char *name: the name of the count.
+ * double value: the count.
+*/
+void addBudget(Budget *budgets, int *length, char *name, double value) {
+  Budget *budget;
+
+  if (*length == MAX_BUDGETS) {
+    return;
+  }
+  budget = &budgets[(*length)++];
+  strncpy(budget->name, name, MAX_BUDGET_NAME - 1);
+  budget->name[MAX_BUDGET_NAME - 1] = '\0';
+  budget->value = value;
+}
+
+/* Write the measured counts as the new budget.
+ *
+ * Params:
+ * char *path: the path of the budget.
+ * Budget *budgets: the measured counts.
+ * int length: the number of the counts.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean writeBudget(char *path, Budget *budgets, int length) {
+  FILE *fptr = fopen(path, "w");
+  int i;
+
+  if (fptr == NULL) {
+    printf("Cannot create file %s \n", path);
+    return false;
+  }
+  fprintf(fptr, "# Budget of make allocheck (written by make allocbudget): metric allocations\n");
+  for (i = 0; i < length; i++) {
+    fprintf(fptr, "%s %.4f\n", budgets[i].name, budgets[i].value);
+  }
+  fclose(fptr);
+  return true;
+}
+
+/* Compare the measured counts with the budget, and print table of them.
+ *
+ * Params:
+ * char *path: the path of the budget.
+ * Budget *budgets: the measured counts.
+ * int length: the number of the counts.
+ *
+ * Returns:
+ * int status: 0 if every count is within its budget, otherwise - 1.
+*/
+int compareBudget(char *path, Budget *budgets, int length) {
+  char line[MAX_FORMAT_LENGTH];
+  char name[MAX_FORMAT_LENGTH];
+  double value;
+  FILE *fptr = fopen(path, "r");
+  char *verdict;
+  int overruns = 0;
+  int i;
+
+  if (fptr == NULL) {
+    printf("Cannot open the budget %s (make allocbudget writes it) \n", path);
+    return 1;
+  }
+
+  printf("%-32s %12s %12s\n", "metric", "budget", "current");
+  while (fgets(line, sizeof(line), fptr) != NULL) {
+    if (line[0] == '#' || sscanf(line, "%63s %lf", name, &value) != 2) {
+      continue;
+    }
+    for (i = 0; i < length && strcmp(budgets[i].name, name) != 0; i++) {
+    }
+    if (i == length) {
+      printf("%-32s %12.4f %12s  MISSING\n", name, value, "-");
+      overruns++;
+      continue;
+    }
+
+    /* The budget is rounded to 4 digits when it is written. */
+    verdict = "ok";
+    if (budgets[i].value > value + 0.00005) {
+      verdict = "OVER BUDGET";
+      overruns++;
+    }
+    printf("%-32s %12.4f %12.4f  %s\n", name, value, budgets[i].value, verdict);
+  }
+  fclose(fptr);
+
+  if (overruns > 0) {
+    printf("Error! %d allocation counts are over their budget. \n", overruns);
+    return 1;
+  }
+  return 0;
+}
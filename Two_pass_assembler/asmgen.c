@@ -0,0 +1,82 @@
+#include "generator.h"
+
+Boolean parseGeneratorOption(char *arg, unsigned long *seed, unsigned long *numOfLines, GeneratorMix *mix);
+
+/*
+ * Generator of synthetic sources for benchmarks, the source is written to stdout. It is valid unless
+ * --errors asks for lines with errors.
+ *
+ * Usage: asmgen [--seed=N] [--lines=N] [--r=W] [--i=W] [--branch=W] [--j=W] [--data=W]
+ *               [--labels=PERCENT] [--externs=N] [--entries=N] [--items=N] [--string=N]
+ *               [--errors=PERCENT] > file.as
+ */
+int main(int args, char *argv[]) {
+  unsigned long seed = 1;
+  unsigned long numOfLines = 1000;
+  GeneratorMix mix;
+  Buffer source;
+  int i;
+
+  initGeneratorMix(&mix);
+  for (i = 1; i < args; i++) {
+    if (parseGeneratorOption(argv[i], &seed, &numOfLines, &mix) == false) {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  initBuffer(&source);
+  if (generateSource(&source, seed, numOfLines, &mix) == false) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+  fwrite(source.data, 1, source.length, stdout);
+  freeBuffer(&source);
+  return 0;
+}
+
+/* Read one option of the generator.
+ *
+ * Params:
+ * char *arg: the command line argument.
+ * unsigned long *seed: pointer to the seed.
+ * unsigned long *numOfLines: pointer to the number of lines.
+ * GeneratorMix *mix: pointer to the mix.
+ *
+ * Returns:
+ * Boolean status: true if the option is valid, otherwise - false.
+*/
+Boolean parseGeneratorOption(char *arg, unsigned long *seed, unsigned long *numOfLines, GeneratorMix *mix) {
+  char *names[11] = {"--r=", "--i=", "--branch=", "--j=", "--data=", "--labels=", "--externs=", "--entries=",
+                     "--items=", "--string=", "--errors="};
+  int *values[11];
+  int i;
+
+  values[0] = &mix->rWeight;
+  values[1] = &mix->iWeight;
+  values[2] = &mix->branchWeight;
+  values[3] = &mix->jWeight;
+  values[4] = &mix->dataWeight;
+  values[5] = &mix->labelsPercent;
+  values[6] = &mix->numOfExterns;
+  values[7] = &mix->numOfEntries;
+  values[8] = &mix->dataItems;
+  values[9] = &mix->stringLength;
+  values[10] = &mix->errorsPercent;
+
+  if (strncmp(arg, "--seed=", 7) == 0) {
+    *seed = strtoul(arg + 7, NULL, 10);
+    return true;
+  }
+  if (strncmp(arg, "--lines=", 8) == 0) {
+    *numOfLines = strtoul(arg + 8, NULL, 10);
+    return true;
+  }
+  for (i = 0; i < 11; i++) {
+    if (strncmp(arg, names[i], strlen(names[i])) == 0 && atoi(arg + strlen(names[i])) >= 0) {
+      *values[i] = atoi(arg + strlen(names[i]));
+      return true;
+    }
+  }
+  return false;
+}
@@ -1,51 +1,64 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
-#include "parserInput.h"
-#include "encoding.h"
-#include "validation.h"
-#include "files.h"
+#include "diskFiles.h"
+#include "options.h"
+#include "globalIndex.h"
+#include "cache.h"
+#include "watch.h"
+#include "daemon.h"
+#include "pipeline.h"
+#include "prefetch.h"
+#include "stats.h"
+#include "trace.h"
+#include "assembler.h"
 
 
-#define MAX_LINE_LENGTH 80
-
 char *allocateMemory(size_t length);
 
-int getLine(FILE *stream, char *line, int length);
-
-void
-pass1(Label **labels, Error **errors, int *numOfErrors, Command **commands, DataItem **dataPicture, unsigned long *IC,
-      unsigned long *DC,
-      FILE *stream);
-
-void validateFile(FILE *stream, Error **errors, Label *labels, int *numOfErrors);
-
-void updateDataPictureAddress(DataItem **dataPicture, unsigned long ICF);
-
-void pass2(Command **commands, Label *labels);
-
-void freeCommands(Command **commands);
-
-void freeErrors(Error **errors);
-
-void freeDataPicture(DataItem **dataPicture);
-
-void freeLabels(Label **labels);
+void applyOptions(Options *options, AssemblerContext *context);
 
 int main(int args, char *argv[]) {
   char *filename = NULL;
+  char *content;
+  unsigned long length;
   FILE *fptr = NULL;
-  Label *labels = NULL;
-  Error *errors = NULL;
-  Command *commands = NULL;
-  DataItem *dataPicture = NULL;
-  unsigned long IC = 100;
-  unsigned long DC = 0;
-  unsigned long ICF;
-  unsigned long DCF;
-  int numOfErrors = 0;
   int assemblerIndex = 1;
+  int status = 0;
+  Options options;
+  GlobalIndex globalIndex;
+  Prefetcher prefetcher;
+  Stats stats;
+  AssemblerContext context;
+
+  if (parseOptions(args, argv, &options) == false) {
+    exit(1);
+  }
+
+  if (options.watch == true) {
+    return watchFiles(args, argv, &options);
+  }
+  if (options.socketPath != NULL) {
+    return runDaemon(&options);
+  }
 
+  if (options.tracePath != NULL && startTrace(options.tracePath) == false) {
+    exit(1);
+  }
+  initAssemblerContext(&context);
+  if (options.stats != STATS_NONE) {
+    initStats(&stats, options.stats);
+    if (options.counters == true) {
+      enableStatsCounters(&stats);
+    }
+  }
+  if (options.batch == true) {
+    initGlobalIndex(&globalIndex);
+  }
+  /* The next files are read while the current one is assembled. */
+  if (options.prefetch > 0) {
+    startPrefetcher(&prefetcher, args, argv, options.prefetch);
+  }
   for (assemblerIndex = 1; assemblerIndex < args; assemblerIndex++) {
     /* Ensure you have filename as the first argument. */
     if (argv[assemblerIndex] == NULL) {
@@ -53,6 +66,10 @@ int main(int args, char *argv[]) {
       continue;
     }
 
+    if (isOption(argv[assemblerIndex]) == true) {
+      continue;
+    }
+
     if (isAsFile(argv[assemblerIndex]) != 0) {
       printf("File is not as file");
       continue;
@@ -61,379 +78,223 @@ int main(int args, char *argv[]) {
     filename = allocateMemory(strlen(argv[assemblerIndex]));
     strcpy(filename, argv[assemblerIndex]);
 
-    /* Open the file. */
-    fptr = fopen(filename, "r");
-    if (fptr == NULL) {
-      printf("Cannot open file \n");
-      exit(1);
+    /* Take the content that was read ahead, or open the file. */
+    content = NULL;
+    fptr = NULL;
+    if (options.prefetch > 0) {
+      traceBegin("wait", "prefetch", filename);
+      content = getPrefetchedContent(&prefetcher, &length);
+      traceEnd("wait", "prefetch", -1, -1);
+    }
+    if (content == NULL) {
+      fptr = fopen(filename, "r");
+      if (fptr == NULL) {
+        printf("Cannot open file \n");
+        exit(1);
+      }
     }
 
-    pass1(&labels, &errors, &numOfErrors, &commands, &dataPicture, &IC, &DC, fptr);
-    validateFile(fptr, &errors, labels, &numOfErrors);
-    ICF = IC;
-    DCF = DC + ICF;
-
-    if (numOfErrors == 0) {
-      updateDataPictureAddress(&dataPicture, ICF);
-      pass2(&commands, labels);
-      updateExternalAppearancesLabels(&commands, &labels);
-      createObjectFile(filename, &commands, &dataPicture, ICF, DCF);
-      createEntryFile(labels, filename);
-      createExternalFile(labels, filename);
-    } else {
-      printErrorStruct(&errors);
+    if (assembleFile(filename, fptr, content, length, &options, &globalIndex, &context,
+                     options.stats != STATS_NONE ? &stats : NULL) != assembled && options.check == true) {
+      status = 1;
     }
-    IC = 100;
-    DC = 0;
-    ICF = 0;
-    DCF = 0;
-    numOfErrors = 0;
-    freeCommands(&commands);
-    freeDataPicture(&dataPicture);
-    freeLabels(&labels);
-    freeErrors(&errors);
     free(filename);
-    fclose(fptr);
+    if (fptr != NULL) {
+      fclose(fptr);
+    }
+    if (options.prefetch > 0) {
+      releasePrefetchedFile(&prefetcher);
+    }
   }
-
-  return 0;
-}
-
-/* Allocate memory to string.
- *
- * Params:
- * char *str: pointer to the string for allocating it memory.
- * int length: number of char to allocate.
- *
- * Returns:
- * char *str: pointer to the allocated memory.
-*/
-char *allocateMemory(size_t length) {
-  char *str = (char *) calloc(length + 1, sizeof(char));
-  if (str == NULL) {
-    printf("Error: Allocation error!");
-    return NULL;
+  if (options.prefetch > 0) {
+    stopPrefetcher(&prefetcher);
   }
-  return str;
-}
+  freeAssemblerContext(&context);
+  finishTrace();
 
-/* Get next line from file.
- *
- * Params:
- * FILE *stream: pointer to file (file is already open).
- * char *line: array to copy the line into it.
- * size_t length: max number of read from the line (read until \n but if the line length is more than length, read length chars).
- *
- * Returns:
- * int length: num of char readed in the line.
-*/
-int getLine(FILE *stream, char *line, int length) {
-  int cnt;
-  int c = 0;
-
-  if (length == 0)
-    return 0;
+  if (options.stats != STATS_NONE) {
+    printStats(&stats);
+    freeStats(&stats);
+  }
 
-  for (cnt = 0; c != '\n' && cnt < length - 1; cnt++) {
-    c = getc(stream);
+  if (options.cacheDir != NULL) {
+    evictCache(&options);
+  }
 
-    if (c == EOF) {
-      if (cnt == 0)
-        return -1;
-      break;
+  /* Report the problems between the files only when all of them are assembled. */
+  if (options.batch == true) {
+    if (reportGlobalIndex(&globalIndex) > 0) {
+      status = 1;
     }
-
-      line[cnt] = (char) c;
+    freeGlobalIndex(&globalIndex);
   }
-    line[cnt] = '\0';
-  return cnt + 1;
+  return status;
 }
 
-/* Pass 1 of the assembler, read line by line and create labels table, and encode the orders.
+/* Assemble one file - run both passes and create the output files, or print the errors.
+ * When cache is enabled, the outputs are restored from the cache if the source did not change.
+ * With --check, the file is only checked: nothing is written, and the errors are printed with its name.
  *
  * Params:
- * Label **labels: labels table.
- * Error *error: error array.
- * int *IC: pointer to Instruction Counter.
- * int *DC: pointer to Data Counter.
- * FILE *stream: pointer to file (file already open).
+ * char *filename: the name of the file.
+ * FILE *fptr: pointer to the file (file is already open), used only when content is NULL.
+ * const char *content: the source when it is already in memory (read ahead by --prefetch), or NULL.
+ * unsigned long length: the length of the content.
+ * Options *options: the options of the assembler.
+ * GlobalIndex *globalIndex: the global index of the batch (used only in batch mode).
+ * AssemblerContext *context: the context of the assembler, it is left empty.
+ * Stats *stats: the statistics to record the file into (NULL without --stats).
+ *
+ * Returns:
+ * AssemblerStatus status: assembled if the file has no errors, otherwise - its status.
 */
-void
-pass1(Label **labels, Error **errors, int *numOfErrors, Command **commands, DataItem **dataPicture, unsigned long *IC,
-      unsigned long *DC,
-      FILE *stream) {
-  int read;
-  LineType type;
-  char *labelName;
-  size_t len = 81;
-  Label *label;
-  char *cmd;
-  char *params;
-  Command *command;
-  Error *error;
-  int numOfLines = 0;
-  char line[81];
-  LineParts *lineParts;
-  char *errorMsg = (char *) calloc(100, sizeof(char));
-  Attributes *attributes = (Attributes *) calloc(1, sizeof(Attributes));
-  if (attributes == NULL || errorMsg == NULL) {
-    printf("Allocation Error!");
-    exit(1);
-  }
-
-  /* Build labels table. */
-  while ((read = getLine(stream, line, MAX_LINE_LENGTH + 1)) != -1) {
-    if (read > MAX_LINE_LENGTH) {
-      numOfLines++;
-      error = initNewError("line length is over than 80. \n", numOfLines);
-      addNewError(errors, error);
-      (*numOfErrors)++;
-      read = getLine(stream, line, MAX_LINE_LENGTH + 1);
-      continue;
-    }
-    type = getLineType(line);
-    resetAttributes(attributes);
-    if (type == invalid_line) {
-      numOfLines++;
-      continue;
-    }
-    if (type == blank_line || type == comment_line) {
-      numOfLines++;
-      continue;
-    } else {
-      lineParts = getCommandParts(line);
-      labelName = lineParts->labelName;
-      if (labelName != NULL) {
-        if (type == order_line) {
-          attributes->isData = true;
-          label = initLabel(labelName, *DC, attributes);
-        } else if (type == cmd_line) {
-          attributes->isCode = true;
-          label = initLabel(labelName, *IC, attributes);
-        }
-        addNewLabel(labels, label);
-      }
-
-      if (type == order_line) {
-        cmd = lineParts->cmdName;
-        if (strcmp(cmd, ".extern") == 0 || strcmp(cmd, ".entry") == 0) {
-          numOfLines++;
-          freeLinePart(lineParts);
-          continue;
-        } else if (strcmp(cmd, ".asciz") == 0) {
-          encodeAscizOrder(dataPicture, line, DC);
-        } else {
-          encodeOrder(dataPicture, line, DC);
-        }
-      } else if (type == cmd_line) {
-        command = initNewCommand(line, *IC);
-        addNewCommand(commands, command);
-        *IC += 4;
-      }
-      freeLinePart(lineParts);
-    }
-    numOfLines++;
+AssemblerStatus assembleFile(char *filename, FILE *fptr, const char *content, unsigned long length, Options *options,
+                             GlobalIndex *globalIndex, AssemblerContext *context, Stats *stats) {
+  AssemblerStatus status;
+  char key[CACHE_KEY_LENGTH + 1];
 
+  if (stats != NULL) {
+    beginFileStats(stats, filename, context);
   }
-
-  /* Back to the start of the file*/
-  fseek(stream, 0, SEEK_SET);
-  numOfLines = 0;
-
-  /* Read line by line, and mark each label that pass to entry/external command*/
-  while ((read = getLine(stream, line, len)) != -1) {
-    if (read > MAX_LINE_LENGTH) {
-      numOfLines++;
-      read = getLine(stream, line, MAX_LINE_LENGTH + 1);
-      continue;
-    }
-    resetAttributes(attributes);
-    lineParts = getCommandParts(line);
-    cmd = lineParts->cmdName;
-    if (cmd == NULL) {
-      freeLinePart(lineParts);
-      continue;
+  beginFileTrace(filename, context);
+  if (options->cacheDir != NULL) {
+    if (content != NULL) {
+      computeContentCacheKey(content, length, options, key);
+    } else {
+      computeCacheKey(fptr, options, key);
     }
-
-    params = lineParts->params;
-    if (strcmp(cmd, ".extern") == 0) {
-      if (isLabelExists(*labels, params) == true) {
-        sprintf(errorMsg, "The label: %s, label that exist this file could not be external! \n", params);
-        error = initNewError(errorMsg, numOfLines);
-        addNewError(errors, error);
-        (*numOfErrors)++;
-        numOfLines++;
-        freeLinePart(lineParts);
-        continue;
+    if (restoreCacheEntry(options, key, filename, globalIndex, &status) == true) {
+      endFileTrace(filename, context, -1);
+      if (stats != NULL) {
+        endFileStats(stats, context, status, true);
       }
-      attributes->isExternal = true;
-      label = initLabel(params, 0, attributes);
-      addNewLabel(labels, label);
-    } else if (strcmp(cmd, ".entry") == 0) {
-      markLabelAsEntry(labels, params);
+      return status;
     }
-    numOfLines++;
-    freeLinePart(lineParts);
   }
 
-  /* add each data label ICF */
-  updateDataLabels(labels, *IC);
-  free(attributes);
-  free(errorMsg);
-}
-
-/* Pass 2 - encoded each command in the linked list.
- *
- * Params:
- * Command **commands: linked list of commands.
- * Label *label: array of labels.
-*/
-void pass2(Command **commands, Label *labels) {
-  Command *head = *commands;
+  if (content != NULL) {
+    applyOptions(options, context);
+    status = assembleSource(context, content, length);
+  } else {
+    status = assembleStream(fptr, options, context);
+  }
+  if (options->check == true) {
+    printFileErrors(filename, &context->errors);
+  } else if (status == assembled) {
+    reportPhase(context, save_phase, true);
+    saveOutputs(filename, &context->outputs, options->watch);
+    reportPhase(context, save_phase, false);
+  } else {
+    printErrorStruct(&context->errors);
+  }
+  /* The entries of file with errors are published too, the other files may use them. */
+  if (options->batch == true) {
+    publishFileSymbols(globalIndex, filename, &context->labels, status == assembled ? false : true);
+  }
 
-  while (head != NULL) {
-    if (head->type == r_cmd) {
-      encodeRCmd(head);
-    } else if (head->type == i_cmd) {
-      encodeICmd(head, labels);
-    } else if (head->type == j_cmd) {
-      encodeJCmd(head, labels);
-    }
-    head = head->next;
+  if (options->cacheDir != NULL) {
+    storeCacheEntry(options, key, status, &context->outputs, context->errors, &context->labels);
   }
-}
 
-/* Update the addresses of data picture by adding ICF.
- *
- * Params:
- * DataItem **dataPicture: pointer to data picture linked list.
- * unsigned long ICF: value of the last address in command picture.
-*/
-void updateDataPictureAddress(DataItem **dataPicture, unsigned long ICF) {
-  DataItem *head = *dataPicture;
-  while (head != NULL) {
-    head->address += ICF;
-    head = head->next;
+  endFileTrace(filename, context, content != NULL ? (long) length : ftell(fptr));
+  if (stats != NULL) {
+    endFileStats(stats, context, status, false);
   }
+  resetAssemblerContext(context);
+  return status;
 }
 
-/* Read line by line from file, and if it is commandLine / orderLine validate the content.
+/* Read the whole source from stream and assemble it in memory, nothing is written to the disk.
+ * With --pipeline, the stream is read and cut into lines by other threads while pass 1 runs.
+ * The outputs and the errors are left in the context until it is reset.
  *
  * Params:
- * FILE *stream: pointer to file, the file is already open.
- * Error **error: pointer to errors table.
- * Label **label: pointer to labels table.
- * int numOfLabels: labels table length.
- * int *numOfErrors: pointer to errors table length.
+ * FILE *fptr: pointer to the source (already open).
+ * Options *options: the options of the assembler.
+ * AssemblerContext *context: the context of the assembler.
+ *
+ * Returns:
+ * AssemblerStatus status: the status of assembleSource (source_errors if the source cannot be read).
 */
-void validateFile(FILE *stream, Error **errors, Label *labels, int *numOfErrors) {
-  int numOfLines = 0;
-  int read;
-  ErrorType errorType;
-  Error *error;
-  char *line = (char *) calloc(MAX_LINE_LENGTH + 1, sizeof(char));
-
-  if (line == NULL) {
-    printf("allocation Error! \n");
-    return;
+AssemblerStatus assembleStream(FILE *fptr, Options *options, AssemblerContext *context) {
+  AssemblerStatus status;
+  unsigned long length;
+  char *content;
+
+  applyOptions(options, context);
+  if (options->pipeline == true && pipelineStream(fptr, context, &status) == true) {
+    return status;
   }
-  fseek(stream, 0, SEEK_SET);
 
-  while ((read = getLine(stream, line, MAX_LINE_LENGTH + 1)) != -1) {
-    if (read > MAX_LINE_LENGTH) {
-      numOfLines++;
-      read = getLine(stream, line, MAX_LINE_LENGTH + 1);
-      continue;
-    }
-    numOfLines++;
-    errorType = checkLine(line, labels);
-    if (errorType != valid) {
-      error = initNewError(getMessageErrorType(errorType), numOfLines);
-      addNewError(errors, error);
-      (*numOfErrors)++;
-    }
+  reportPhase(context, read_phase, true);
+  content = readStreamContent(fptr, &length);
+  reportPhase(context, read_phase, false);
+  if (content == NULL) {
+    resetAssemblerContext(context);
+    return source_errors;
   }
-  free(line);
+  status = assembleSource(context, content, length);
+  free(content);
+  return status;
 }
 
-
-/* Free all command nodes from commands linked list.
+/* Set the outputs that the context builds by the options.
  *
  * Params:
- * Command **commands: pointer to commands linked list.
+ * Options *options: the options of the assembler.
+ * AssemblerContext *context: the context of the assembler.
 */
-void freeCommands(Command **commands) {
-  Command *currentCommand;
-
-  if (commands == NULL) {
-    return;
-  }
-
-  while (*commands) {
-    currentCommand = *commands;
-    *commands = (*commands)->next;
-    free(currentCommand->bits);
-    free(currentCommand->line);
-    free(currentCommand);
-  }
+void applyOptions(Options *options, AssemblerContext *context) {
+  context->sym = options->sym;
+  context->report = options->report;
+  context->listing = options->listing;
+  context->debug = options->debug;
+  context->check = options->check;
 }
 
-/* Free all errors nodes from errors linked list.
+/*
+ * Prints all the errors to the stderr file.
  *
  * Params:
- * Error **errors: pointer to errors linked list.
-*/
-void freeErrors(Error **errors) {
-  Error *currentError;
-
-  if (errors == NULL) {
-    return;
-  }
-
-  while (*errors) {
-    currentError = *errors;
-    *errors = (*errors)->next;
-    free(currentError->message);
-    free(currentError);
+ * Error **error: pointer to error's linked list.
+ */
+void printErrorStruct(Error **errors) {
+  Error *lastError = *errors;
+  while (lastError != NULL) {
+    fprintf(stderr, "Error! in line: %d: %s \n", lastError->lineNumber, lastError->message);
+    lastError = lastError->next;
   }
 }
 
-/* Free all data items nodes from data picture linked list.
+/*
+ * Prints all the errors of file to the stderr file, every one as file:line: message.
  *
  * Params:
- * DataItem **dataPicture: pointer to data picture linked list.
-*/
-void freeDataPicture(DataItem **dataPicture) {
-  DataItem *currentDataItem;
-
-  if (dataPicture == NULL) {
-    return;
-  }
-
-  while (*dataPicture) {
-    currentDataItem = *dataPicture;
-    *dataPicture = (*dataPicture)->next;
-    free(currentDataItem);
+ * char *filename: the name of the file.
+ * Error **error: pointer to error's linked list.
+ */
+void printFileErrors(char *filename, Error **errors) {
+  Error *lastError = *errors;
+  while (lastError != NULL) {
+    fprintf(stderr, "%s:%d: %s \n", filename, lastError->lineNumber, lastError->message);
+    lastError = lastError->next;
   }
 }
 
-/* Free all labels nodes from labels linked list.
+/* Allocate memory to string.
  *
  * Params:
- * Label **labels: pointer to labels linked list.
+ * char *str: pointer to the string for allocating it memory.
+ * int length: number of char to allocate.
+ *
+ * Returns:
+ * char *str: pointer to the allocated memory.
 */
-void freeLabels(Label **labels) {
-  Label *currentLabel;
-
-  if (labels == NULL) {
-    return;
-  }
-
-  while (*labels) {
-    currentLabel = *labels;
-    *labels = (*labels)->next;
-    free(currentLabel->appearances);
-    free(currentLabel->symbol);
-    free(currentLabel);
+char *allocateMemory(size_t length) {
+  char *str = (char *) calloc(length + 1, sizeof(char));
+  if (str == NULL) {
+    printf("Error: Allocation error!");
+    return NULL;
   }
+  return str;
 }
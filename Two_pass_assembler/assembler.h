@@ -0,0 +1,19 @@
+#ifndef MAMAN14_ASSEMBLER_H
+#define MAMAN14_ASSEMBLER_H
+
+#include "Datatypes.h"
+#include "libassembler.h"
+#include "options.h"
+#include "globalIndex.h"
+#include "stats.h"
+
+AssemblerStatus assembleFile(char *filename, FILE *fptr, const char *content, unsigned long length, Options *options,
+                             GlobalIndex *globalIndex, AssemblerContext *context, Stats *stats);
+
+AssemblerStatus assembleStream(FILE *fptr, Options *options, AssemblerContext *context);
+
+void printErrorStruct(Error **errors);
+
+void printFileErrors(char *filename, Error **errors);
+
+#endif
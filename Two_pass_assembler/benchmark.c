@@ -0,0 +1,371 @@
+#define _DEFAULT_SOURCE
+
+#include <math.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "generator.h"
+#include "diskFiles.h"
+
+#define NUM_OF_SIZES 4
+#define DEFAULT_RUNS 3
+#define DEFAULT_LIMIT 1.15
+/* The smaller sizes are only printed - the start of the process is most of their time. */
+#define DEFAULT_FIT_LINES 10000
+
+/* Data structure representing the result of one size. */
+typedef struct benchResult {
+    unsigned long lines;
+    unsigned long bytes;
+    double time;
+    long peakMemory;
+} BenchResult;
+
+Boolean runAssembler(char *assembler, char *path, double *time, long *peakMemory);
+
+int benchMix(char *assembler, char *dir, char *name, GeneratorMix *mix, unsigned long seed, int runs,
+             unsigned long maxLines, unsigned long fitLines, double limit, BenchResult *empty);
+
+Boolean benchSize(char *assembler, char *dir, char *name, GeneratorMix *mix, unsigned long seed, int runs,
+                  BenchResult *result);
+
+Boolean benchEmpty(char *assembler, char *dir, int runs, BenchResult *empty);
+
+double fitExponent(BenchResult *results, int length, BenchResult *empty, Boolean memory);
+
+int compareTimes(const void *first, const void *second);
+
+/*
+ * End-to-end scaling benchmark: generate sources of 1k to 1M lines, assemble each of them by the
+ * assembler (the median of some runs), and fit the growth of the time and of the memory to n^k.
+ * The time and the memory of assembling empty source (the start of the process) are subtracted
+ * first, and only the sizes from --fit-lines are fitted. It is done for the default mix (mostly
+ * instructions, valid) and for mix of mostly data lines with errors in 10% of the lines, so the
+ * lists of the data and of the errors are long too.
+ * It fails when k is over the limit - when the assembler becomes superlinear.
+ *
+ * Usage: benchmark [--assembler=PATH] [--dir=DIR] [--seed=N] [--runs=N] [--max-lines=N] [--fit-lines=N]
+ *                  [--limit=K]
+ */
+int main(int args, char *argv[]) {
+  char *assembler = "./assembler";
+  char *dir = "bench";
+  unsigned long seed = 1;
+  unsigned long maxLines = 1000000;
+  unsigned long fitLines = DEFAULT_FIT_LINES;
+  int runs = DEFAULT_RUNS;
+  double limit = DEFAULT_LIMIT;
+  GeneratorMix mix, dataErrorsMix;
+  BenchResult empty;
+  int failures = 0, status;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--assembler=", 12) == 0) {
+      assembler = argv[i] + 12;
+    } else if (strncmp(argv[i], "--dir=", 6) == 0) {
+      dir = argv[i] + 6;
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0 && atoi(argv[i] + 7) > 0) {
+      runs = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--max-lines=", 12) == 0) {
+      maxLines = strtoul(argv[i] + 12, NULL, 10);
+    } else if (strncmp(argv[i], "--fit-lines=", 12) == 0) {
+      fitLines = strtoul(argv[i] + 12, NULL, 10);
+    } else if (strncmp(argv[i], "--limit=", 8) == 0 && atof(argv[i] + 8) > 0) {
+      limit = atof(argv[i] + 8);
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+  mkdir(dir, 0755);
+  initGeneratorMix(&mix);
+  initDataErrorsMix(&dataErrorsMix);
+
+  printf("%10s %12s %12s %14s %12s\n", "lines", "bytes", "time (ms)", "ns per line", "memory (KB)");
+  if (benchEmpty(assembler, dir, runs, &empty) == false) {
+    exit(1);
+  }
+  printf("%10s %12d %12.3f %14s %12ld\n", "empty", 0, empty.time * 1000, "-", empty.peakMemory);
+
+  status = benchMix(assembler, dir, "default", &mix, seed, runs, maxLines, fitLines, limit, &empty);
+  if (status >= 0) {
+    failures += status;
+    status = benchMix(assembler, dir, "data-errors", &dataErrorsMix, seed, runs, maxLines, fitLines, limit, &empty);
+  }
+  if (status < 0) {
+    exit(1);
+  }
+  failures += status;
+  return failures > 0 ? 1 : 0;
+}
+
+/* Assemble the sources of one mix from 1k lines up to maxLines, and fit the growth of their time and memory.
+ *
+ * Params:
+ * char *assembler: the path of the assembler.
+ * char *dir: the directory of the generated sources (and their outputs).
+ * char *name: the name of the mix, for the names of the sources and for the output.
+ * GeneratorMix *mix: the mix, the sources are valid unless it has errors.
+ * unsigned long seed: the seed of the generator.
+ * int runs: the number of runs, the median time is taken.
+ * unsigned long maxLines: the largest size.
+ * unsigned long fitLines: the smallest size that is fitted.
+ * double limit: the largest k that is not superlinear.
+ * BenchResult *empty: the result of the empty run.
+ *
+ * Returns:
+ * int status: 0 if the growth is within the limit, 1 if it is superlinear, -1 if the benchmark failed.
+*/
+int benchMix(char *assembler, char *dir, char *name, GeneratorMix *mix, unsigned long seed, int runs,
+             unsigned long maxLines, unsigned long fitLines, double limit, BenchResult *empty) {
+  BenchResult results[NUM_OF_SIZES];
+  double timeExponent, memoryExponent;
+  unsigned long lines;
+  int length = 0, first = -1;
+
+  printf("%s mix:\n", name);
+  for (lines = 1000; lines <= maxLines && length < NUM_OF_SIZES; lines *= 10) {
+    results[length].lines = lines;
+    if (benchSize(assembler, dir, name, mix, seed, runs, &results[length]) == false) {
+      return -1;
+    }
+    printf("%10lu %12lu %12.3f %14.1f %12ld\n", results[length].lines, results[length].bytes,
+           results[length].time * 1000, results[length].time * 1e9 / lines, results[length].peakMemory);
+    fflush(stdout);
+    if (first == -1 && lines >= fitLines) {
+      first = length;
+    }
+    length++;
+  }
+  if (first == -1 || length - first < 2) {
+    printf("At least two sizes from %lu lines are needed to fit the growth \n", fitLines);
+    return 0;
+  }
+
+  timeExponent = fitExponent(results + first, length - first, empty, false);
+  memoryExponent = fitExponent(results + first, length - first, empty, true);
+  printf("%s mix from %lu lines, without the empty run: time grows like n^%.2f, memory grows like n^%.2f "
+         "(the limit is n^%.2f)\n", name, results[first].lines, timeExponent, memoryExponent, limit);
+  if (timeExponent > limit || memoryExponent > limit) {
+    printf("Error! the assembler grows superlinearly on the %s mix. \n", name);
+    return 1;
+  }
+  return 0;
+}
+
+/* Generate the source of one size, and assemble it some times.
+ *
+ * Params:
+ * char *assembler: the path of the assembler.
+ * char *dir: the directory of the generated sources (and their outputs).
+ * char *name: the name of the mix.
+ * GeneratorMix *mix: the mix, the source is valid unless it has errors.
+ * unsigned long seed: the seed of the generator.
+ * int runs: the number of runs, the median time is taken.
+ * BenchResult *result: the result, with the number of lines already set.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean benchSize(char *assembler, char *dir, char *name, GeneratorMix *mix, unsigned long seed, int runs,
+                  BenchResult *result) {
+  Buffer source;
+  char path[MAX_FORMAT_LENGTH];
+  double *times = (double *) calloc(runs, sizeof(double));
+  FILE *fptr;
+  int i;
+
+  initBuffer(&source);
+  sprintf(path, "%.200s/bench_%.40s_%lu.as", dir, name, result->lines);
+  if (times == NULL || generateSource(&source, seed, result->lines, mix) == false) {
+    printf("Error: Allocation Error! \n");
+    free(times);
+    return false;
+  }
+  fptr = fopen(path, "w");
+  if (fptr == NULL) {
+    printf("Cannot create file %s \n", path);
+    freeBuffer(&source);
+    free(times);
+    return false;
+  }
+  fwrite(source.data, 1, source.length, fptr);
+  fclose(fptr);
+  result->bytes = source.length;
+  freeBuffer(&source);
+
+  result->peakMemory = 0;
+  for (i = 0; i < runs; i++) {
+    if (runAssembler(assembler, path, &times[i], &result->peakMemory) == false) {
+      printf("The assembler failed on %s \n", path);
+      free(times);
+      return false;
+    }
+  }
+  qsort(times, runs, sizeof(double), compareTimes);
+  result->time = times[runs / 2];
+  free(times);
+
+  /* The generated source must be valid, or have errors if the mix has - the assembler creates the object
+   * file only for valid source. */
+  sprintf(path, "%.200s/bench_%.40s_%lu.ob", dir, name, result->lines);
+  fptr = fopen(path, "r");
+  if (fptr != NULL) {
+    fclose(fptr);
+  }
+  if (mix->errorsPercent == 0 && fptr == NULL) {
+    printf("The assembler found errors in the generated source of %lu lines \n", result->lines);
+    return false;
+  }
+  if (mix->errorsPercent > 0 && fptr != NULL) {
+    printf("The assembler found no errors in the generated source of %lu lines \n", result->lines);
+    return false;
+  }
+  return true;
+}
+
+/* Assemble empty source some times - the cost of starting the assembler, that does not grow with the source.
+ *
+ * Params:
+ * char *assembler: the path of the assembler.
+ * char *dir: the directory of the generated sources.
+ * int runs: the number of runs, the median time is taken.
+ * BenchResult *empty: the result.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean benchEmpty(char *assembler, char *dir, int runs, BenchResult *empty) {
+  char path[MAX_FORMAT_LENGTH];
+  double *times = (double *) calloc(runs, sizeof(double));
+  FILE *fptr;
+  int i;
+
+  sprintf(path, "%.200s/bench_empty.as", dir);
+  fptr = times != NULL ? fopen(path, "w") : NULL;
+  if (fptr == NULL) {
+    printf("Cannot create file %s \n", path);
+    free(times);
+    return false;
+  }
+  fclose(fptr);
+
+  empty->lines = 0;
+  empty->bytes = 0;
+  empty->peakMemory = 0;
+  for (i = 0; i < runs; i++) {
+    if (runAssembler(assembler, path, &times[i], &empty->peakMemory) == false) {
+      printf("The assembler failed on %s \n", path);
+      free(times);
+      return false;
+    }
+  }
+  qsort(times, runs, sizeof(double), compareTimes);
+  empty->time = times[runs / 2];
+  free(times);
+  return true;
+}
+
+/* Run the assembler on one file, in its own process.
+ *
+ * Params:
+ * char *assembler: the path of the assembler.
+ * char *path: the path of the source.
+ * double *time: pointer to store the wall time in seconds.
+ * long *peakMemory: pointer to the peak memory in KB, it is raised to the peak of this run.
+ *
+ * Returns:
+ * Boolean status: true if the assembler assembled the file, otherwise - false.
+*/
+Boolean runAssembler(char *assembler, char *path, double *time, long *peakMemory) {
+  struct timespec begin, end;
+  struct rusage usage;
+  int status, output;
+  pid_t child;
+
+  clock_gettime(CLOCK_MONOTONIC, &begin);
+  child = fork();
+  if (child < 0) {
+    return false;
+  }
+  if (child == 0) {
+    output = open("/dev/null", O_WRONLY);
+    if (output >= 0) {
+      dup2(output, 1);
+      dup2(output, 2);
+    }
+    execl(assembler, assembler, path, (char *) NULL);
+    _exit(127);
+  }
+  if (wait4(child, &status, 0, &usage) < 0) {
+    return false;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  *time = (double) (end.tv_sec - begin.tv_sec) + (double) (end.tv_nsec - begin.tv_nsec) / 1e9;
+  if (usage.ru_maxrss > *peakMemory) {
+    *peakMemory = usage.ru_maxrss;
+  }
+  if (WIFEXITED(status) == 0 || WEXITSTATUS(status) != 0) {
+    return false;
+  }
+  return true;
+}
+
+/* Fit the results, without the cost of the empty run, to c * n^k by least squares on the logarithms, and get k.
+ *
+ * Params:
+ * BenchResult *results: the results, at least two.
+ * int length: the number of the results.
+ * BenchResult *empty: the result of the empty run.
+ * Boolean memory: true to fit the memory, false to fit the time.
+ *
+ * Returns:
+ * double exponent: k.
+*/
+double fitExponent(BenchResult *results, int length, BenchResult *empty, Boolean memory) {
+  double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+  double x, y;
+  int i;
+
+  for (i = 0; i < length; i++) {
+    x = log((double) results[i].lines);
+    if (memory == true) {
+      y = (double) (results[i].peakMemory - empty->peakMemory);
+    } else {
+      y = results[i].time - empty->time;
+    }
+    /* Size that is not larger than the empty run (within the noise) counts as the smallest step. */
+    y = log(y > 0 ? y : (memory == true ? 1.0 : 1e-6));
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+  return (length * sumXY - sumX * sumY) / (length * sumXX - sumX * sumX);
+}
+
+/* Compare two times, for sorting.
+ *
+ * Params:
+ * const void *first: pointer to the first time.
+ * const void *second: pointer to the second time.
+ *
+ * Returns:
+ * int result: negative, zero or positive like the order of the times.
+*/
+int compareTimes(const void *first, const void *second) {
+  double difference = *(double *) first - *(double *) second;
+
+  if (difference < 0) {
+    return -1;
+  }
+  return difference > 0 ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+#include <stdarg.h>
+#include "buffer.h"
+
+/* Initialize empty buffer.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+*/
+void initBuffer(Buffer *buffer) {
+  buffer->data = NULL;
+  buffer->length = 0;
+  buffer->capacity = 0;
+  buffer->attached = false;
+  buffer->overflow = false;
+}
+
+/* Make the buffer use memory of the caller instead of its own, the buffer never grows beyond it.
+ * Adding more bytes than the memory can hold fails and marks the buffer as overflowed.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * char *data: the memory of the caller.
+ * unsigned long capacity: the size of the memory, including room for '\0' after the content.
+*/
+void attachBuffer(Buffer *buffer, char *data, unsigned long capacity) {
+  freeBuffer(buffer);
+  buffer->data = data;
+  buffer->capacity = capacity;
+  buffer->attached = true;
+}
+
+/* Empty the buffer but keep its memory for the next use.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+*/
+void resetBuffer(Buffer *buffer) {
+  buffer->length = 0;
+  buffer->overflow = false;
+}
+
+/* Free the memory of the buffer (unless it is memory of the caller), and leave it empty.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+*/
+void freeBuffer(Buffer *buffer) {
+  if (buffer->attached == false) {
+    free(buffer->data);
+  }
+  initBuffer(buffer);
+}
+
+/* Make sure there is room for more bytes in the buffer (and for '\0' after them).
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * unsigned long length: number of bytes that will be added.
+ *
+ * Returns:
+ * Boolean status: true if there is room, otherwise (allocation error) - false.
+*/
+Boolean reserveBuffer(Buffer *buffer, unsigned long length) {
+  unsigned long capacity = buffer->capacity == 0 ? 1024 : buffer->capacity;
+  char *data;
+
+  if (buffer->length + length < buffer->capacity) {
+    return true;
+  }
+  if (buffer->attached == true) {
+    buffer->overflow = true;
+    return false;
+  }
+
+  while (buffer->length + length >= capacity) {
+    capacity *= 2;
+  }
+  data = (char *) realloc(buffer->data, capacity);
+  if (data == NULL) {
+    buffer->overflow = true;
+    return false;
+  }
+  buffer->data = data;
+  buffer->capacity = capacity;
+  return true;
+}
+
+/* Add bytes to the end of the buffer.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * const char *data: the bytes to add.
+ * unsigned long length: number of bytes.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean appendBuffer(Buffer *buffer, const char *data, unsigned long length) {
+  if (reserveBuffer(buffer, length) == false) {
+    return false;
+  }
+  memcpy(buffer->data + buffer->length, data, length);
+  buffer->length += length;
+  buffer->data[buffer->length] = '\0';
+  return true;
+}
+
+/* Format text like printf and add it to the end of the buffer.
+ * The formatted text must be shorter than MAX_FORMAT_LENGTH.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * const char *format: the format string.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean bufferPrintf(Buffer *buffer, const char *format, ...) {
+  char text[MAX_FORMAT_LENGTH];
+  va_list args;
+  int length;
+
+  /* Formatted first aside, so memory of the caller is not overflowed by the room for the longest text. */
+  va_start(args, format);
+  length = vsprintf(text, format, args);
+  va_end(args);
+  if (length <= 0) {
+    return true;
+  }
+  return appendBuffer(buffer, text, (unsigned long) length);
+}
+
+/* Add 32 bits unsigned field to the end of the buffer, in little endian.
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * unsigned long value: the value of the field.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean appendField(Buffer *buffer, unsigned long value) {
+  char field[4];
+  field[0] = (char) (value & 0xFF);
+  field[1] = (char) ((value >> 8) & 0xFF);
+  field[2] = (char) ((value >> 16) & 0xFF);
+  field[3] = (char) ((value >> 24) & 0xFF);
+  return appendBuffer(buffer, field, 4);
+}
+
+/* Write 32 bits unsigned field in little endian over field that was already added to the buffer
+ * (for fields whose value is known only after the content that follows them).
+ *
+ * Params:
+ * Buffer *buffer: pointer to the buffer.
+ * unsigned long offset: the offset of the field in bytes.
+ * unsigned long value: the value of the field.
+ *
+ * Returns:
+ * Boolean status: true if the field is in the buffer, otherwise - false.
+*/
+Boolean writeField(Buffer *buffer, unsigned long offset, unsigned long value) {
+  if (offset + 4 > buffer->length) {
+    return false;
+  }
+  buffer->data[offset] = (char) (value & 0xFF);
+  buffer->data[offset + 1] = (char) ((value >> 8) & 0xFF);
+  buffer->data[offset + 2] = (char) ((value >> 16) & 0xFF);
+  buffer->data[offset + 3] = (char) ((value >> 24) & 0xFF);
+  return true;
+}
+
+/* Read 32 bits unsigned field that is stored in little endian.
+ *
+ * Params:
+ * const unsigned char *data: the bytes.
+ * unsigned long offset: the offset of the field in bytes.
+ *
+ * Returns:
+ * unsigned long value: the value of the field.
+*/
+unsigned long readField(const unsigned char *data, unsigned long offset) {
+  return (unsigned long) data[offset] |
+         ((unsigned long) data[offset + 1] << 8) |
+         ((unsigned long) data[offset + 2] << 16) |
+         ((unsigned long) data[offset + 3] << 24);
+}
@@ -0,0 +1,38 @@
+#ifndef MAMAN14_BUFFER_H
+#define MAMAN14_BUFFER_H
+
+#include "Datatypes.h"
+
+/* The longest text that bufferPrintf can format at once. */
+#define MAX_FORMAT_LENGTH 256
+
+/* Data structure representing growing buffer of bytes in memory. */
+typedef struct buffer {
+    char *data;
+    unsigned long length;
+    unsigned long capacity;
+    Boolean attached;
+    Boolean overflow;
+} Buffer;
+
+void initBuffer(Buffer *buffer);
+
+void attachBuffer(Buffer *buffer, char *data, unsigned long capacity);
+
+void resetBuffer(Buffer *buffer);
+
+void freeBuffer(Buffer *buffer);
+
+Boolean reserveBuffer(Buffer *buffer, unsigned long length);
+
+Boolean appendBuffer(Buffer *buffer, const char *data, unsigned long length);
+
+Boolean bufferPrintf(Buffer *buffer, const char *format, ...);
+
+Boolean appendField(Buffer *buffer, unsigned long value);
+
+Boolean writeField(Buffer *buffer, unsigned long offset, unsigned long value);
+
+unsigned long readField(const unsigned char *data, unsigned long offset);
+
+#endif
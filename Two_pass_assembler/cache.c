@@ -0,0 +1,481 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <utime.h>
+#include "cache.h"
+#include "files.h"
+#include "diskFiles.h"
+
+/* Data structure representing file of cache entry, for eviction. */
+typedef struct cacheFile {
+    char *path;
+    unsigned long size;
+    time_t lastUse;
+} CacheFile;
+
+char *getCacheEntryPath(Options *options, char *key, char *suffix);
+
+void writeCacheSection(FILE *fp, char *name, char *content, unsigned long length);
+
+char *formatSymbols(LabelTable *labels, unsigned long *length);
+
+void publishCachedSymbols(GlobalIndex *globalIndex, char *filename, char *symbols, unsigned long length,
+                          Boolean failed);
+
+int compareCacheFiles(const void *first, const void *second);
+
+void hashCacheBytes(const unsigned char *bytes, unsigned long length, unsigned long *fnv, unsigned long *sdbm);
+
+void finishCacheKey(unsigned long fnv, unsigned long sdbm, Options *options, char *key);
+
+/* Compute the key of cache entry from the source, the version of the assembler and the options
+ * that change the outputs. The stream is returned to its start.
+ *
+ * Params:
+ * FILE *stream: the source file (already open).
+ * Options *options: the options of the assembler.
+ * char *key: buffer of CACHE_KEY_LENGTH + 1 chars for the key.
+*/
+void computeCacheKey(FILE *stream, Options *options, char *key) {
+  unsigned long fnv = 2166136261UL, sdbm = 0;
+  unsigned char buffer[4096];
+  size_t read;
+
+  while ((read = fread(buffer, 1, sizeof(buffer), stream)) > 0) {
+    hashCacheBytes(buffer, read, &fnv, &sdbm);
+  }
+  finishCacheKey(fnv, sdbm, options, key);
+  clearerr(stream);
+  fseek(stream, 0, SEEK_SET);
+}
+
+/* Compute the key of cache entry from source that is already in memory, the same key as computeCacheKey.
+ *
+ * Params:
+ * const char *content: the source.
+ * unsigned long length: the length of the source.
+ * Options *options: the options of the assembler.
+ * char *key: buffer of CACHE_KEY_LENGTH + 1 chars for the key.
+*/
+void computeContentCacheKey(const char *content, unsigned long length, Options *options, char *key) {
+  unsigned long fnv = 2166136261UL, sdbm = 0;
+
+  hashCacheBytes((const unsigned char *) content, length, &fnv, &sdbm);
+  finishCacheKey(fnv, sdbm, options, key);
+}
+
+/* Add bytes to the two hashes of the key - two independent 32 bits hashes give 64 bits key on every platform.
+ *
+ * Params:
+ * const unsigned char *bytes: the bytes.
+ * unsigned long length: the number of bytes.
+ * unsigned long *fnv: the FNV-1a hash.
+ * unsigned long *sdbm: the sdbm hash.
+*/
+void hashCacheBytes(const unsigned char *bytes, unsigned long length, unsigned long *fnv, unsigned long *sdbm) {
+  unsigned long i;
+
+  for (i = 0; i < length; i++) {
+    *fnv = ((*fnv ^ bytes[i]) * 16777619UL) & 0xFFFFFFFFUL;
+    *sdbm = (bytes[i] + (*sdbm << 6) + (*sdbm << 16) - *sdbm) & 0xFFFFFFFFUL;
+  }
+}
+
+/* Add the version of the assembler and the options that change the outputs to the hashes, and write the key.
+ *
+ * Params:
+ * unsigned long fnv: the FNV-1a hash of the source.
+ * unsigned long sdbm: the sdbm hash of the source.
+ * Options *options: the options of the assembler.
+ * char *key: buffer of CACHE_KEY_LENGTH + 1 chars for the key.
+*/
+void finishCacheKey(unsigned long fnv, unsigned long sdbm, Options *options, char *key) {
+  char *version = ASSEMBLER_VERSION;
+
+  hashCacheBytes((const unsigned char *) version, strlen(version), &fnv, &sdbm);
+  if (options->sym == true) {
+    fnv = ((fnv ^ 's') * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  if (options->report == true) {
+    fnv = ((fnv ^ 'r') * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  if (options->listing == true) {
+    fnv = ((fnv ^ 'l') * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  if (options->debug == true) {
+    fnv = ((fnv ^ 'd') * 16777619UL) & 0xFFFFFFFFUL;
+  }
+
+  sprintf(key, "%08lx%08lx", fnv, sdbm);
+}
+
+/* Get the path of file in the cache directory.
+ *
+ * Params:
+ * Options *options: the options of the assembler.
+ * char *key: the key of the entry.
+ * char *suffix: the end of the file name.
+ *
+ * Returns:
+ * char *path: the path of the file (dynamic memory).
+*/
+char *getCacheEntryPath(Options *options, char *key, char *suffix) {
+  char *path = (char *) calloc(strlen(options->cacheDir) + strlen(key) + strlen(suffix) + 2, sizeof(char));
+  if (path == NULL) {
+    printf("Error: Allocation Error! \n");
+    return NULL;
+  }
+  sprintf(path, "%s/%s%s", options->cacheDir, key, suffix);
+  return path;
+}
+
+/* Write one section (header line and content) into cache entry.
+ *
+ * Params:
+ * FILE *fp: the cache entry file.
+ * char *name: the name of the section.
+ * char *content: the content of the section.
+ * unsigned long length: the length of the content.
+*/
+void writeCacheSection(FILE *fp, char *name, char *content, unsigned long length) {
+  fprintf(fp, "%s %lu\n", name, length);
+  fwrite(content, 1, length, fp);
+}
+
+/* Format the entries and the externals of labels table, line for each one: "<E|X> <value> <name>".
+ *
+ * Params:
+ * LabelTable *labels: the labels table.
+ * unsigned long *length: pointer to store the length of the text.
+ *
+ * Returns:
+ * char *text: the formatted symbols (dynamic memory).
+*/
+char *formatSymbols(LabelTable *labels, unsigned long *length) {
+  unsigned long capacity = 1;
+  SymbolId id;
+  char *text;
+
+  for (id = 0; id < labels->length; id++) {
+    capacity += strlen(getLabelName(labels, id)) + 24;
+  }
+  text = (char *) calloc(capacity, sizeof(char));
+  if (text == NULL) {
+    printf("Error: Allocation Error! \n");
+    *length = 0;
+    return NULL;
+  }
+
+  *length = 0;
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_ENTRY) {
+      *length += sprintf(text + *length, "E %lu %s\n", labels->items[id].value, getLabelName(labels, id));
+    } else if (labels->items[id].attr & ATTR_EXTERNAL) {
+      *length += sprintf(text + *length, "X %lu %s\n", labels->items[id].value, getLabelName(labels, id));
+    }
+  }
+  return text;
+}
+
+/* Store the result of assembling the file in the cache. The entry is written to temporary file
+ * and renamed, so other assemblers that use the same cache never see partial entry.
+ *
+ * Params:
+ * Options *options: the options of the assembler.
+ * char *key: the key of the entry.
+ * AssemblerStatus status: the status of assembling the file.
+ * Outputs *outputs: the contents of the output files.
+ * Error *errors: the errors of the file.
+ * LabelTable *labels: the labels table of the file.
+*/
+void storeCacheEntry(Options *options, char *key, AssemblerStatus status, Outputs *outputs, Error *errors,
+                     LabelTable *labels) {
+  char suffix[40];
+  char *path, *tempPath, *text;
+  unsigned long length;
+  FILE *fp;
+
+  sprintf(suffix, ".%ld.tmp", (long) getpid());
+  path = getCacheEntryPath(options, key, ".cache");
+  tempPath = getCacheEntryPath(options, key, suffix);
+  if (path == NULL || tempPath == NULL) {
+    free(path);
+    free(tempPath);
+    return;
+  }
+
+  mkdir(options->cacheDir, 0777);
+  fp = fopen(tempPath, "wb");
+  if (fp == NULL) {
+    free(path);
+    free(tempPath);
+    return;
+  }
+
+  fprintf(fp, "ASCACHE %s %d\n", ASSEMBLER_VERSION, (int) status);
+  if (status == assembled) {
+    writeCacheSection(fp, "ob", outputs->object.data, outputs->object.length);
+    if (outputs->hasEntries == true) {
+      writeCacheSection(fp, "ent", outputs->entries.data, outputs->entries.length);
+    }
+    if (outputs->hasExternals == true) {
+      writeCacheSection(fp, "ext", outputs->externals.data, outputs->externals.length);
+    }
+    if (outputs->hasSymbols == true) {
+      writeCacheSection(fp, "sym", outputs->symbols.data, outputs->symbols.length);
+    }
+    if (outputs->hasReport == true) {
+      writeCacheSection(fp, "json", outputs->report.data, outputs->report.length);
+    }
+    if (outputs->hasListing == true) {
+      writeCacheSection(fp, "lst", outputs->listing.data, outputs->listing.length);
+    }
+    if (outputs->hasDebug == true) {
+      writeCacheSection(fp, "dbg", outputs->debug.data, outputs->debug.length);
+    }
+  }
+  /* The symbols of file with errors are kept too, its entries are published in batch. */
+  text = formatSymbols(labels, &length);
+  if (text != NULL) {
+    writeCacheSection(fp, "symbols", text, length);
+    free(text);
+  }
+  if (status != assembled) {
+    text = formatErrors(errors, &length);
+    if (text != NULL) {
+      writeCacheSection(fp, "errors", text, length);
+      free(text);
+    }
+  }
+  fprintf(fp, "end 0\n");
+
+  if (fclose(fp) != 0 || rename(tempPath, path) != 0) {
+    remove(tempPath);
+  }
+  free(path);
+  free(tempPath);
+}
+
+/* Publish the cached entries and externals of file into the global index.
+ *
+ * Params:
+ * GlobalIndex *globalIndex: the global index.
+ * char *filename: the name of the input file.
+ * char *symbols: the symbols section of cache entry (NULL if it has none).
+ * unsigned long length: the length of the section.
+ * Boolean failed: true if the file has errors.
+*/
+void publishCachedSymbols(GlobalIndex *globalIndex, char *filename, char *symbols, unsigned long length,
+                          Boolean failed) {
+  char kind, name[MAX_LABEL_LENGTH + 1];
+  unsigned long value;
+  LabelTable labels;
+  char *end = symbols + length;
+  int consumed;
+
+  initLabelTable(&labels);
+  while (symbols != NULL && symbols < end && sscanf(symbols, "%c %lu %31s\n%n", &kind, &value, name, &consumed) == 3) {
+    addNewLabel(&labels, name, value, kind == 'E' ? ATTR_ENTRY : ATTR_EXTERNAL);
+    symbols += consumed;
+  }
+  publishFileSymbols(globalIndex, filename, &labels, failed);
+  freeLabelTable(&labels);
+}
+
+/* Restore the result of assembling file from the cache, if there is an entry for its key.
+ *
+ * Params:
+ * Options *options: the options of the assembler.
+ * char *key: the key of the entry.
+ * char *filename: the name of the input file.
+ * GlobalIndex *globalIndex: the global index (used only in batch mode).
+ * AssemblerStatus *status: pointer to store the status that the file was assembled with.
+ *
+ * Returns:
+ * Boolean status: true if the entry was found and restored, otherwise - false.
+*/
+Boolean restoreCacheEntry(Options *options, char *key, char *filename, GlobalIndex *globalIndex, AssemblerStatus *status) {
+  char *sections[9] = {"ob", "ent", "ext", "sym", "json", "lst", "dbg", "symbols", "errors"};
+  char *content[9] = {NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL};
+  unsigned long lengths[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+  char version[16], name[16];
+  char *path, *entry, *iterator, *end;
+  unsigned long length, sectionLength;
+  int cached, consumed, i;
+  Boolean complete = false;
+  Outputs outputs;
+  Buffer *buffers[7];
+  Boolean *exists[7];
+
+  buffers[0] = &outputs.object;
+  buffers[1] = &outputs.entries;
+  buffers[2] = &outputs.externals;
+  buffers[3] = &outputs.symbols;
+  buffers[4] = &outputs.report;
+  buffers[5] = &outputs.listing;
+  buffers[6] = &outputs.debug;
+  exists[0] = &outputs.hasObject;
+  exists[1] = &outputs.hasEntries;
+  exists[2] = &outputs.hasExternals;
+  exists[3] = &outputs.hasSymbols;
+  exists[4] = &outputs.hasReport;
+  exists[5] = &outputs.hasListing;
+  exists[6] = &outputs.hasDebug;
+
+  path = getCacheEntryPath(options, key, ".cache");
+  if (path == NULL) {
+    return false;
+  }
+  entry = readFileContent(path, &length);
+  if (entry == NULL) {
+    free(path);
+    return false;
+  }
+
+  end = entry + length;
+  if (sscanf(entry, "ASCACHE %15s %d\n%n", version, &cached, &consumed) != 2 ||
+      strcmp(version, ASSEMBLER_VERSION) != 0 || cached < (int) assembled || cached > (int) output_overflow) {
+    free(entry);
+    free(path);
+    return false;
+  }
+
+  /* Split the entry into its sections, the content is not copied. */
+  iterator = entry + consumed;
+  while (iterator < end && sscanf(iterator, "%15s %lu%n", name, &sectionLength, &consumed) == 2) {
+    /* Skip exactly the '\n' of the header - the section itself may start with whitespace. */
+    iterator += consumed;
+    if (iterator >= end || *iterator != '\n') {
+      break;
+    }
+    iterator++;
+    if (strcmp(name, "end") == 0) {
+      complete = true;
+      break;
+    }
+    if (sectionLength > (unsigned long) (end - iterator)) {
+      break;
+    }
+    for (i = 0; i < 9; i++) {
+      if (strcmp(name, sections[i]) == 0) {
+        content[i] = iterator;
+        lengths[i] = sectionLength;
+      }
+    }
+    iterator += sectionLength;
+  }
+
+  if (complete == false || (cached == (int) assembled && content[0] == NULL)) {
+    free(entry);
+    free(path);
+    return false;
+  }
+
+  *status = (AssemblerStatus) cached;
+  if (*status == assembled) {
+    initOutputs(&outputs);
+    for (i = 0; i < 7; i++) {
+      if (content[i] != NULL) {
+        appendBuffer(buffers[i], content[i], lengths[i]);
+        *exists[i] = true;
+      }
+    }
+    saveOutputs(filename, &outputs, options->watch);
+    freeOutputs(&outputs);
+  } else if (content[8] != NULL) {
+    fwrite(content[8], 1, lengths[8], stderr);
+  }
+  if (options->batch == true) {
+    publishCachedSymbols(globalIndex, filename, content[7], lengths[7], *status == assembled ? false : true);
+  }
+
+  /* Mark the entry as recently used. */
+  utime(path, NULL);
+  free(entry);
+  free(path);
+  return true;
+}
+
+/* Compare two cache files by their last use, for sorting the oldest first.
+ *
+ * Params:
+ * const void *first: pointer to the first CacheFile.
+ * const void *second: pointer to the second CacheFile.
+ *
+ * Returns:
+ * int result: negative if first was used before second, positive if after, otherwise - zero.
+*/
+int compareCacheFiles(const void *first, const void *second) {
+  time_t firstUse = ((CacheFile *) first)->lastUse;
+  time_t secondUse = ((CacheFile *) second)->lastUse;
+  if (firstUse < secondUse) {
+    return -1;
+  }
+  return firstUse > secondUse ? 1 : 0;
+}
+
+/* Remove the least recently used entries until the size of the cache is under the limit.
+ * Entries that other assemblers removed meanwhile are ignored.
+ *
+ * Params:
+ * Options *options: the options of the assembler.
+*/
+void evictCache(Options *options) {
+  CacheFile *files = NULL, *bigger;
+  unsigned long total = 0;
+  int length = 0, capacity = 0, i;
+  struct dirent *item;
+  struct stat info;
+  size_t nameLength;
+  char *path;
+  DIR *dir = opendir(options->cacheDir);
+
+  if (dir == NULL) {
+    return;
+  }
+
+  while ((item = readdir(dir)) != NULL) {
+    nameLength = strlen(item->d_name);
+    if (nameLength < 6 || strcmp(item->d_name + nameLength - 6, ".cache") != 0) {
+      continue;
+    }
+    path = (char *) calloc(strlen(options->cacheDir) + nameLength + 2, sizeof(char));
+    if (path == NULL) {
+      break;
+    }
+    sprintf(path, "%s/%s", options->cacheDir, item->d_name);
+    if (stat(path, &info) != 0) {
+      free(path);
+      continue;
+    }
+
+    if (length == capacity) {
+      capacity = capacity == 0 ? 64 : capacity * 2;
+      bigger = (CacheFile *) realloc(files, capacity * sizeof(CacheFile));
+      if (bigger == NULL) {
+        free(path);
+        break;
+      }
+      files = bigger;
+    }
+    files[length].path = path;
+    files[length].size = (unsigned long) info.st_size;
+    files[length].lastUse = info.st_mtime;
+    total += files[length].size;
+    length++;
+  }
+  closedir(dir);
+
+  qsort(files, length, sizeof(CacheFile), compareCacheFiles);
+  for (i = 0; i < length; i++) {
+    if (total > options->cacheSize) {
+      remove(files[i].path);
+      total -= files[i].size;
+    }
+    free(files[i].path);
+  }
+  free(files);
+}
@@ -0,0 +1,25 @@
+#ifndef MAMAN14_CACHE_H
+#define MAMAN14_CACHE_H
+
+#include "Datatypes.h"
+#include "options.h"
+#include "globalIndex.h"
+#include "files.h"
+#include "libassembler.h"
+
+#define CACHE_KEY_LENGTH 16
+#define DEFAULT_CACHE_DIR ".ascache"
+#define DEFAULT_CACHE_SIZE 67108864UL
+
+void computeCacheKey(FILE *stream, Options *options, char *key);
+
+void computeContentCacheKey(const char *content, unsigned long length, Options *options, char *key);
+
+Boolean restoreCacheEntry(Options *options, char *key, char *filename, GlobalIndex *globalIndex, AssemblerStatus *status);
+
+void storeCacheEntry(Options *options, char *key, AssemblerStatus status, Outputs *outputs, Error *errors,
+                     LabelTable *labels);
+
+void evictCache(Options *options);
+
+#endif
@@ -0,0 +1,280 @@
+#define _XOPEN_SOURCE 700
+
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "protocol.h"
+#include "options.h"
+#include "diskFiles.h"
+
+/* Data structure representing the command line options of the client. */
+typedef struct clientOptions {
+    char *socketPath;
+    Boolean sym;
+    Boolean inlineSources;
+} ClientOptions;
+
+Boolean parseClientOptions(int args, char *argv[], ClientOptions *options);
+
+int connectDaemon(char *path);
+
+Boolean sendRequest(int descriptor, char *filename, ClientOptions *options, Buffer *frame);
+
+Boolean receiveResponse(int descriptor, Buffer *frame, Buffer *responses, int numOfFiles);
+
+void applyResponse(char *filename, Response *response);
+
+/*
+ * Thin client of the assembler daemon: send the input files to the daemon that runs on
+ * Unix domain socket, and write the output files and the errors like the assembler itself.
+ *
+ * Usage: asmclient [--socket=PATH] [--sym] [--inline] file.as ...
+ */
+int main(int args, char *argv[]) {
+  ClientOptions options;
+  Buffer frame;
+  Buffer *responses;
+  char **filenames;
+  Response response;
+  int numOfFiles = 0, received = 0, status = 0, descriptor, i;
+
+  if (parseClientOptions(args, argv, &options) == false) {
+    exit(1);
+  }
+
+  filenames = (char **) calloc(args, sizeof(char *));
+  responses = (Buffer *) calloc(args, sizeof(Buffer));
+  if (filenames == NULL || responses == NULL) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+
+  descriptor = connectDaemon(options.socketPath);
+  if (descriptor < 0) {
+    exit(1);
+  }
+  signal(SIGPIPE, SIG_IGN);
+
+  /* Send the requests while the daemon assembles them in parallel, and read responses whenever the daemon
+   * holds as many requests as it reads ahead - else both sides could block on full socket. */
+  initBuffer(&frame);
+  for (i = 1; i < args; i++) {
+    if (isOption(argv[i]) == true) {
+      continue;
+    }
+    if (isAsFile(argv[i]) != 0) {
+      printf("File is not as file");
+      continue;
+    }
+    if (numOfFiles - received == MAX_PENDING_REQUESTS) {
+      if (receiveResponse(descriptor, &frame, responses, numOfFiles) == false) {
+        break;
+      }
+      received++;
+    }
+    if (sendRequest(descriptor, argv[i], &options, &frame) == false) {
+      exit(1);
+    }
+    initBuffer(&responses[numOfFiles]);
+    filenames[numOfFiles++] = argv[i];
+  }
+  resetBuffer(&frame);
+  writeFrame(descriptor, &frame);
+
+  /* The responses may arrive in any order, they are applied in the order of the files. */
+  while (received < numOfFiles && receiveResponse(descriptor, &frame, responses, numOfFiles) == true) {
+    received++;
+  }
+  close(descriptor);
+  if (received < numOfFiles) {
+    fprintf(stderr, "The assembler daemon closed the connection \n");
+    status = 1;
+  }
+
+  for (i = 0; i < numOfFiles; i++) {
+    if (responses[i].length > 0 && parseResponse(&responses[i], &response) == true) {
+      applyResponse(filenames[i], &response);
+      if (response.status == RESPONSE_FAILED) {
+        status = 1;
+      }
+    }
+    freeBuffer(&responses[i]);
+  }
+
+  freeBuffer(&frame);
+  free(responses);
+  free(filenames);
+  return status;
+}
+
+/* Read the options of the client, the rest of arguments are the input files.
+ *
+ * Params:
+ * int args: number of arguments.
+ * char *argv[]: the arguments.
+ * ClientOptions *options: the options to fill.
+ *
+ * Returns:
+ * Boolean status: true if all the options are valid, otherwise - false.
+*/
+Boolean parseClientOptions(int args, char *argv[], ClientOptions *options) {
+  int i;
+
+  options->socketPath = defaultSocketPath();
+  options->sym = false;
+  options->inlineSources = false;
+
+  for (i = 1; i < args; i++) {
+    if (isOption(argv[i]) == false) {
+      continue;
+    }
+
+    if (strncmp(argv[i], "--socket=", 9) == 0 && argv[i][9] != '\0') {
+      options->socketPath = argv[i] + 9;
+    } else if (strcmp(argv[i], "--sym") == 0) {
+      options->sym = true;
+    } else if (strcmp(argv[i], "--inline") == 0) {
+      options->inlineSources = true;
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Connect to the assembler daemon.
+ *
+ * Params:
+ * char *path: the path of the socket of the daemon.
+ *
+ * Returns:
+ * int descriptor: the connected socket, or -1 if the daemon is not available.
+*/
+int connectDaemon(char *path) {
+  struct sockaddr_un address;
+  int descriptor;
+
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "Socket path is too long: %s \n", path);
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path);
+
+  descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descriptor < 0 || connect(descriptor, (struct sockaddr *) &address, sizeof(address)) != 0) {
+    fprintf(stderr, "Cannot connect to the assembler daemon: %s \n", path);
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+    return -1;
+  }
+  return descriptor;
+}
+
+/* Send request for one input file - its absolute path, or its content when the sources are inline.
+ *
+ * Params:
+ * int descriptor: the socket of the daemon.
+ * char *filename: the name of the input file.
+ * ClientOptions *options: the options of the client.
+ * Buffer *frame: buffer for the request.
+ *
+ * Returns:
+ * Boolean status: true if the request was sent, otherwise - false.
+*/
+Boolean sendRequest(int descriptor, char *filename, ClientOptions *options, Buffer *frame) {
+  unsigned long flags = options->sym == true ? REQUEST_FLAG_SYM : 0;
+  unsigned long length;
+  char path[PATH_MAX];
+  char *content;
+
+  if (options->inlineSources == true) {
+    content = readFileContent(filename, &length);
+    if (content == NULL) {
+      printf("Cannot open file \n");
+      return false;
+    }
+    buildRequest(frame, REQUEST_INLINE, flags, filename, content, length);
+    free(content);
+  } else {
+    if (realpath(filename, path) == NULL) {
+      printf("Cannot open file \n");
+      return false;
+    }
+    buildRequest(frame, REQUEST_PATH, flags, path, NULL, 0);
+  }
+
+  if (writeFrame(descriptor, frame) == false) {
+    fprintf(stderr, "The assembler daemon closed the connection \n");
+    return false;
+  }
+  return true;
+}
+
+/* Read one response, and keep it with the request that it answers.
+ *
+ * Params:
+ * int descriptor: the socket of the daemon.
+ * Buffer *frame: buffer for the response.
+ * Buffer *responses: the responses by the index of their requests.
+ * int numOfFiles: the number of the requests that were sent.
+ *
+ * Returns:
+ * Boolean status: true if response was read, false if the daemon closed the connection.
+*/
+Boolean receiveResponse(int descriptor, Buffer *frame, Buffer *responses, int numOfFiles) {
+  Response response;
+
+  if (readFrame(descriptor, frame) == false) {
+    return false;
+  }
+  if (parseResponse(frame, &response) == false || response.index >= (unsigned long) numOfFiles) {
+    fprintf(stderr, "Invalid response from the assembler daemon \n");
+    exit(1);
+  }
+  appendBuffer(&responses[response.index], frame->data, frame->length);
+  return true;
+}
+
+/* Write the output files of response, or print its errors.
+ *
+ * Params:
+ * char *filename: the name of the input file.
+ * Response *response: the response of the daemon for the file.
+*/
+void applyResponse(char *filename, Response *response) {
+  Outputs outputs;
+  Buffer *buffers[4];
+  Boolean *exists[4];
+  int i;
+
+  if (response->status != RESPONSE_OK) {
+    if (response->sections[SECTION_DIAGNOSTICS] != NULL) {
+      fwrite(response->sections[SECTION_DIAGNOSTICS], 1, response->lengths[SECTION_DIAGNOSTICS], stderr);
+    }
+    return;
+  }
+
+  initOutputs(&outputs);
+  buffers[0] = &outputs.object;
+  buffers[1] = &outputs.entries;
+  buffers[2] = &outputs.externals;
+  buffers[3] = &outputs.symbols;
+  exists[0] = &outputs.hasObject;
+  exists[1] = &outputs.hasEntries;
+  exists[2] = &outputs.hasExternals;
+  exists[3] = &outputs.hasSymbols;
+  for (i = 0; i < 4; i++) {
+    if (response->sections[i] != NULL) {
+      appendBuffer(buffers[i], response->sections[i], response->lengths[i]);
+      *exists[i] = true;
+    }
+  }
+  saveOutputs(filename, &outputs, false);
+  freeOutputs(&outputs);
+}
@@ -1,6 +1,8 @@
 #ifndef MAMAN14_CONSTANTS_H
 #define MAMAN14_CONSTANTS_H
 
+#define ASSEMBLER_VERSION "1.1"
+
 extern int functs[8];
 extern int opcodes[27];
 extern char *registerName[32];
@@ -0,0 +1,116 @@
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "counters.h"
+
+char *counterNames[NUM_OF_COUNTERS] = {"cycles", "instructions", "cacheMisses", "branchMisses", "pageFaults"};
+
+int openCounter(unsigned int type, unsigned long config);
+
+/* Open all the counters of the calling thread. The counters that cannot be opened are left out.
+ *
+ * Params:
+ * Counters *counters: pointer to the counters.
+ *
+ * Returns:
+ * Boolean status: true if all the hardware counters are available, otherwise - false.
+*/
+Boolean openCounters(Counters *counters) {
+  int i;
+
+  counters->descriptors[COUNTER_CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+  counters->descriptors[COUNTER_INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+  counters->descriptors[COUNTER_CACHE_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  counters->descriptors[COUNTER_BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+  counters->descriptors[COUNTER_PAGE_FAULTS] = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+
+  counters->numOfAvailable = 0;
+  for (i = 0; i < NUM_OF_COUNTERS; i++) {
+    if (counters->descriptors[i] >= 0) {
+      counters->numOfAvailable++;
+    }
+  }
+  for (i = 0; i < COUNTER_PAGE_FAULTS; i++) {
+    if (counters->descriptors[i] < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Close all the counters.
+ *
+ * Params:
+ * Counters *counters: pointer to the counters.
+*/
+void closeCounters(Counters *counters) {
+  int i;
+
+  for (i = 0; i < NUM_OF_COUNTERS; i++) {
+    if (counters->descriptors[i] >= 0) {
+      close(counters->descriptors[i]);
+      counters->descriptors[i] = -1;
+    }
+  }
+  counters->numOfAvailable = 0;
+}
+
+/* Indicate if counter is available.
+ *
+ * Params:
+ * Counters *counters: pointer to the counters.
+ * int counter: the counter (COUNTER_*).
+ *
+ * Returns:
+ * Boolean status: true if the counter counts, otherwise - false.
+*/
+Boolean isCounterAvailable(Counters *counters, int counter) {
+  if (counters->descriptors[counter] >= 0) {
+    return true;
+  }
+  return false;
+}
+
+/* Read the current values of all the counters, counter that is not available reads as 0.
+ *
+ * Params:
+ * Counters *counters: pointer to the counters.
+ * unsigned long values[]: array to store the values into.
+*/
+void readCounters(Counters *counters, unsigned long values[NUM_OF_COUNTERS]) {
+  __u64 value;
+  int i;
+
+  for (i = 0; i < NUM_OF_COUNTERS; i++) {
+    values[i] = 0;
+    if (counters->descriptors[i] >= 0 &&
+        read(counters->descriptors[i], &value, sizeof(value)) == (ssize_t) sizeof(value)) {
+      values[i] = (unsigned long) value;
+    }
+  }
+}
+
+/* Open one counter of the calling thread (on any cpu), for user space only.
+ *
+ * Params:
+ * unsigned int type: the type of the event (PERF_TYPE_*).
+ * unsigned long config: the event.
+ *
+ * Returns:
+ * int descriptor: the descriptor of the counter, or -1 if it is not available.
+*/
+int openCounter(unsigned int type, unsigned long config) {
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.type = type;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
@@ -0,0 +1,35 @@
+#ifndef MAMAN14_COUNTERS_H
+#define MAMAN14_COUNTERS_H
+
+#include "Datatypes.h"
+
+/*
+ * Hardware performance counters of the calling thread, by Linux perf_event_open.
+ * Every counter is opened alone, so the counters that the machine (or the container) does not allow
+ * are left out and the others still count. Only user space is counted.
+ */
+
+#define COUNTER_CYCLES 0
+#define COUNTER_INSTRUCTIONS 1
+#define COUNTER_CACHE_MISSES 2
+#define COUNTER_BRANCH_MISSES 3
+#define COUNTER_PAGE_FAULTS 4
+#define NUM_OF_COUNTERS 5
+
+extern char *counterNames[NUM_OF_COUNTERS];
+
+/* Data structure representing the open counters, -1 for counter that is not available. */
+typedef struct counters {
+    int descriptors[NUM_OF_COUNTERS];
+    int numOfAvailable;
+} Counters;
+
+Boolean openCounters(Counters *counters);
+
+void closeCounters(Counters *counters);
+
+Boolean isCounterAvailable(Counters *counters, int counter);
+
+void readCounters(Counters *counters, unsigned long values[NUM_OF_COUNTERS]);
+
+#endif
@@ -0,0 +1,544 @@
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "daemon.h"
+#include "diskFiles.h"
+#include "libassembler.h"
+
+#define LISTEN_BACKLOG 64
+#define MAX_ACCEPT_FAILURES 20
+#define MAX_ACCEPT_DELAY_MS 1000
+
+/* Data structure representing client that is connected to the daemon.
+ * It is freed when the reader and all the jobs of the client are done. The lock guards only the counters,
+ * the writes of the responses (that block while the client does not read) have a lock of their own. */
+typedef struct connection {
+    int descriptor;
+    int references;
+    int pending;
+    pthread_mutex_t lock;
+    pthread_cond_t answered;
+    pthread_mutex_t writeLock;
+} Connection;
+
+/* Data structure representing request that waits for worker. */
+typedef struct job {
+    Connection *connection;
+    unsigned long index;
+    Buffer frame;
+    struct job *next;
+} Job;
+
+/* Data structure representing the queue of jobs that is shared by all the workers. */
+typedef struct jobQueue {
+    Job *head;
+    Job *tail;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} JobQueue;
+
+/* Data structure representing the arguments of worker thread. */
+typedef struct worker {
+    pthread_t thread;
+    JobQueue *queue;
+} Worker;
+
+/* Data structure representing the arguments of reader thread. */
+typedef struct reader {
+    Connection *connection;
+    JobQueue *queue;
+} Reader;
+
+volatile sig_atomic_t stopDaemon = 0;
+
+void handleStopSignal(int signalNumber);
+
+void releaseConnection(Connection *connection);
+
+void finishRequest(Connection *connection);
+
+void pushJob(JobQueue *queue, Job *job);
+
+Job *popJob(JobQueue *queue);
+
+void *readRequests(void *argument);
+
+void *runWorker(void *argument);
+
+void runJob(Job *job, AssemblerContext *context, Buffer *response);
+
+Boolean isPrivateDirectory(char *path);
+
+Boolean isSameUser(int descriptor);
+
+void waitAfterFailure(int failures);
+
+int openDaemonSocket(char *path);
+
+/* Mark that the daemon should stop, the accept loop checks it when it is interrupted.
+ *
+ * Params:
+ * int signalNumber: the signal (SIGINT or SIGTERM).
+*/
+void handleStopSignal(int signalNumber) {
+  stopDaemon = 1;
+}
+
+/* Drop one reference to connection, the last one closes the socket and frees the connection.
+ *
+ * Params:
+ * Connection *connection: the connection.
+*/
+void releaseConnection(Connection *connection) {
+  int references;
+
+  pthread_mutex_lock(&connection->lock);
+  references = --connection->references;
+  pthread_mutex_unlock(&connection->lock);
+
+  if (references == 0) {
+    close(connection->descriptor);
+    pthread_mutex_destroy(&connection->lock);
+    pthread_cond_destroy(&connection->answered);
+    pthread_mutex_destroy(&connection->writeLock);
+    free(connection);
+  }
+}
+
+/* Mark that request of connection was answered, and wake its reader if it waits for room.
+ *
+ * Params:
+ * Connection *connection: the connection.
+*/
+void finishRequest(Connection *connection) {
+  pthread_mutex_lock(&connection->lock);
+  connection->pending--;
+  pthread_cond_signal(&connection->answered);
+  pthread_mutex_unlock(&connection->lock);
+}
+
+/* Add job to the end of the queue, and wake one worker.
+ *
+ * Params:
+ * JobQueue *queue: the queue.
+ * Job *job: the job.
+*/
+void pushJob(JobQueue *queue, Job *job) {
+  job->next = NULL;
+  pthread_mutex_lock(&queue->lock);
+  if (queue->tail == NULL) {
+    queue->head = job;
+  } else {
+    queue->tail->next = job;
+  }
+  queue->tail = job;
+  pthread_cond_signal(&queue->ready);
+  pthread_mutex_unlock(&queue->lock);
+}
+
+/* Take the first job from the queue, wait until there is one.
+ *
+ * Params:
+ * JobQueue *queue: the queue.
+ *
+ * Returns:
+ * Job *job: the job.
+*/
+Job *popJob(JobQueue *queue) {
+  Job *job;
+
+  pthread_mutex_lock(&queue->lock);
+  while (queue->head == NULL) {
+    pthread_cond_wait(&queue->ready, &queue->lock);
+  }
+  job = queue->head;
+  queue->head = job->next;
+  if (queue->head == NULL) {
+    queue->tail = NULL;
+  }
+  pthread_mutex_unlock(&queue->lock);
+  return job;
+}
+
+/* Thread of connected client - read its requests and queue them for the workers,
+ * until the empty frame or the end of the connection. At most MAX_PENDING_REQUESTS requests
+ * of the client wait for their responses, so client that does not read cannot fill the queue.
+ *
+ * Params:
+ * void *argument: pointer to Reader (freed by the thread).
+ *
+ * Returns:
+ * void *result: always NULL.
+*/
+void *readRequests(void *argument) {
+  Reader *reader = (Reader *) argument;
+  Connection *connection = reader->connection;
+  unsigned long index = 0;
+  Job *job;
+
+  while (1) {
+    pthread_mutex_lock(&connection->lock);
+    while (connection->pending == MAX_PENDING_REQUESTS) {
+      pthread_cond_wait(&connection->answered, &connection->lock);
+    }
+    pthread_mutex_unlock(&connection->lock);
+
+    job = (Job *) calloc(1, sizeof(Job));
+    if (job == NULL) {
+      printf("Error: Allocation Error! \n");
+      break;
+    }
+    initBuffer(&job->frame);
+    if (readFrame(connection->descriptor, &job->frame) == false || job->frame.length == 0) {
+      freeBuffer(&job->frame);
+      free(job);
+      break;
+    }
+
+    job->connection = connection;
+    job->index = index++;
+    pthread_mutex_lock(&connection->lock);
+    connection->references++;
+    connection->pending++;
+    pthread_mutex_unlock(&connection->lock);
+    pushJob(reader->queue, job);
+  }
+
+  releaseConnection(connection);
+  free(reader);
+  return NULL;
+}
+
+/* Assemble the source of one request, and build the response for it.
+ *
+ * Params:
+ * Job *job: the job.
+ * AssemblerContext *context: the context of the worker.
+ * Buffer *response: the buffer for the response.
+*/
+void runJob(Job *job, AssemblerContext *context, Buffer *response) {
+  Request request;
+  struct stat status;
+  char *name, *content = NULL, *diagnostics;
+  const char *data;
+  unsigned long length;
+
+  if (parseRequest(&job->frame, &request) == false) {
+    buildResponse(response, job->index, RESPONSE_FAILED, NULL, "Invalid request \n", 17);
+    return;
+  }
+
+  if (request.type == REQUEST_PATH) {
+    /* The daemon does not share the directory of the client, so only absolute paths have a meaning. */
+    if (request.nameLength == 0 || request.name[0] != '/') {
+      buildResponse(response, job->index, RESPONSE_FAILED, NULL, "Path is not absolute \n", 22);
+      return;
+    }
+    /* The name is followed by other fields in the frame, so it is copied to be '\0' terminated. */
+    name = (char *) calloc(request.nameLength + 1, sizeof(char));
+    if (name == NULL) {
+      buildResponse(response, job->index, RESPONSE_FAILED, NULL, "Allocation Error! \n", 19);
+      return;
+    }
+    memcpy(name, request.name, request.nameLength);
+    /* FIFO or device could block the worker forever, only regular files are read. */
+    if (stat(name, &status) != 0 || !S_ISREG(status.st_mode)) {
+      free(name);
+      buildResponse(response, job->index, RESPONSE_FAILED, NULL, "Cannot open file \n", 18);
+      return;
+    }
+    content = readFileContent(name, &length);
+    free(name);
+    if (content == NULL) {
+      buildResponse(response, job->index, RESPONSE_FAILED, NULL, "Cannot open file \n", 18);
+      return;
+    }
+    data = content;
+  } else {
+    data = request.source;
+    length = request.sourceLength;
+  }
+
+  context->sym = (request.flags & REQUEST_FLAG_SYM) ? true : false;
+  if (assembleSource(context, data, length) == assembled) {
+    buildResponse(response, job->index, RESPONSE_OK, &context->outputs, NULL, 0);
+  } else {
+    diagnostics = formatErrors(context->errors, &length);
+    buildResponse(response, job->index, RESPONSE_ERRORS, NULL, diagnostics, length);
+    free(diagnostics);
+  }
+  free(content);
+}
+
+/* Worker thread - run the jobs from the queue, each worker keeps its own context warm.
+ *
+ * Params:
+ * void *argument: pointer to Worker.
+ *
+ * Returns:
+ * void *result: always NULL.
+*/
+void *runWorker(void *argument) {
+  Worker *worker = (Worker *) argument;
+  AssemblerContext context;
+  Buffer response;
+  Job *job;
+
+  initAssemblerContext(&context);
+  initBuffer(&response);
+  while (1) {
+    job = popJob(worker->queue);
+    runJob(job, &context, &response);
+
+    /* Responses of the same client are written by many workers, one frame at a time. */
+    pthread_mutex_lock(&job->connection->writeLock);
+    writeFrame(job->connection->descriptor, &response);
+    pthread_mutex_unlock(&job->connection->writeLock);
+
+    finishRequest(job->connection);
+    releaseConnection(job->connection);
+    freeBuffer(&job->frame);
+    free(job);
+  }
+  return NULL;
+}
+
+/* Create the directory of the default socket if it does not exist, and check that only the user can enter it,
+ * so no other user can connect to the socket or replace it.
+ *
+ * Params:
+ * char *path: the path of the socket.
+ *
+ * Returns:
+ * Boolean status: true if the directory of the socket is private, otherwise - false.
+*/
+Boolean isPrivateDirectory(char *path) {
+  char directory[MAX_SOCKET_PATH];
+  struct stat status;
+  char *slash;
+
+  strcpy(directory, path);
+  slash = strrchr(directory, '/');
+  if (slash == NULL || slash == directory) {
+    fprintf(stderr, "Error! The socket %s is not in private directory \n", path);
+    return false;
+  }
+  *slash = '\0';
+
+  if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+    perror(directory);
+    return false;
+  }
+  if (lstat(directory, &status) != 0) {
+    perror(directory);
+    return false;
+  }
+  if (!S_ISDIR(status.st_mode) || status.st_uid != geteuid() || (status.st_mode & 077) != 0) {
+    fprintf(stderr, "Error! The directory %s of the socket is not private to the user \n", directory);
+    return false;
+  }
+  return true;
+}
+
+/* Check that the client runs as the same user as the daemon, so it cannot read files through the daemon
+ * that it could not read itself.
+ *
+ * Params:
+ * int descriptor: the socket of the client.
+ *
+ * Returns:
+ * Boolean status: true if the client is the same user (or it cannot be known on this system), otherwise - false.
+*/
+Boolean isSameUser(int descriptor) {
+#ifdef SO_PEERCRED
+  struct ucred credentials;
+  socklen_t length = sizeof(credentials);
+
+  if (getsockopt(descriptor, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+    return false;
+  }
+  return credentials.uid == geteuid() ? true : false;
+#else
+  return true;
+#endif
+}
+
+/* Wait before the next accept after it failed, longer after every failure in a row.
+ * Running out of descriptors or memory is usually temporary, so the daemon does not spin on it.
+ *
+ * Params:
+ * int failures: the number of failures in a row.
+*/
+void waitAfterFailure(int failures) {
+  struct timespec delay;
+  long milliseconds = 10;
+
+  while (--failures > 0 && milliseconds < MAX_ACCEPT_DELAY_MS) {
+    milliseconds *= 2;
+  }
+  if (milliseconds > MAX_ACCEPT_DELAY_MS) {
+    milliseconds = MAX_ACCEPT_DELAY_MS;
+  }
+  delay.tv_sec = milliseconds / 1000;
+  delay.tv_nsec = (milliseconds % 1000) * 1000000L;
+  nanosleep(&delay, NULL);
+}
+
+/* Create the listening socket of the daemon, instead of previous socket in the same path.
+ * The socket can be used only by the user (mode 0600), and the default one is in private directory.
+ *
+ * Params:
+ * char *path: the path of the socket.
+ *
+ * Returns:
+ * int descriptor: the socket, or -1 if it cannot be created.
+*/
+int openDaemonSocket(char *path) {
+  struct sockaddr_un address;
+  struct stat status;
+  mode_t mask;
+  int descriptor, result;
+
+  if (strlen(path) >= sizeof(address.sun_path)) {
+    fprintf(stderr, "Socket path is too long: %s \n", path);
+    return -1;
+  }
+  if (strcmp(path, defaultSocketPath()) == 0 && isPrivateDirectory(path) == false) {
+    return -1;
+  }
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path);
+
+  /* Only previous socket is replaced, never a file that is in the same path by mistake. */
+  if (lstat(path, &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      fprintf(stderr, "Error! %s exists and is not socket \n", path);
+      return -1;
+    }
+    unlink(path);
+  }
+
+  descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descriptor < 0) {
+    perror("socket");
+    return -1;
+  }
+  /* The workers are not started yet, so the mask of the process can be changed here. */
+  mask = umask(0177);
+  result = bind(descriptor, (struct sockaddr *) &address, sizeof(address));
+  umask(mask);
+  if (result != 0 || listen(descriptor, LISTEN_BACKLOG) != 0) {
+    perror(path);
+    close(descriptor);
+    return -1;
+  }
+  return descriptor;
+}
+
+/* Run the assembler as daemon - accept clients on Unix domain socket and assemble their requests
+ * on pool of workers, until SIGINT or SIGTERM.
+ *
+ * Params:
+ * Options *options: the options of the assembler.
+ *
+ * Returns:
+ * int status: exit status of the assembler.
+*/
+int runDaemon(Options *options) {
+  JobQueue queue;
+  Worker *workers;
+  Reader *reader;
+  Connection *connection;
+  pthread_t thread;
+  struct sigaction action;
+  int listener, descriptor, failures = 0, status = 0, i;
+
+  listener = openDaemonSocket(options->socketPath);
+  if (listener < 0) {
+    return 1;
+  }
+
+  /* Closed client should not kill the daemon, and the signals to stop should interrupt accept. */
+  signal(SIGPIPE, SIG_IGN);
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = handleStopSignal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  queue.head = NULL;
+  queue.tail = NULL;
+  pthread_mutex_init(&queue.lock, NULL);
+  pthread_cond_init(&queue.ready, NULL);
+
+  workers = (Worker *) calloc(options->workers, sizeof(Worker));
+  if (workers == NULL) {
+    printf("Error: Allocation Error! \n");
+    close(listener);
+    return 1;
+  }
+  for (i = 0; i < options->workers; i++) {
+    workers[i].queue = &queue;
+    pthread_create(&workers[i].thread, NULL, runWorker, &workers[i]);
+    pthread_detach(workers[i].thread);
+  }
+
+  while (stopDaemon == 0) {
+    descriptor = accept(listener, NULL, NULL);
+    if (descriptor < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      perror("accept");
+      if (++failures == MAX_ACCEPT_FAILURES) {
+        fprintf(stderr, "Error! The daemon cannot accept clients, it stops \n");
+        status = 1;
+        break;
+      }
+      waitAfterFailure(failures);
+      continue;
+    }
+    failures = 0;
+    if (isSameUser(descriptor) == false) {
+      close(descriptor);
+      continue;
+    }
+
+    connection = (Connection *) calloc(1, sizeof(Connection));
+    reader = (Reader *) calloc(1, sizeof(Reader));
+    if (connection == NULL || reader == NULL) {
+      printf("Error: Allocation Error! \n");
+      free(connection);
+      free(reader);
+      close(descriptor);
+      continue;
+    }
+    connection->descriptor = descriptor;
+    connection->references = 1;
+    connection->pending = 0;
+    pthread_mutex_init(&connection->lock, NULL);
+    pthread_cond_init(&connection->answered, NULL);
+    pthread_mutex_init(&connection->writeLock, NULL);
+    reader->connection = connection;
+    reader->queue = &queue;
+    if (pthread_create(&thread, NULL, readRequests, reader) != 0) {
+      releaseConnection(connection);
+      free(reader);
+      continue;
+    }
+    pthread_detach(thread);
+  }
+
+  /* The workers are stopped with the process, only the socket file is removed. */
+  close(listener);
+  unlink(options->socketPath);
+  return status;
+}
@@ -0,0 +1,11 @@
+#ifndef MAMAN14_DAEMON_H
+#define MAMAN14_DAEMON_H
+
+#include "options.h"
+#include "protocol.h"
+
+#define DEFAULT_WORKERS 4
+
+int runDaemon(Options *options);
+
+#endif
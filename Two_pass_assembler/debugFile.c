@@ -0,0 +1,225 @@
+#include "debugFile.h"
+
+/* Data structure representing the walk over the rows of .dbg file - the commands, then the data lines. */
+typedef struct debugRows {
+    Command *command;
+    DataItem *data;
+} DebugRows;
+
+Boolean nextDebugRow(DebugRows *rows, unsigned long *address, long *line);
+
+int encodeVarint(char *bytes, unsigned long value);
+
+unsigned long readVarint(const unsigned char *data, unsigned long *offset);
+
+/*
+ * Creates the content of .dbg file - the table from the addresses of the commands and of the data
+ * lines to their lines, in blocks of delta encoded rows. The addresses and the lines are the ones
+ * that pass 1 gave to the commands and to the data items, the source is not read again.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * Command **commands: the commands linked list.
+ * DataItem **dataPicture: the dataPicture linked list (with the addresses after ICF).
+ * unsigned long ICF: the end of the Orders image.
+ * unsigned long IDF: the end of the dataPicture image.
+ */
+void createDebugFile(Outputs *outputs, Command **commands, DataItem **dataPicture, unsigned long ICF,
+                     unsigned long IDF) {
+  Buffer *buffer = &outputs->debug;
+  DebugRows rows;
+  unsigned long numOfRows = 0, numOfBlocks, index, block, deltas;
+  unsigned long address, previousAddress = 0;
+  long line, previousLine = 0, delta;
+  char row[16];
+  int length;
+
+  rows.command = *commands;
+  rows.data = *dataPicture;
+  while (nextDebugRow(&rows, &address, &line) == true) {
+    numOfRows++;
+  }
+  numOfBlocks = (numOfRows + DBG_BLOCK_ROWS - 1) / DBG_BLOCK_ROWS;
+
+  outputs->hasDebug = true;
+  appendBuffer(buffer, DBG_MAGIC, 4);
+  appendField(buffer, DBG_VERSION);
+  appendField(buffer, numOfRows);
+  appendField(buffer, numOfBlocks);
+  appendField(buffer, DBG_BLOCK_ROWS);
+  appendField(buffer, ICF);
+  appendField(buffer, IDF);
+  appendField(buffer, 0);
+  /* The blocks are filled when their first rows are written. */
+  for (block = 0; block < numOfBlocks * (DBG_BLOCK_SIZE / 4); block++) {
+    appendField(buffer, 0);
+  }
+  deltas = buffer->length;
+
+  rows.command = *commands;
+  rows.data = *dataPicture;
+  for (index = 0; nextDebugRow(&rows, &address, &line) == true; index++) {
+    if (index % DBG_BLOCK_ROWS == 0) {
+      block = DBG_HEADER_SIZE + DBG_BLOCK_SIZE * (index / DBG_BLOCK_ROWS);
+      writeField(buffer, block + 4 * DBG_BLOCK_ADDRESS, address);
+      writeField(buffer, block + 4 * DBG_BLOCK_LINE, (unsigned long) line);
+      writeField(buffer, block + 4 * DBG_BLOCK_OFFSET, buffer->length - deltas);
+    } else {
+      delta = line - previousLine;
+      length = encodeVarint(row, address - previousAddress);
+      length += encodeVarint(row + length, delta >= 0 ? (unsigned long) delta * 2 : (unsigned long) -delta * 2 - 1);
+      appendBuffer(buffer, row, (unsigned long) length);
+    }
+    previousAddress = address;
+    previousLine = line;
+  }
+  writeField(buffer, 4 * DBG_FIELD_DELTAS, buffer->length - deltas);
+}
+
+/* Get the next row - the next command, or the first data item of the next data line.
+ *
+ * Params:
+ * DebugRows *rows: the walk over the rows, it is moved after the row.
+ * unsigned long *address: pointer to the address of the row.
+ * long *line: pointer to the line of the row.
+ *
+ * Returns:
+ * Boolean status: true if there is row, false at the end of the rows.
+*/
+Boolean nextDebugRow(DebugRows *rows, unsigned long *address, long *line) {
+  if (rows->command != NULL) {
+    *address = rows->command->address;
+    *line = rows->command->lineNumber;
+    rows->command = rows->command->next;
+    return true;
+  }
+  if (rows->data == NULL) {
+    return false;
+  }
+  *address = rows->data->address;
+  *line = rows->data->lineNumber;
+  while (rows->data != NULL && rows->data->lineNumber == *line) {
+    rows->data = rows->data->next;
+  }
+  return true;
+}
+
+/* Encode unsigned integer in variable length - 7 bits in every byte, the lowest first, and the high
+ * bit of every byte but the last is set.
+ *
+ * Params:
+ * char *bytes: array to encode the integer into (at least 5 bytes for 32 bits).
+ * unsigned long value: the value.
+ *
+ * Returns:
+ * int length: the number of the bytes.
+*/
+int encodeVarint(char *bytes, unsigned long value) {
+  int length = 0;
+
+  while (value >= 0x80) {
+    bytes[length++] = (char) ((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  bytes[length++] = (char) value;
+  return length;
+}
+
+/* Read unsigned integer of variable length, like encodeVarint encodes it.
+ *
+ * Params:
+ * const unsigned char *data: the bytes.
+ * unsigned long *offset: pointer to the offset of the integer, it is moved after it.
+ *
+ * Returns:
+ * unsigned long value: the value.
+*/
+unsigned long readVarint(const unsigned char *data, unsigned long *offset) {
+  unsigned long value = 0;
+  int shift = 0;
+
+  while (data[*offset] & 0x80) {
+    value |= (unsigned long) (data[(*offset)++] & 0x7F) << shift;
+    shift += 7;
+  }
+  value |= (unsigned long) data[(*offset)++] << shift;
+  return value;
+}
+
+/* Check that the image is a .dbg file that this version can read, and that all its sections are in it.
+ *
+ * Params:
+ * const unsigned char *image: the content of .dbg file.
+ * unsigned long length: the length of the image in bytes.
+ *
+ * Returns:
+ * Boolean status: true if the image is valid, otherwise - false.
+*/
+Boolean isDebugImage(const unsigned char *image, unsigned long length) {
+  unsigned long numOfRows, numOfBlocks, blockRows;
+
+  if (length < DBG_HEADER_SIZE || memcmp(image, DBG_MAGIC, 4) != 0 ||
+      readField(image, 4 * DBG_FIELD_VERSION) != DBG_VERSION) {
+    return false;
+  }
+
+  numOfRows = readField(image, 4 * DBG_FIELD_ROWS);
+  numOfBlocks = readField(image, 4 * DBG_FIELD_BLOCKS);
+  blockRows = readField(image, 4 * DBG_FIELD_BLOCK_ROWS);
+  if (blockRows == 0 || numOfBlocks != (numOfRows + blockRows - 1) / blockRows ||
+      DBG_HEADER_SIZE + DBG_BLOCK_SIZE * numOfBlocks + readField(image, 4 * DBG_FIELD_DELTAS) > length) {
+    return false;
+  }
+  return true;
+}
+
+/* Find the line of the source of address - binary search of the last block that starts at the
+ * address or before it, and then the rows of the block until the address.
+ *
+ * Params:
+ * const unsigned char *image: the content of .dbg file.
+ * unsigned long address: the address.
+ *
+ * Returns:
+ * long line: the number of the line, or -1 if the address is not in the code or in the data.
+*/
+long findDebugLine(const unsigned char *image, unsigned long address) {
+  unsigned long numOfRows = readField(image, 4 * DBG_FIELD_ROWS);
+  unsigned long numOfBlocks = readField(image, 4 * DBG_FIELD_BLOCKS);
+  unsigned long blockRows = readField(image, 4 * DBG_FIELD_BLOCK_ROWS);
+  unsigned long low = 0, high = numOfBlocks, middle, row, offset, rowAddress, nextAddress, zigzag;
+  const unsigned char *block, *deltas;
+  long line;
+
+  if (numOfRows == 0 || address >= readField(image, 4 * DBG_FIELD_DATA_END)) {
+    return -1;
+  }
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    if (readField(image, DBG_HEADER_SIZE + DBG_BLOCK_SIZE * middle + 4 * DBG_BLOCK_ADDRESS) <= address) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == 0) {
+    return -1;
+  }
+
+  block = image + DBG_HEADER_SIZE + DBG_BLOCK_SIZE * (low - 1);
+  deltas = image + DBG_HEADER_SIZE + DBG_BLOCK_SIZE * numOfBlocks;
+  rowAddress = readField(block, 4 * DBG_BLOCK_ADDRESS);
+  line = (long) readField(block, 4 * DBG_BLOCK_LINE);
+  offset = readField(block, 4 * DBG_BLOCK_OFFSET);
+  for (row = (low - 1) * blockRows + 1; row < numOfRows && row % blockRows != 0; row++) {
+    nextAddress = rowAddress + readVarint(deltas, &offset);
+    zigzag = readVarint(deltas, &offset);
+    if (nextAddress > address) {
+      break;
+    }
+    rowAddress = nextAddress;
+    line += (zigzag & 1) ? -(long) ((zigzag + 1) / 2) : (long) (zigzag / 2);
+  }
+  return line;
+}
@@ -0,0 +1,50 @@
+#ifndef MAMAN14_DEBUGFILE_H
+#define MAMAN14_DEBUGFILE_H
+
+#include "Datatypes.h"
+#include "files.h"
+
+/*
+ * Layout of .dbg file - binary table from addresses to the lines of the source, that can be mapped
+ * into memory and searched as is. All the fields are 32 bits unsigned integers in little endian.
+ *
+ * header:  magic "ADBG", version, rows count, blocks count, rows in block, the end of the code
+ *          (ICF), the end of the data (IDF), deltas size.
+ * rows:    one row for every command and for every data line, (address, line) sorted by address -
+ *          the code first, then the data. Row covers the addresses until the next row.
+ * blocks:  every DBG_BLOCK_ROWS rows are one block, every block is the address and the line of its
+ *          first row and the offset of its other rows in the deltas.
+ * deltas:  the other rows of every block, each one is the difference from the previous row - the
+ *          address (unsigned) and the line (zigzag, the data may start before the last command),
+ *          both as variable length integers of 7 bits in every byte, the lowest first.
+ *
+ * Address is found by binary search of its block, and then by reading at most DBG_BLOCK_ROWS rows.
+ */
+#define DBG_MAGIC "ADBG"
+#define DBG_VERSION 1
+#define DBG_HEADER_SIZE 32
+#define DBG_BLOCK_SIZE 12
+#define DBG_BLOCK_ROWS 16
+
+/* Indexes of header fields. */
+#define DBG_FIELD_VERSION 1
+#define DBG_FIELD_ROWS 2
+#define DBG_FIELD_BLOCKS 3
+#define DBG_FIELD_BLOCK_ROWS 4
+#define DBG_FIELD_CODE_END 5
+#define DBG_FIELD_DATA_END 6
+#define DBG_FIELD_DELTAS 7
+
+/* Indexes of block fields. */
+#define DBG_BLOCK_ADDRESS 0
+#define DBG_BLOCK_LINE 1
+#define DBG_BLOCK_OFFSET 2
+
+void createDebugFile(Outputs *outputs, Command **commands, DataItem **dataPicture, unsigned long ICF,
+                     unsigned long IDF);
+
+Boolean isDebugImage(const unsigned char *image, unsigned long length);
+
+long findDebugLine(const unsigned char *image, unsigned long address);
+
+#endif
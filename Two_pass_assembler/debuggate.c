@@ -0,0 +1,248 @@
+#include <ctype.h>
+#include "libassembler.h"
+#include "debugFile.h"
+#include "listing.h"
+#include "diskFiles.h"
+#include "generator.h"
+
+#define DEFAULT_LISTING "tests/input.lst"
+#define DEFAULT_DEBUG "tests/input.dbg"
+#define DEFAULT_LINES 20000
+
+Boolean checkDebugFiles(char *listingName, char *debugName);
+
+Boolean checkGeneratedProgram(unsigned long seed, unsigned long numOfLines);
+
+Boolean checkDebugLines(const char *listing, unsigned long listingLength, const unsigned char *image,
+                        unsigned long imageLength, char *name);
+
+Boolean checkDebugImageErrors(const unsigned char *image, unsigned long length);
+
+/*
+ * Debug table gate: every address in the listing (the address of every byte of its rows) has to be found
+ * by findDebugLine in the debug table of the same source, with the line of its row, and the addresses
+ * before the code and after the data must not be found. It is checked on tests/input.lst and
+ * tests/input.dbg, and on the listing and the debug table of generated program that are built in memory.
+ * isDebugImage has to accept the tables, and to reject them when they are cut or their header is wrong.
+ *
+ * Usage: debuggate [--seed=N] [--lines=N]
+ */
+int main(int args, char *argv[]) {
+  unsigned long seed = 1;
+  unsigned long numOfLines = DEFAULT_LINES;
+  int failures = 0;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+    } else if (strncmp(argv[i], "--lines=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfLines = strtoul(argv[i] + 8, NULL, 10);
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  failures += checkDebugFiles(DEFAULT_LISTING, DEFAULT_DEBUG) == true ? 0 : 1;
+  failures += checkGeneratedProgram(seed, numOfLines) == true ? 0 : 1;
+
+  if (failures > 0) {
+    printf("Error! %d checks of the debug table failed. \n", failures);
+    return 1;
+  }
+  return 0;
+}
+
+/* Check the debug table of the goldens against their listing.
+ *
+ * Params:
+ * char *listingName: the name of the .lst file.
+ * char *debugName: the name of the .dbg file.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkDebugFiles(char *listingName, char *debugName) {
+  char *listing, *image;
+  unsigned long listingLength, imageLength;
+  Boolean status;
+
+  listing = readFileContent(listingName, &listingLength);
+  image = readFileContent(debugName, &imageLength);
+  if (listing == NULL || image == NULL) {
+    printf("Error! cannot read %s and %s. \n", listingName, debugName);
+    free(listing);
+    free(image);
+    return false;
+  }
+
+  status = checkDebugLines(listing, listingLength, (unsigned char *) image, imageLength, debugName);
+  if (checkDebugImageErrors((unsigned char *) image, imageLength) == false) {
+    status = false;
+  }
+  free(listing);
+  free(image);
+  return status;
+}
+
+/* Assemble generated program with its listing and debug table, and check the table against the listing.
+ *
+ * Params:
+ * unsigned long seed: the seed of the generated source.
+ * unsigned long numOfLines: the number of lines of the generated source.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkGeneratedProgram(unsigned long seed, unsigned long numOfLines) {
+  AssemblerContext context;
+  GeneratorMix mix;
+  Buffer source;
+  Boolean status;
+
+  initGeneratorMix(&mix);
+  initBuffer(&source);
+  if (generateSource(&source, seed, numOfLines, &mix) == false) {
+    printf("Error: Allocation Error! \n");
+    return false;
+  }
+
+  initAssemblerContext(&context);
+  context.listing = true;
+  context.debug = true;
+  if (assembleSource(&context, source.data, source.length) != assembled) {
+    printf("The generated source was not assembled (%d errors) \n", context.numOfErrors);
+    freeAssemblerContext(&context);
+    freeBuffer(&source);
+    return false;
+  }
+
+  status = checkDebugLines(context.outputs.listing.data, context.outputs.listing.length,
+                           (unsigned char *) context.outputs.debug.data, context.outputs.debug.length,
+                           "generated program");
+  freeAssemblerContext(&context);
+  freeBuffer(&source);
+  return status;
+}
+
+/* Find the line of every byte of the rows of the listing in the debug table. The columns are found by the
+ * header of the listing: the address, the bytes and the line - the rows that continue the data of the
+ * previous row have no line, and the lines without command or data have no address. The rows end at the
+ * empty line before the symbols.
+ *
+ * Params:
+ * const char *listing: the content of the listing.
+ * unsigned long listingLength: the length of the listing.
+ * const unsigned char *image: the debug table.
+ * unsigned long imageLength: the length of the debug table.
+ * char *name: the name of the table, for the messages.
+ *
+ * Returns:
+ * Boolean status: true if every address was found with its line, otherwise - false.
+*/
+Boolean checkDebugLines(const char *listing, unsigned long listingLength, const unsigned char *image,
+                        unsigned long imageLength, char *name) {
+  unsigned long position, end, address, first = 0, last = 0, numOfBytes = 0;
+  long lineNumber = 0, found;
+  int bytesColumn, lineColumn, rowLength, i;
+  const char *text;
+
+  if (isDebugImage(image, imageLength) == false) {
+    printf("Error! %s is not valid debug table. \n", name);
+    return false;
+  }
+
+  for (end = 0; end < listingLength && listing[end] != '\n'; end++) {
+  }
+  for (bytesColumn = 0; bytesColumn + 5 <= (int) end && strncmp(listing + bytesColumn, "bytes", 5) != 0;
+       bytesColumn++) {
+  }
+  if (bytesColumn + 5 > (int) end) {
+    printf("Error! the listing of %s has no header. \n", name);
+    return false;
+  }
+  lineColumn = bytesColumn + LISTING_ROW_BYTES * 3 - 1 + 2;
+
+  for (position = end + 1; position < listingLength; position = end + 1) {
+    for (end = position; end < listingLength && listing[end] != '\n'; end++) {
+    }
+    text = listing + position;
+    rowLength = (int) (end - position);
+    if (rowLength == 0) {
+      break;
+    }
+    if (rowLength > lineColumn) {
+      lineNumber = strtol(text + lineColumn, NULL, 10);
+    }
+    if (text[0] == ' ') {
+      continue;
+    }
+
+    address = strtoul(text, NULL, 10);
+    for (i = 0; i < LISTING_ROW_BYTES && bytesColumn + 3 * i + 1 < rowLength &&
+                isxdigit((unsigned char) text[bytesColumn + 3 * i]); i++, address++, numOfBytes++) {
+      found = findDebugLine(image, address);
+      if (found != lineNumber) {
+        printf("Error! address %lu of %s is in line %ld of the debug table, but in line %ld of the listing. \n",
+               address, name, found, lineNumber);
+        return false;
+      }
+      if (numOfBytes == 0 || address < first) {
+        first = address;
+      }
+      if (address >= last) {
+        last = address + 1;
+      }
+    }
+  }
+
+  if (numOfBytes == 0 || findDebugLine(image, first - 1) != -1 || findDebugLine(image, last) != -1) {
+    printf("Error! addresses out of %lu-%lu of %s are found in the debug table. \n", first, last, name);
+    return false;
+  }
+  printf("%s: %lu addresses (%lu-%lu) found in the lines of the listing \n", name, numOfBytes, first, last - 1);
+  return true;
+}
+
+/* Check that isDebugImage rejects debug table that was cut, or whose magic, version or rows in block are wrong.
+ *
+ * Params:
+ * const unsigned char *image: valid debug table.
+ * unsigned long length: the length of the table.
+ *
+ * Returns:
+ * Boolean status: true if every broken table was rejected, otherwise - false.
+*/
+Boolean checkDebugImageErrors(const unsigned char *image, unsigned long length) {
+  unsigned char *broken;
+  Boolean status = true;
+  int i;
+
+  broken = (unsigned char *) malloc(length);
+  if (broken == NULL) {
+    printf("Error: Allocation Error! \n");
+    return false;
+  }
+
+  if (isDebugImage(image, length - 1) == true || isDebugImage(image, DBG_HEADER_SIZE - 1) == true) {
+    printf("Error! cut debug table is valid. \n");
+    status = false;
+  }
+  for (i = 0; i < 3; i++) {
+    memcpy(broken, image, length);
+    if (i == 0) {
+      broken[0] = 'X';
+    } else if (i == 1) {
+      broken[4 * DBG_FIELD_VERSION]++;
+    } else {
+      memset(broken + 4 * DBG_FIELD_BLOCK_ROWS, 0, 4);
+    }
+    if (isDebugImage(broken, length) == true) {
+      printf("Error! debug table with wrong %s is valid. \n", i == 0 ? "magic" : i == 1 ? "version" : "rows in block");
+      status = false;
+    }
+  }
+  free(broken);
+  return status;
+}
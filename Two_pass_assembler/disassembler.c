@@ -0,0 +1,73 @@
+#include "disassembly.h"
+#include "diskFiles.h"
+
+/*
+ * Disassembler of .ob file back into source of the assembler, the source is written to stdout. With
+ * --labels the names of the .ent and the .ext files next to the .ob file are used, otherwise the
+ * targets of the commands get the names of L and their addresses. Assembling the source gives the
+ * same .ob file again (and with --labels, the same .ext file and the same lines of the .ent file).
+ *
+ * Usage: disassembler [--labels] file.ob > file.as
+ */
+int main(int args, char *argv[]) {
+  char *name = NULL;
+  Boolean labels = false, status;
+  ObjectSymbols entries, externals;
+  ObjectImage image;
+  unsigned long length;
+  char *content;
+  Buffer source;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strcmp(argv[i], "--labels") == 0) {
+      labels = true;
+    } else if (strncmp(argv[i], "--", 2) == 0 || name != NULL) {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    } else {
+      name = argv[i];
+    }
+  }
+  if (name == NULL) {
+    printf("No file specified!");
+    exit(1);
+  }
+  if (strlen(name) < 3 || strcmp(name + strlen(name) - 3, ".ob") != 0) {
+    fprintf(stderr, "File is not ob file: %s \n", name);
+    exit(1);
+  }
+
+  content = readFileContent(name, &length);
+  if (content == NULL) {
+    printf("Cannot open file %s \n", name);
+    exit(1);
+  }
+  initObjectImage(&image);
+  status = loadObjectImage(&image, content, length);
+  free(content);
+  if (status == false) {
+    fprintf(stderr, "Error! %s is not a valid object file \n", name);
+    exit(1);
+  }
+  initObjectSymbols(&entries);
+  initObjectSymbols(&externals);
+  if (labels == true &&
+      (readSymbolsFile(&entries, name, ".ent") == false || readSymbolsFile(&externals, name, ".ext") == false)) {
+    exit(1);
+  }
+
+  initBuffer(&source);
+  status = disassembleImage(&source, &image, labels == true ? &entries : NULL, labels == true ? &externals : NULL);
+  fwrite(source.data, 1, source.length, stdout);
+  if (status == false) {
+    fprintf(stderr, "Error! %s: some words are not commands, or some data cannot be written in the source \n",
+            name);
+  }
+
+  freeBuffer(&source);
+  freeObjectImage(&image);
+  freeObjectSymbols(&entries);
+  freeObjectSymbols(&externals);
+  return status == true ? 0 : 1;
+}
@@ -0,0 +1,596 @@
+#include "disassembly.h"
+
+/* Data structure representing the tables of the decoding - the name and the kind of every opcode, and
+ * the names of the R commands by their opcode and funct. */
+typedef struct decodingTables {
+    char *names[64];
+    char *rNames[2][32];
+    CmdSubtype kinds[64];
+} DecodingTables;
+
+/* Data structure representing the labels of the disassembly - bit for every byte of the image that has
+ * label, the entries sorted by address (for their names), the targets out of the image, and the number
+ * of the letters L of the prefix of the generated names. */
+typedef struct disassemblyLabels {
+    unsigned char *marks;
+    unsigned long end;
+    ObjectSymbol *named;
+    unsigned long numOfNamed;
+    unsigned long *outside;
+    unsigned long numOfOutside;
+    unsigned long capacityOfOutside;
+    int prefixLength;
+} DisassemblyLabels;
+
+void initDecodingTables(DecodingTables *tables);
+
+Boolean markDisassemblyLabel(DisassemblyLabels *labels, unsigned long address);
+
+Boolean isDisassemblyLabel(DisassemblyLabels *labels, unsigned long address);
+
+int getPrefixLength(ObjectSymbols *entries, ObjectSymbols *externals);
+
+Boolean getWordTarget(DecodingTables *tables, unsigned long word, unsigned long address, unsigned long *target);
+
+int compareSymbolAddresses(const void *first, const void *second);
+
+int compareAddresses(const void *first, const void *second);
+
+int writeLineText(char *line, int length, const char *text);
+
+int writeLineNumber(char *line, int length, long value);
+
+int writeLabelName(char *line, int length, DisassemblyLabels *labels, unsigned long address);
+
+Boolean writeCommandLine(char *line, int *length, DecodingTables *tables, unsigned long word,
+                         unsigned long address, const char *external, DisassemblyLabels *labels);
+
+Boolean writeDataLine(char *line, int *length, unsigned char *bytes, unsigned long count);
+
+/*
+ * Disassemble image into the source of the assembler: the .entry and .extern lines, then one command
+ * for every word of the code, and then the data. The labels are marked first in bit for every byte -
+ * the entries, and the targets of the commands that are not references of the .ext file - so the code
+ * and the data are written in one walk, every line straight into the end of the buffer.
+ *
+ * Params:
+ * Buffer *buffer: the source (the disassembly is appended to it).
+ * ObjectImage *image: pointer to the image.
+ * ObjectSymbols *entries: the symbols of the .ent file (NULL if there is none).
+ * ObjectSymbols *externals: the references of the .ext file (NULL if there is none).
+ *
+ * Returns:
+ * Boolean status: true if the disassembly gives the same image, false if some word is not a command
+ * or some data cannot be written in the source (they are written as comments), or if there is no memory.
+ */
+Boolean disassembleImage(Buffer *buffer, ObjectImage *image, ObjectSymbols *entries, ObjectSymbols *externals) {
+  unsigned long codeEnd = IMAGE_BASE + image->codeSize, end = codeEnd + image->dataSize;
+  unsigned long numOfReferences = externals == NULL ? 0 : externals->length, reference = 0;
+  unsigned long numOfEntries = entries == NULL ? 0 : entries->length;
+  unsigned long item, address, target, count, kept;
+  ObjectSymbol *references;
+  DisassemblyLabels labels;
+  DecodingTables tables;
+  LabelTable names;
+  const char *external;
+  Boolean status = true;
+  char *line;
+  int length;
+
+  initDecodingTables(&tables);
+  initLabelTable(&names);
+  labels.end = end;
+  labels.numOfNamed = numOfEntries;
+  labels.outside = NULL;
+  labels.numOfOutside = 0;
+  labels.capacityOfOutside = 0;
+  labels.prefixLength = getPrefixLength(entries, externals);
+  labels.marks = (unsigned char *) calloc((end - IMAGE_BASE) / 8 + 1, sizeof(unsigned char));
+  labels.named = (ObjectSymbol *) malloc((numOfEntries + 1) * sizeof(ObjectSymbol));
+  references = (ObjectSymbol *) malloc((numOfReferences + 1) * sizeof(ObjectSymbol));
+  if (labels.marks == NULL || labels.named == NULL || references == NULL) {
+    status = false;
+  }
+
+  /* The entries and the references sorted by address - the names of the labels are searched in the
+   * entries, and the references are met in the walk over the code. */
+  if (status == true && numOfEntries > 0) {
+    memcpy(labels.named, entries->items, numOfEntries * sizeof(ObjectSymbol));
+    qsort(labels.named, numOfEntries, sizeof(ObjectSymbol), compareSymbolAddresses);
+  }
+  if (status == true && numOfReferences > 0) {
+    memcpy(references, externals->items, numOfReferences * sizeof(ObjectSymbol));
+    qsort(references, numOfReferences, sizeof(ObjectSymbol), compareSymbolAddresses);
+  }
+  for (item = 0; item < numOfEntries && status == true; item++) {
+    status = markDisassemblyLabel(&labels, labels.named[item].address);
+  }
+  for (address = IMAGE_BASE; address < codeEnd && status == true; address += 4) {
+    while (reference < numOfReferences && references[reference].address < address) {
+      reference++;
+    }
+    if ((reference == numOfReferences || references[reference].address != address) &&
+        getWordTarget(&tables, getImageWord(image, address), address, &target) == true) {
+      status = markDisassemblyLabel(&labels, target);
+    }
+  }
+  if (status == true && labels.numOfOutside > 0) {
+    qsort(labels.outside, labels.numOfOutside, sizeof(unsigned long), compareAddresses);
+    for (item = 1, kept = 1; item < labels.numOfOutside; item++) {
+      if (labels.outside[item] != labels.outside[kept - 1]) {
+        labels.outside[kept++] = labels.outside[item];
+      }
+    }
+    labels.numOfOutside = kept;
+  }
+
+  for (item = 0; item < numOfEntries && status == true; item++) {
+    if (reserveBuffer(buffer, DISASSEMBLY_LINE_SIZE) == false) {
+      status = false;
+    } else {
+      line = buffer->data + buffer->length;
+      length = writeLineText(line, 0, ".entry ");
+      length = writeLineText(line, length, entries->items[item].name);
+      line[length++] = '\n';
+      buffer->length += (unsigned long) length;
+    }
+  }
+  /* In the order of the .ext file, so the assembler writes it the same. */
+  for (item = 0; item < numOfReferences && status == true; item++) {
+    count = names.length;
+    if (addNewLabel(&names, externals->items[item].name, 0, ATTR_EXTERNAL) == NO_SYMBOL ||
+        reserveBuffer(buffer, DISASSEMBLY_LINE_SIZE) == false) {
+      status = false;
+    } else if (names.length > count) {
+      line = buffer->data + buffer->length;
+      length = writeLineText(line, 0, ".extern ");
+      length = writeLineText(line, length, externals->items[item].name);
+      line[length++] = '\n';
+      buffer->length += (unsigned long) length;
+    }
+  }
+  /* Targets out of the image are externals that the .ext file does not name. */
+  for (item = 0; item < labels.numOfOutside && status == true; item++) {
+    if (reserveBuffer(buffer, DISASSEMBLY_LINE_SIZE) == false) {
+      status = false;
+    } else {
+      line = buffer->data + buffer->length;
+      length = writeLineText(line, 0, ".extern ");
+      length = writeLabelName(line, length, &labels, labels.outside[item]);
+      line[length++] = '\n';
+      buffer->length += (unsigned long) length;
+    }
+  }
+  if (status == false) {
+    free(labels.marks);
+    free(labels.named);
+    free(labels.outside);
+    free(references);
+    freeLabelTable(&names);
+    return false;
+  }
+
+  reference = 0;
+  for (address = IMAGE_BASE; address < end; address += count) {
+    if (reserveBuffer(buffer, DISASSEMBLY_LINE_SIZE) == false) {
+      status = false;
+      break;
+    }
+    line = buffer->data + buffer->length;
+    length = 0;
+    if (isDisassemblyLabel(&labels, address) == true) {
+      length = writeLabelName(line, length, &labels, address);
+      length = writeLineText(line, length, ": ");
+    }
+
+    if (address < codeEnd) {
+      while (reference < numOfReferences && references[reference].address < address) {
+        reference++;
+      }
+      external = reference < numOfReferences && references[reference].address == address ?
+                 references[reference].name : NULL;
+      if (writeCommandLine(line, &length, &tables, getImageWord(image, address), address, external,
+                           &labels) == false) {
+        status = false;
+      }
+      count = 4;
+    } else {
+      /* The data until the next label. */
+      for (count = 1; count < 4 * DISASSEMBLY_ROW_WORDS && address + count < end &&
+                      isDisassemblyLabel(&labels, address + count) == false; count++) {
+      }
+      if (count > 4) {
+        count -= count % 4;
+      } else if (count == 3) {
+        count = 2;
+      }
+      if (writeDataLine(line, &length, image->bytes + (address - IMAGE_BASE), count) == false) {
+        status = false;
+      }
+    }
+    line[length++] = '\n';
+    buffer->length += (unsigned long) length;
+  }
+  if (buffer->data != NULL) {
+    buffer->data[buffer->length] = '\0';
+  }
+
+  free(labels.marks);
+  free(labels.named);
+  free(labels.outside);
+  free(references);
+  freeLabelTable(&names);
+  return status;
+}
+
+/* Fill the tables of the decoding from the tables of the commands.
+ *
+ * Params:
+ * DecodingTables *tables: the tables.
+*/
+void initDecodingTables(DecodingTables *tables) {
+  int i;
+
+  for (i = 0; i < 64; i++) {
+    tables->names[i] = NULL;
+    tables->kinds[i] = stop_cmd;
+  }
+  for (i = 0; i < 32; i++) {
+    tables->rNames[0][i] = NULL;
+    tables->rNames[1][i] = NULL;
+  }
+  for (i = 0; i < 27; i++) {
+    if (opcodes[i] <= 1) {
+      tables->rNames[opcodes[i]][functs[i]] = commandsTable[i];
+    } else {
+      tables->names[opcodes[i]] = commandsTable[i];
+    }
+    tables->kinds[opcodes[i]] = sortCmd(commandsTable[i]);
+  }
+}
+
+/* Mark label at address - its bit if it is in the image, otherwise it is added to the targets out of
+ * the image (unless it is the last of them).
+ *
+ * Params:
+ * DisassemblyLabels *labels: the labels.
+ * unsigned long address: the address of the label.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean markDisassemblyLabel(DisassemblyLabels *labels, unsigned long address) {
+  unsigned long *outside, capacity;
+
+  if (address >= IMAGE_BASE && address < labels->end) {
+    labels->marks[(address - IMAGE_BASE) >> 3] |= (unsigned char) (1 << ((address - IMAGE_BASE) & 7));
+    return true;
+  }
+  if (labels->numOfOutside > 0 && labels->outside[labels->numOfOutside - 1] == address) {
+    return true;
+  }
+  if (labels->numOfOutside == labels->capacityOfOutside) {
+    capacity = labels->capacityOfOutside == 0 ? 16 : labels->capacityOfOutside * 2;
+    outside = (unsigned long *) realloc(labels->outside, capacity * sizeof(unsigned long));
+    if (outside == NULL) {
+      return false;
+    }
+    labels->outside = outside;
+    labels->capacityOfOutside = capacity;
+  }
+  labels->outside[labels->numOfOutside++] = address;
+  return true;
+}
+
+/* Check if there is label at address of the image.
+ *
+ * Params:
+ * DisassemblyLabels *labels: the labels.
+ * unsigned long address: the address (in the image).
+ *
+ * Returns:
+ * Boolean status: true if there is label at the address, otherwise - false.
+*/
+Boolean isDisassemblyLabel(DisassemblyLabels *labels, unsigned long address) {
+  return (labels->marks[(address - IMAGE_BASE) >> 3] >> ((address - IMAGE_BASE) & 7)) & 1 ? true : false;
+}
+
+/* Get the prefix of the generated names - the fewest letters L that no name of the .ent and the .ext
+ * files has before digits, so the generated names are not the same as these names.
+ *
+ * Params:
+ * ObjectSymbols *entries: the symbols of the .ent file (NULL if there is none).
+ * ObjectSymbols *externals: the references of the .ext file (NULL if there is none).
+ *
+ * Returns:
+ * int prefixLength: the number of the letters L of the prefix.
+*/
+int getPrefixLength(ObjectSymbols *entries, ObjectSymbols *externals) {
+  Boolean used[MAX_LABEL_LENGTH + 2];
+  ObjectSymbols *symbols[2];
+  unsigned long item;
+  const char *name;
+  int prefixLength, i;
+
+  symbols[0] = entries;
+  symbols[1] = externals;
+  for (prefixLength = 0; prefixLength <= MAX_LABEL_LENGTH + 1; prefixLength++) {
+    used[prefixLength] = false;
+  }
+  for (i = 0; i < 2; i++) {
+    for (item = 0; symbols[i] != NULL && item < symbols[i]->length; item++) {
+      name = symbols[i]->items[item].name;
+      for (prefixLength = 0; name[prefixLength] == 'L'; prefixLength++) {
+      }
+      if (prefixLength > 0 && name[prefixLength] != '\0' && strspn(name + prefixLength, "0123456789") ==
+                                                             strlen(name + prefixLength)) {
+        used[prefixLength] = true;
+      }
+    }
+  }
+  for (prefixLength = 1; used[prefixLength] == true; prefixLength++) {
+  }
+  return prefixLength;
+}
+
+/* Get the address that command refers to - the target of branch, or the address of J command (not
+ * register, and not stop).
+ *
+ * Params:
+ * DecodingTables *tables: the tables of the decoding.
+ * unsigned long word: the word of the command.
+ * unsigned long address: the address of the command.
+ * unsigned long *target: pointer to the address that the command refers to.
+ *
+ * Returns:
+ * Boolean status: true if the command refers to address, otherwise - false.
+*/
+Boolean getWordTarget(DecodingTables *tables, unsigned long word, unsigned long address, unsigned long *target) {
+  unsigned long opcode = (word >> 26) & 0x3F;
+
+  if (tables->names[opcode] == NULL) {
+    return false;
+  }
+  if (tables->kinds[opcode] == i_branch_cmd) {
+    *target = (address + (word & 0xFFFF) - ((word & 0x8000) ? 0x10000 : 0)) & 0xFFFFFFFFUL;
+    return true;
+  }
+  if ((tables->kinds[opcode] == j_jump_cmd || tables->kinds[opcode] == J_cmd) && (word & (1UL << 25)) == 0) {
+    *target = word & MAX_ADDRESS;
+    return true;
+  }
+  return false;
+}
+
+/* Compare two symbols by address, for sorting.
+ *
+ * Params:
+ * const void *first: pointer to the first symbol.
+ * const void *second: pointer to the second symbol.
+ *
+ * Returns:
+ * int result: negative, zero or positive like their order.
+*/
+int compareSymbolAddresses(const void *first, const void *second) {
+  return compareAddresses(&((const ObjectSymbol *) first)->address, &((const ObjectSymbol *) second)->address);
+}
+
+/* Compare two addresses, for sorting.
+ *
+ * Params:
+ * const void *first: pointer to the first address.
+ * const void *second: pointer to the second address.
+ *
+ * Returns:
+ * int result: negative, zero or positive like their order.
+*/
+int compareAddresses(const void *first, const void *second) {
+  unsigned long firstAddress = *(const unsigned long *) first;
+  unsigned long secondAddress = *(const unsigned long *) second;
+
+  if (firstAddress != secondAddress) {
+    return firstAddress < secondAddress ? -1 : 1;
+  }
+  return 0;
+}
+
+/* Write text at the end of line.
+ *
+ * Params:
+ * char *line: the line.
+ * int length: the length of the line.
+ * const char *text: the text.
+ *
+ * Returns:
+ * int length: the length of the line after the text.
+*/
+int writeLineText(char *line, int length, const char *text) {
+  while (*text != '\0') {
+    line[length++] = *text++;
+  }
+  return length;
+}
+
+/* Write decimal number at the end of line.
+ *
+ * Params:
+ * char *line: the line.
+ * int length: the length of the line.
+ * long value: the number.
+ *
+ * Returns:
+ * int length: the length of the line after the number.
+*/
+int writeLineNumber(char *line, int length, long value) {
+  char digits[12];
+  unsigned long magnitude = value < 0 ? (unsigned long) -(value + 1) + 1 : (unsigned long) value;
+  int count = 0;
+
+  if (value < 0) {
+    line[length++] = '-';
+  }
+  do {
+    digits[count++] = (char) ('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude > 0);
+  while (count > 0) {
+    line[length++] = digits[--count];
+  }
+  return length;
+}
+
+/* Write the name of the label at address at the end of line - the name of the entry at the address
+ * (by binary search) if there is one, otherwise the generated name.
+ *
+ * Params:
+ * char *line: the line.
+ * int length: the length of the line.
+ * DisassemblyLabels *labels: the labels.
+ * unsigned long address: the address of the label.
+ *
+ * Returns:
+ * int length: the length of the line after the name.
+*/
+int writeLabelName(char *line, int length, DisassemblyLabels *labels, unsigned long address) {
+  unsigned long low = 0, high = labels->numOfNamed, middle;
+  int i;
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    if (labels->named[middle].address < address) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low < labels->numOfNamed && labels->named[low].address == address) {
+    return writeLineText(line, length, labels->named[low].name);
+  }
+  for (i = 0; i < labels->prefixLength; i++) {
+    line[length++] = 'L';
+  }
+  return writeLineNumber(line, length, (long) address);
+}
+
+/* Write the command of word at the end of line, like it is written in the source.
+ *
+ * Params:
+ * char *line: the line.
+ * int *length: pointer to the length of the line.
+ * DecodingTables *tables: the tables of the decoding.
+ * unsigned long word: the word.
+ * unsigned long address: the address of the word.
+ * const char *external: the name of the external that the word refers to, or NULL.
+ * DisassemblyLabels *labels: the labels.
+ *
+ * Returns:
+ * Boolean status: true if the word is a command, otherwise - false (it is written as comment).
+*/
+Boolean writeCommandLine(char *line, int *length, DecodingTables *tables, unsigned long word,
+                         unsigned long address, const char *external, DisassemblyLabels *labels) {
+  unsigned long opcode = (word >> 26) & 0x3F, target;
+  char *name = opcode <= 1 ? tables->rNames[opcode][(word >> 6) & 0x1F] : tables->names[opcode];
+  char *rs = registerName[(word >> 21) & 0x1F], *rt = registerName[(word >> 16) & 0x1F];
+  char *rd = registerName[(word >> 11) & 0x1F];
+  long immed = (long) (word & 0xFFFF) - ((word & 0x8000) ? 0x10000L : 0);
+  int i;
+
+  if (name == NULL) {
+    *length = writeLineText(line, *length, "; not a command: ");
+    for (i = 28; i >= 0; i -= 4) {
+      line[(*length)++] = "0123456789ABCDEF"[(word >> i) & 0xF];
+    }
+    return false;
+  }
+
+  *length = writeLineText(line, *length, name);
+  switch (tables->kinds[opcode]) {
+    case r_arithmetic_cmd:
+      *length = writeLineText(line, *length, " ");
+      *length = writeLineText(line, *length, rs);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineText(line, *length, rt);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineText(line, *length, rd);
+      return true;
+    case r_move_command:
+      *length = writeLineText(line, *length, " ");
+      *length = writeLineText(line, *length, rs);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineText(line, *length, rd);
+      return true;
+    case i_arithmetic_cmd:
+      *length = writeLineText(line, *length, " ");
+      *length = writeLineText(line, *length, rs);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineNumber(line, *length, immed);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineText(line, *length, rt);
+      return true;
+    case i_branch_cmd:
+      *length = writeLineText(line, *length, " ");
+      *length = writeLineText(line, *length, rs);
+      *length = writeLineText(line, *length, ",");
+      *length = writeLineText(line, *length, rt);
+      *length = writeLineText(line, *length, ",");
+      break;
+    case j_jump_cmd:
+    case J_cmd:
+      *length = writeLineText(line, *length, " ");
+      if (word & (1UL << 25)) {
+        *length = writeLineText(line, *length, registerName[word & 0x1F]);
+        return true;
+      }
+      break;
+    default:
+      return true;
+  }
+
+  /* The label of the branch or of the J command. */
+  if (external != NULL) {
+    *length = writeLineText(line, *length, external);
+  } else {
+    getWordTarget(tables, word, address, &target);
+    *length = writeLabelName(line, *length, labels, target);
+  }
+  return true;
+}
+
+/* Write data at the end of line - words as .dw, two bytes as .dh, one byte as .db.
+ *
+ * Params:
+ * char *line: the line.
+ * int *length: pointer to the length of the line.
+ * unsigned char *bytes: the bytes of the data.
+ * unsigned long count: the number of the bytes (multiple of 4, 2 or 1).
+ *
+ * Returns:
+ * Boolean status: true if the directive can hold the data, otherwise - false (the values that
+ * .dh and .db do not accept: 32767 and 127).
+*/
+Boolean writeDataLine(char *line, int *length, unsigned char *bytes, unsigned long count) {
+  unsigned long offset, value;
+
+  if (count == 1) {
+    *length = writeLineText(line, *length, ".db ");
+    *length = writeLineNumber(line, *length, (long) bytes[0] - ((bytes[0] & 0x80) ? 0x100 : 0));
+    return bytes[0] == 0x7F ? false : true;
+  }
+  if (count == 2) {
+    value = (unsigned long) bytes[0] | ((unsigned long) bytes[1] << 8);
+    *length = writeLineText(line, *length, ".dh ");
+    *length = writeLineNumber(line, *length, (long) value - ((value & 0x8000) ? 0x10000L : 0));
+    return value == 0x7FFF ? false : true;
+  }
+
+  *length = writeLineText(line, *length, ".dw ");
+  for (offset = 0; offset < count; offset += 4) {
+    value = (unsigned long) bytes[offset] | ((unsigned long) bytes[offset + 1] << 8) |
+            ((unsigned long) bytes[offset + 2] << 16) | ((unsigned long) bytes[offset + 3] << 24);
+    if (offset > 0) {
+      line[(*length)++] = ',';
+    }
+    *length = writeLineNumber(line, *length, (value & 0x80000000UL) ? -(long) (0xFFFFFFFFUL - value) - 1 : (long) value);
+  }
+  return true;
+}
@@ -0,0 +1,28 @@
+#ifndef MAMAN14_DISASSEMBLY_H
+#define MAMAN14_DISASSEMBLY_H
+
+#include "Datatypes.h"
+#include "files.h"
+#include "validation.h"
+#include "objectFile.h"
+
+/*
+ * Disassembly of the image of .ob file back into source of the assembler. Every word of the code is
+ * decoded by the tables of the commands (the opcodes and the functs of constants.c) into one command,
+ * and the data is written as .dw, .dh and .db lines. The targets of the branches and of the J commands
+ * get labels - the names of the .ent file, or generated names of L and the address (LL, LLL... if the
+ * .ent or the .ext file has such name) - and the references of the .ext file get the names of their
+ * externals, so assembling the disassembly gives the same .ob and .ext files again, and .ent file of
+ * the same lines (in the order that the labels are defined, all the data after the code).
+ */
+
+/* The most words of data on one line of the disassembly (the line of the source has at most 80
+ * characters, with label of 31 characters). */
+#define DISASSEMBLY_ROW_WORDS 3
+
+/* The size of the storage of one line of the disassembly. */
+#define DISASSEMBLY_LINE_SIZE 128
+
+Boolean disassembleImage(Buffer *buffer, ObjectImage *image, ObjectSymbols *entries, ObjectSymbols *externals);
+
+#endif
@@ -0,0 +1,197 @@
+#include "diskFiles.h"
+
+/*
+ * Write the content of one output file, or remove the file if there is nothing to write in it.
+ *
+ * Params:
+ * char *filename: the name of the input file.
+ * char *ext: the extension of the output file.
+ * Buffer *buffer: the content of the output file.
+ * Boolean exists: true if the output file should exist.
+ * Boolean onlyChanged: true to keep the file untouched when its content is the same.
+ */
+void saveOutputFile(char *filename, char *ext, Buffer *buffer, Boolean exists, Boolean onlyChanged) {
+  char *name = changeFileName(filename, ext);
+  unsigned long length;
+  char *content;
+  FILE *fp;
+
+  if (exists == false) {
+    remove(name);
+    free(name);
+    return;
+  }
+
+  if (onlyChanged == true) {
+    content = readFileContent(name, &length);
+    if (content != NULL && length == buffer->length && memcmp(content, buffer->data, length) == 0) {
+      free(content);
+      free(name);
+      return;
+    }
+    free(content);
+  }
+
+  fp = fopen(name, "wb");
+  if (fp == NULL) {
+    printf("Cannot open file %s \n", name);
+    free(name);
+    return;
+  }
+  fwrite(buffer->data, 1, buffer->length, fp);
+  fclose(fp);
+  free(name);
+}
+
+/*
+ * Write all the output files of the input file. The .ent, .ext files are created only when they have content.
+ *
+ * Params:
+ * char *filename: the name of the input file.
+ * Outputs *outputs: the contents of the output files.
+ * Boolean onlyChanged: true to write only the files whose content changed.
+ */
+void saveOutputs(char *filename, Outputs *outputs, Boolean onlyChanged) {
+  saveOutputFile(filename, ".ob", &outputs->object, outputs->hasObject, onlyChanged);
+  saveOutputFile(filename, ".ent", &outputs->entries, outputs->hasEntries, onlyChanged);
+  saveOutputFile(filename, ".ext", &outputs->externals, outputs->hasExternals, onlyChanged);
+  if (outputs->hasSymbols == true) {
+    saveOutputFile(filename, ".sym", &outputs->symbols, true, onlyChanged);
+  }
+  if (outputs->hasReport == true) {
+    saveOutputFile(filename, ".json", &outputs->report, true, onlyChanged);
+  }
+  if (outputs->hasListing == true) {
+    saveOutputFile(filename, ".lst", &outputs->listing, true, onlyChanged);
+  }
+  if (outputs->hasDebug == true) {
+    saveOutputFile(filename, ".dbg", &outputs->debug, true, onlyChanged);
+  }
+}
+
+/*
+ * Replaces the end of the function name in the 'ext' string.
+ *
+ * Params:
+ * char *name: the name of the file.
+ * char *ext: the file extension.
+ *
+ * Return:
+ * char *filname - the new name of the file.
+ */
+char *changeFileName(char *name, char *ext) {
+  size_t fileNameLen = strlen(name) - 3 + strlen(ext);
+  char *fileName = (char *) calloc(fileNameLen + 1, sizeof(char));
+  if (name == NULL) {
+    printf("Error: Allocation Error! \n");
+    return NULL;
+  }
+  fileName = strncpy(fileName, name, strlen(name) - 3);
+  fileName[strlen(name) - 3] = '\0';
+  strcat(fileName, ext);
+  return fileName;
+}
+
+/* Make sure the extension of filename is ".as".
+ *
+ * Params:
+ * char *filename: file name.
+ *
+ * Returns:
+ * Boolean isAsFile: true if file from type of as, otherwise - return false.
+*/
+Boolean isAsFile(char *filename){
+  size_t length = strlen(filename);
+  const char *extension = &filename[length - 3];
+
+  if(strcmp(extension, ".as") == 0){
+    return true;
+  }
+  return false;
+}
+
+/* Read the whole content of file into dynamic memory.
+ *
+ * Params:
+ * char *name: the name of the file.
+ * unsigned long *length: pointer to store the number of bytes read.
+ *
+ * Returns:
+ * char *content: the content of the file (ends with extra '\0'), or NULL if file cannot be read.
+*/
+char *readFileContent(char *name, unsigned long *length) {
+  FILE *fp = fopen(name, "rb");
+  char *content;
+
+  *length = 0;
+  if (fp == NULL) {
+    return NULL;
+  }
+  content = readStreamContent(fp, length);
+  fclose(fp);
+  return content;
+}
+
+/* Read the rest of open stream into dynamic memory.
+ *
+ * Params:
+ * FILE *fp: the stream (already open).
+ * unsigned long *length: pointer to store the number of bytes read.
+ *
+ * Returns:
+ * char *content: the content of the stream (ends with extra '\0'), or NULL if there is no memory.
+*/
+char *readStreamContent(FILE *fp, unsigned long *length) {
+  unsigned long capacity = 4096, read;
+  char *content, *bigger;
+
+  *length = 0;
+  content = (char *) malloc(capacity + 1);
+  while (content != NULL && (read = fread(content + *length, 1, capacity - *length, fp)) > 0) {
+    *length += read;
+    if (*length == capacity) {
+      capacity *= 2;
+      bigger = (char *) realloc(content, capacity + 1);
+      if (bigger == NULL) {
+        free(content);
+      }
+      content = bigger;
+    }
+  }
+
+  if (content == NULL) {
+    printf("Error: Allocation Error! \n");
+    return NULL;
+  }
+  content[*length] = '\0';
+  return content;
+}
+
+/* Read the .ent or .ext file of .ob file, if it exists (the assembler does not write empty files).
+ *
+ * Params:
+ * ObjectSymbols *symbols: pointer to the symbols of the file.
+ * char *name: the name of the .ob file.
+ * char *ext: the extension of the file.
+ *
+ * Returns:
+ * Boolean status: true if the file is valid or does not exist, otherwise - false.
+*/
+Boolean readSymbolsFile(ObjectSymbols *symbols, char *name, char *ext) {
+  char *filename = changeFileName(name, ext);
+  unsigned long length;
+  char *content;
+  Boolean status = true;
+
+  if (filename == NULL) {
+    return false;
+  }
+  content = readFileContent(filename, &length);
+  if (content != NULL && loadObjectSymbols(symbols, content, length) == false) {
+    fprintf(stderr, "Error! %s is not a valid %s file \n", filename, ext + 1);
+    status = false;
+  }
+  free(content);
+  free(filename);
+  return status;
+}
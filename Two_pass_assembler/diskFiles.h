@@ -0,0 +1,22 @@
+#ifndef MAMAN14_DISKFILES_H
+#define MAMAN14_DISKFILES_H
+
+#include "Datatypes.h"
+#include "files.h"
+#include "objectFile.h"
+
+void saveOutputFile(char *filename, char *ext, Buffer *buffer, Boolean exists, Boolean onlyChanged);
+
+void saveOutputs(char *filename, Outputs *outputs, Boolean onlyChanged);
+
+char *changeFileName(char* name, char *ext);
+
+Boolean isAsFile(char *filename);
+
+char *readFileContent(char *name, unsigned long *length);
+
+char *readStreamContent(FILE *fp, unsigned long *length);
+
+Boolean readSymbolsFile(ObjectSymbols *symbols, char *name, char *ext);
+
+#endif
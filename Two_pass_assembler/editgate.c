@@ -0,0 +1,399 @@
+#include <ctype.h>
+#include "libassembler.h"
+#include "incremental.h"
+#include "generator.h"
+
+#define DEFAULT_LINES 1000
+#define DEFAULT_EDITS 500
+#define MAX_EDIT_LINES 4
+#define NUM_OF_SPECIAL_LINES 12
+/* The source is loaded again every so many edits, so the errors of the edits do not pile up. */
+#define RELOAD_EDITS 16
+
+/* Lines that the generator does not write - errors, and labels that are defined twice or are also extern. */
+char *specialLines[NUM_OF_SPECIAL_LINES] = {
+    "\n", "; comment\n", "L1: stop\n", ".extern L2\n", ".entry X0\n", ".entry NOWHERE\n", "jmp NOWHERE\n",
+    "bne $1, $2, L3\n", "add $1,,$2\n", "L9999: .asciz \"ab\"\n", "X1: .db 1\n", "la L9999\n"
+};
+
+/* Data structure representing the source as the gate edits it - its lines, each one with its '\n'. */
+typedef struct editedSource {
+    char **lines;
+    int numOfLines;
+    int capacity;
+} EditedSource;
+
+unsigned long nextEditRandom(unsigned long *random, unsigned long range);
+
+Boolean splitEditedLines(const char *data, unsigned long length, EditedSource *source);
+
+Boolean editEditedLines(EditedSource *source, int first, int count, char **lines, int numOfLines);
+
+void joinEditedLines(EditedSource *source, Buffer *text);
+
+Boolean compareResults(AssemblerContext *incremental, AssemblerStatus incrementalStatus, AssemblerContext *whole,
+                       AssemblerStatus wholeStatus, unsigned long edit);
+
+void freeEditedLines(EditedSource *source);
+
+char *skipLabel(char *line);
+
+Boolean definesLabel(char *line);
+
+/*
+ * Incremental reassembly gate: make random edits to generated source - insert, remove and replace lines -
+ * and after every edit check that reassembleSource gives the same status, errors and outputs (with the
+ * symbols) as assembleSource of the whole edited source. Half of the edits keep the source valid: they
+ * do not remove the lines that define labels, and their new lines are lines of the source without their
+ * labels. The other half bring lines of other generated source and lines with errors. The edits are given
+ * by replaceSourceLines and by loadIncrementalSource of the whole text, one after the other, and the
+ * generated source is loaded again every RELOAD_EDITS edits. The same seed always makes the same edits.
+ *
+ * Usage: editgate [--seed=N] [--lines=N] [--edits=N]
+ */
+int main(int args, char *argv[]) {
+  unsigned long seed = 1, numOfLines = DEFAULT_LINES, numOfEdits = DEFAULT_EDITS, random, edit, withErrors = 0;
+  IncrementalSource incremental;
+  AssemblerContext whole;
+  AssemblerStatus incrementalStatus, wholeStatus;
+  GeneratorMix mix;
+  EditedSource source, own, pool;
+  Buffer original, text, replacement;
+  char *lines[MAX_EDIT_LINES];
+  Boolean valid;
+  int first, count, numOfNewLines, i, failures = 0;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+    } else if (strncmp(argv[i], "--lines=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfLines = strtoul(argv[i] + 8, NULL, 10);
+    } else if (strncmp(argv[i], "--edits=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfEdits = strtoul(argv[i] + 8, NULL, 10);
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  /* The lines of other source (generated with other seed) also refer to labels that the source does not
+   * define, or define labels again. */
+  initGeneratorMix(&mix);
+  initBuffer(&original);
+  initBuffer(&text);
+  initBuffer(&replacement);
+  memset(&source, 0, sizeof(source));
+  memset(&own, 0, sizeof(own));
+  memset(&pool, 0, sizeof(pool));
+  if (generateSource(&original, seed, numOfLines, &mix) == false ||
+      splitEditedLines(original.data, original.length, &own) == false ||
+      generateSource(&text, seed + 1, numOfLines, &mix) == false ||
+      splitEditedLines(text.data, text.length, &pool) == false) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+
+  initIncrementalSource(&incremental);
+  initAssemblerContext(&whole);
+  incremental.context.sym = true;
+  whole.sym = true;
+
+  random = seed;
+  for (edit = 0; edit <= numOfEdits && failures == 0; edit++) {
+    if (edit % RELOAD_EDITS == 0) {
+      freeEditedLines(&source);
+      memset(&source, 0, sizeof(source));
+      if (splitEditedLines(original.data, original.length, &source) == false) {
+        printf("Error: Allocation Error! \n");
+        exit(1);
+      }
+      joinEditedLines(&source, &text);
+      loadIncrementalSource(&incremental, text.data, text.length);
+    } else {
+      valid = nextEditRandom(&random, 2) == 0 ? true : false;
+      first = (int) nextEditRandom(&random, (unsigned long) source.numOfLines + 1);
+      count = (int) nextEditRandom(&random, MAX_EDIT_LINES);
+      if (first + count > source.numOfLines) {
+        count = source.numOfLines - first;
+      }
+      for (i = first; valid == true && i < first + count; i++) {
+        if (definesLabel(source.lines[i]) == true) {
+          count = 0;
+        }
+      }
+      numOfNewLines = (int) nextEditRandom(&random, MAX_EDIT_LINES);
+      resetBuffer(&replacement);
+      for (i = 0; i < numOfNewLines; i++) {
+        if (valid == true) {
+          lines[i] = skipLabel(own.lines[nextEditRandom(&random, (unsigned long) own.numOfLines)]);
+          if (definesLabel(lines[i]) == true) {
+            lines[i] = specialLines[0];
+          }
+        } else if (nextEditRandom(&random, 4) == 0) {
+          lines[i] = specialLines[nextEditRandom(&random, NUM_OF_SPECIAL_LINES)];
+        } else {
+          lines[i] = pool.lines[nextEditRandom(&random, (unsigned long) pool.numOfLines)];
+        }
+        appendBuffer(&replacement, lines[i], strlen(lines[i]));
+      }
+      if (editEditedLines(&source, first, count, lines, numOfNewLines) == false) {
+        printf("Error: Allocation Error! \n");
+        exit(1);
+      }
+      joinEditedLines(&source, &text);
+      if (edit % 2 == 0) {
+        loadIncrementalSource(&incremental, text.data, text.length);
+      } else {
+        replaceSourceLines(&incremental, first, count, replacement.data, replacement.length);
+      }
+    }
+
+    incrementalStatus = reassembleSource(&incremental);
+    wholeStatus = assembleSource(&whole, text.data, text.length);
+    if (compareResults(&incremental.context, incrementalStatus, &whole, wholeStatus, edit) == false) {
+      failures++;
+    }
+    if (wholeStatus != assembled) {
+      withErrors++;
+    }
+  }
+
+  if (failures > 0) {
+    printf("Error! the incremental reassembly differs from the assembly of the whole source. \n");
+  } else {
+    printf("%lu edits of %lu lines (seed %lu, %lu of them with errors): the incremental reassembly is the same "
+           "as the assembly of the whole source \n", numOfEdits, numOfLines, seed, withErrors);
+  }
+
+  freeIncrementalSource(&incremental);
+  freeAssemblerContext(&whole);
+  freeEditedLines(&source);
+  freeEditedLines(&own);
+  freeEditedLines(&pool);
+  freeBuffer(&original);
+  freeBuffer(&text);
+  freeBuffer(&replacement);
+  return failures > 0 ? 1 : 0;
+}
+
+/* Get the next random number of the edits (linear congruential generator of 31 bits, like the generator).
+ *
+ * Params:
+ * unsigned long *random: the state of the generator.
+ * unsigned long range: the number of the possible results.
+ *
+ * Returns:
+ * unsigned long number: number from 0 to range - 1.
+*/
+unsigned long nextEditRandom(unsigned long *random, unsigned long range) {
+  *random = (*random * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+  return (*random >> 8) % range;
+}
+
+/* Split text into the lines of the edited source.
+ *
+ * Params:
+ * const char *data: the text.
+ * unsigned long length: the length of the text.
+ * EditedSource *source: the source to fill (empty).
+ *
+ * Returns:
+ * Boolean status: true if the lines were split, false if there is no memory.
+*/
+Boolean splitEditedLines(const char *data, unsigned long length, EditedSource *source) {
+  unsigned long position = 0, end;
+  char *line;
+
+  while (position < length) {
+    for (end = position; end < length && data[end] != '\n'; end++) {
+    }
+    line = (char *) malloc(end - position + 2);
+    if (line == NULL) {
+      return false;
+    }
+    memcpy(line, data + position, end - position);
+    strcpy(line + (end - position), "\n");
+    if (editEditedLines(source, source->numOfLines, 0, &line, 1) == false) {
+      free(line);
+      return false;
+    }
+    free(line);
+    position = end + 1;
+  }
+  return true;
+}
+
+/* Replace lines of the edited source by copies of new lines, like replaceSourceLines.
+ *
+ * Params:
+ * EditedSource *source: the source.
+ * int first: the index of the first line to replace.
+ * int count: the number of lines to replace.
+ * char **lines: the new lines, each one with its '\n'.
+ * int numOfLines: the number of new lines.
+ *
+ * Returns:
+ * Boolean status: true if the lines were replaced, false if there is no memory.
+*/
+Boolean editEditedLines(EditedSource *source, int first, int count, char **lines, int numOfLines) {
+  char **grown;
+  int i;
+
+  if (source->numOfLines - count + numOfLines > source->capacity) {
+    grown = (char **) realloc(source->lines, (source->capacity * 2 + numOfLines) * sizeof(char *));
+    if (grown == NULL) {
+      return false;
+    }
+    source->lines = grown;
+    source->capacity = source->capacity * 2 + numOfLines;
+  }
+
+  for (i = first; i < first + count; i++) {
+    free(source->lines[i]);
+  }
+  memmove(source->lines + first + numOfLines, source->lines + first + count,
+          (source->numOfLines - first - count) * sizeof(char *));
+  source->numOfLines += numOfLines - count;
+  for (i = 0; i < numOfLines; i++) {
+    source->lines[first + i] = (char *) malloc(strlen(lines[i]) + 1);
+    if (source->lines[first + i] == NULL) {
+      return false;
+    }
+    strcpy(source->lines[first + i], lines[i]);
+  }
+  return true;
+}
+
+/* Join the lines of the edited source into its text.
+ *
+ * Params:
+ * EditedSource *source: the source.
+ * Buffer *text: the buffer for the text.
+*/
+void joinEditedLines(EditedSource *source, Buffer *text) {
+  int i;
+
+  resetBuffer(text);
+  for (i = 0; i < source->numOfLines; i++) {
+    appendBuffer(text, source->lines[i], strlen(source->lines[i]));
+  }
+}
+
+/* Compare the status, the errors and the outputs of the incremental reassembly with the assembly of the
+ * whole source, and print the first difference.
+ *
+ * Params:
+ * AssemblerContext *incremental: the context of the incremental source.
+ * AssemblerStatus incrementalStatus: the status of the incremental reassembly.
+ * AssemblerContext *whole: the context that assembled the whole source.
+ * AssemblerStatus wholeStatus: the status of the assembly of the whole source.
+ * unsigned long edit: the number of the edit, for the messages.
+ *
+ * Returns:
+ * Boolean status: true if they are the same, otherwise - false.
+*/
+Boolean compareResults(AssemblerContext *incremental, AssemblerStatus incrementalStatus, AssemblerContext *whole,
+                       AssemblerStatus wholeStatus, unsigned long edit) {
+  Buffer *incrementalOutputs[4], *wholeOutputs[4];
+  char *names[4] = {"object", "entries", "externals", "symbols"};
+  char *incrementalErrors, *wholeErrors;
+  unsigned long incrementalLength, wholeLength;
+  Boolean status = true;
+  int i;
+
+  if (incrementalStatus != wholeStatus) {
+    printf("Edit %lu: the status is %d, but %d when the whole source is assembled. \n", edit,
+           (int) incrementalStatus, (int) wholeStatus);
+    return false;
+  }
+
+  incrementalErrors = formatErrors(incremental->errors, &incrementalLength);
+  wholeErrors = formatErrors(whole->errors, &wholeLength);
+  if (incrementalLength != wholeLength || memcmp(incrementalErrors, wholeErrors, wholeLength) != 0) {
+    printf("Edit %lu: the errors differ from the errors of the whole source: \n%.*s--- whole source: \n%.*s", edit,
+           (int) incrementalLength, incrementalErrors, (int) wholeLength, wholeErrors);
+    status = false;
+  }
+  free(incrementalErrors);
+  free(wholeErrors);
+  if (status == false || wholeStatus != assembled) {
+    return status;
+  }
+
+  incrementalOutputs[0] = &incremental->outputs.object;
+  incrementalOutputs[1] = &incremental->outputs.entries;
+  incrementalOutputs[2] = &incremental->outputs.externals;
+  incrementalOutputs[3] = &incremental->outputs.symbols;
+  wholeOutputs[0] = &whole->outputs.object;
+  wholeOutputs[1] = &whole->outputs.entries;
+  wholeOutputs[2] = &whole->outputs.externals;
+  wholeOutputs[3] = &whole->outputs.symbols;
+  for (i = 0; i < 4; i++) {
+    if (incrementalOutputs[i]->length != wholeOutputs[i]->length ||
+        (wholeOutputs[i]->length > 0 &&
+         memcmp(incrementalOutputs[i]->data, wholeOutputs[i]->data, wholeOutputs[i]->length) != 0)) {
+      printf("Edit %lu: the %s output differs from the output of the whole source. \n", edit, names[i]);
+      status = false;
+    }
+  }
+  if (incremental->outputs.hasEntries != whole->outputs.hasEntries ||
+      incremental->outputs.hasExternals != whole->outputs.hasExternals) {
+    printf("Edit %lu: the entries or the externals file is missing. \n", edit);
+    status = false;
+  }
+  return status;
+}
+
+/* Free the lines of edited source.
+ *
+ * Params:
+ * EditedSource *source: the source.
+*/
+void freeEditedLines(EditedSource *source) {
+  int i;
+
+  for (i = 0; i < source->numOfLines; i++) {
+    free(source->lines[i]);
+  }
+  free(source->lines);
+}
+
+/* Skip the label of generated line ("L<number>: ").
+ *
+ * Params:
+ * char *line: the line.
+ *
+ * Returns:
+ * char *rest: the line after its label, or the line itself if it has no label.
+*/
+char *skipLabel(char *line) {
+  char *end = line + 1;
+
+  if (line[0] != 'L' || !isdigit((unsigned char) line[1])) {
+    return line;
+  }
+  while (isdigit((unsigned char) *end)) {
+    end++;
+  }
+  if (*end != ':') {
+    return line;
+  }
+  for (end++; *end == ' '; end++) {
+  }
+  return end;
+}
+
+/* Check if generated line defines label - by label of its own, or by .extern (and .entry needs the label).
+ *
+ * Params:
+ * char *line: the line.
+ *
+ * Returns:
+ * Boolean status: true if the line defines label, otherwise - false.
+*/
+Boolean definesLabel(char *line) {
+  if (strncmp(line, ".entry", 6) == 0 || strncmp(line, ".extern", 7) == 0 || skipLabel(line) != line) {
+    return true;
+  }
+  return false;
+}
@@ -2,25 +2,31 @@
 
 /*
  * Encoded R Format bit field of Command node in linked list.
+ * The encoders of pass 2 do not allocate: the line is split on the stack, and the bits are kept in
+ * the command itself.
  *
  * Params:
  * Command *command: command node.
 */
 void encodeRCmd(Command *command) {
-  char *str, *param, *iterator;
+  char storage[LINE_PARTS_SIZE];
+  char *param, *iterator;
   RCommand *bits;
   int rs = 0, rt = 0, rd = 0;
+  int opcode, funct;
+  LineParts lineParts;
 
   /* Get param and commandName from Whole command. */
-  LineParts *lineParts = getCommandParts(command->line);
+  if (splitCommandParts(command->line, &lineParts, storage, sizeof(storage)) == false) {
+    return;
+  }
 
   /* Get Opcode and Funct by commandName. */
-  int opcode = getOpcodeByCommand(lineParts->cmdName);
-  int funct = getFunctByCommand(lineParts->cmdName);
+  opcode = getOpcodeByCommand(lineParts.cmdName);
+  funct = getFunctByCommand(lineParts.cmdName);
 
   /* Separate each register and convert it to integer number */
-  iterator = duplicateStr(lineParts->params);
-  str = iterator;
+  iterator = lineParts.params;
   param = trimStr(myStrsep(&iterator, ","));
 
   /* Check if it an arithmetic command or copy command */
@@ -37,7 +43,7 @@ void encodeRCmd(Command *command) {
   }
 
   /* Encode command bits. */
-  bits = (RCommand *) calloc(1, sizeof(RCommand));
+  bits = &command->encoding.r;
   bits->opcode = opcode;
   bits->funct = funct;
   bits->unused = 0;
@@ -45,9 +51,6 @@ void encodeRCmd(Command *command) {
   bits->rt = rt;
   bits->rd = rd;
   command->bits = bits;
-
-  free(str);
-  freeLinePart(lineParts);
 }
 
 /*
@@ -55,41 +58,42 @@ void encodeRCmd(Command *command) {
  *
  * Params:
  * Command *command: command node.
- * Labels *labels: labels linked list.
+ * LabelTable *labels: labels table.
 */
-void encodeICmd(Command *command, Label *labels) {
-  char *iterator, *param, *str;
+void encodeICmd(Command *command, LabelTable *labels) {
+  char storage[LINE_PARTS_SIZE];
+  char *iterator, *param;
   int rs, rt;
   long immed;
   long targetAddress;
+  int opcode;
+  LineParts lineParts;
+  ICommand *bits;
+  char *conditionJmpCmd[4] = {"beq", "bne", "blt", "bgt"};
 
   /* Get param and commandName from Whole command. */
-  LineParts *lineParts = getCommandParts(command->line);
-  char *conditionJmpCmd[4] = {"beq", "bne", "blt", "bgt"};
+  if (splitCommandParts(command->line, &lineParts, storage, sizeof(storage)) == false) {
+    return;
+  }
 
   /* Get Opcode by commandName. */
-  int opcode = getOpcodeByCommand(lineParts->cmdName);
-
-  /* Encode command bits. */
-  ICommand *bits = (ICommand *) calloc(1, sizeof(ICommand));
-  bits->opcode = opcode;
+  opcode = getOpcodeByCommand(lineParts.cmdName);
 
   /* Separate each param and convert it to number */
-  iterator = duplicateStr(lineParts->params);
-  str = iterator;
+  iterator = lineParts.params;
   param = trimStr(myStrsep(&iterator, ","));
 
   rs = getRegisterIndexFromParam(param);
 
-  if (isCommandInArray(4, conditionJmpCmd, lineParts->cmdName) == true) {
+  if (isCommandInArray(4, conditionJmpCmd, lineParts.cmdName) == true) {
     param = trimStr(myStrsep(&iterator, ","));
     rt = getRegisterIndexFromParam(param);
     iterator = trimStr(iterator);
-    if (getLabelAddress(labels, iterator) == -1) {
-      printf("Labels doesnt exists! \n");
+    command->operand = findLabel(labels, iterator);
+    if (command->operand == NO_SYMBOL) {
       return;
     }
-    targetAddress = getLabelAddress(labels, iterator);
+    targetAddress = labels->items[command->operand].value;
     if (targetAddress - command->address < 0) {
       immed = (long) (command->address - targetAddress);
     } else {
@@ -102,12 +106,13 @@ void encodeICmd(Command *command, Label *labels) {
     rt = getRegisterIndexFromParam(iterator);
   }
 
+  /* Encode command bits. */
+  bits = &command->encoding.i;
+  bits->opcode = opcode;
   bits->rs = rs;
   bits->rt = rt;
   bits->immed = immed;
   command->bits = bits;
-  free(str);
-  freeLinePart(lineParts);
 }
 
 /*
@@ -115,18 +120,23 @@ void encodeICmd(Command *command, Label *labels) {
  *
  * Params:
  * Command *command: command node.
- * Labels *labels: labels linked list.
+ * LabelTable *labels: labels table.
 */
-void encodeJCmd(Command *command, Label *labels) {
+void encodeJCmd(Command *command, LabelTable *labels) {
+  char storage[LINE_PARTS_SIZE];
   int reg = 0;
   long address = 0;
   int opcode;
-  LineParts *lineParts = getCommandParts(command->line);
-  /* Get param and commandName from Whole command. */
-  char *params = lineParts->params;
-  char *cmdName = lineParts->cmdName;
+  LineParts lineParts;
+  char *params, *cmdName;
+  JCommand *bits;
 
-  JCommand *bits = (JCommand *) calloc(1, sizeof(JCommand));
+  /* Get param and commandName from Whole command. */
+  if (splitCommandParts(command->line, &lineParts, storage, sizeof(storage)) == false) {
+    return;
+  }
+  params = lineParts.params;
+  cmdName = lineParts.cmdName;
 
   if (strcmp(cmdName, "stop") == 0) {
     opcode = getOpcodeByCommand(cmdName);
@@ -137,51 +147,79 @@ void encodeJCmd(Command *command, Label *labels) {
       address = getRegisterIndexFromParam(params);
       reg = 1;
     } else {
-      if (getLabelAddress(labels, params) == -1) {
-        printf("Label does not exists! \n");
+      command->operand = findLabel(labels, params);
+      if (command->operand == NO_SYMBOL) {
         return;
       } else {
-        address = getLabelAddress(labels, params);
+        address = labels->items[command->operand].value;
       }
     }
   }
 
+  bits = &command->encoding.j;
   bits->opcode = opcode;
   bits->reg = reg;
   bits->address = address;
   command->bits = bits;
-  freeLinePart(lineParts);
 }
 
-/* Search label by its name in labels array and return its address.
+/* Check that the encoded command can hold the label that it refers to - the address of J command
+ * is 25 bits, and the distance of branch is 16 bits signed immediate.
+ *
+ * Params:
+ * Command *command: encoded command node.
+ * LabelTable *labels: labels table.
+ *
+ * Returns:
+ * ErrorType error: valid, or the field that the label does not fit.
+*/
+ErrorType checkCommandRange(Command *command, LabelTable *labels) {
+  unsigned long value;
+  long distance;
+
+  if (command->operand == NO_SYMBOL) {
+    return valid;
+  }
+  value = labels->items[command->operand].value;
+  if (command->type == j_cmd && value > MAX_ADDRESS) {
+    return address_out_of_range;
+  }
+  if (command->type == i_cmd && (labels->items[command->operand].attr & ATTR_EXTERNAL) == 0) {
+    distance = (long) value - (long) command->address;
+    if (distance > MAX_BRANCH_DISTANCE || distance < MIN_BRANCH_DISTANCE) {
+      return branch_out_of_range;
+    }
+  }
+  return valid;
+}
+
+/* Search label by its name in labels table and return its address.
  * if label not found - return -1.
  *
  * Params:
- * Label *labels: labels linked list.
+ * LabelTable *labels: labels table.
  * char *labelName: the name of the label to search.
  *
  * Returns:
  * long labelAddress: the address of the label (if founds)
 */
-long getLabelAddress(Label *labels, char *labelName) {
-  Label *lastLabel = labels;
-  while (lastLabel != NULL) {
-    if (strcmp(labelName, lastLabel->symbol) == 0) {
-      return lastLabel->value;
-    }
-    lastLabel = lastLabel->next;
+long getLabelAddress(LabelTable *labels, char *labelName) {
+  SymbolId id = findLabel(labels, labelName);
+  if (id == NO_SYMBOL) {
+    return -1;
   }
-  return -1;
+  return labels->items[id].value;
 }
 
 /* Insert data nodes to data picture.
  *
  * Params:
  * DataItem **dataPicture: linked list of all data items.
+ * DataItem **lastDataItem: pointer to the last node of dataPicture (NULL if it is empty), it is updated.
  * char *orderLine: the line of the order.
  * unsigned long address: the address of the next node in dataPicture.
 */
-void encodeOrder(DataItem **dataPicture, char *orderLine, unsigned long *address) {
+void encodeOrder(DataItem **dataPicture, DataItem **lastDataItem, char *orderLine, unsigned long *address) {
   char *str, *param, *iterator;
   LineParts *lineParts = getCommandParts(orderLine);
   char *params = lineParts->params ;
@@ -192,7 +230,7 @@ void encodeOrder(DataItem **dataPicture, char *orderLine, unsigned long *address
 
   if (item == NULL) {
     freeLinePart(lineParts);
-    printf("Error: Allocation Error! \n");
+    return;
   }
 
   if (itemType == -1) {
@@ -208,7 +246,7 @@ void encodeOrder(DataItem **dataPicture, char *orderLine, unsigned long *address
     param = trimStr(param);
     item->value = atol(param);
     currentItem = initNewDataItem(atol(param), *address, itemType);
-    addNewDataItem(dataPicture, currentItem);
+    addNewDataItem(dataPicture, lastDataItem, currentItem);
     (*address) += itemType;
   }
   free(str);
@@ -221,19 +259,31 @@ void encodeOrder(DataItem **dataPicture, char *orderLine, unsigned long *address
  *
  * Params:
  * DataItem **dataPicture: linked list of all data items.
+ * DataItem **lastDataItem: pointer to the last node of dataPicture (NULL if it is empty), it is updated.
  * char *orderLine: the line of the order.
  * unsigned long address: the address of the next node in dataPicture.
 */
-void encodeAscizOrder(DataItem **dataPicture, char *orderLine, unsigned long *address) {
+void encodeAscizOrder(DataItem **dataPicture, DataItem **lastDataItem, char *orderLine, unsigned long *address) {
   int i = 0;
   LineParts *lineParts = getCommandParts(orderLine);
   char *params = lineParts->params;
-  char *stringToEncode = (char *) calloc(strlen(params) - 1, sizeof(char));
-  Data *item = (Data *) calloc(1, sizeof(Data));
+  char *stringToEncode;
+  Data *item;
   DataItem *currentItem = NULL;
 
+  /* No quotation marks - the validation reports it. */
+  if (params == NULL || strlen(params) < 2) {
+    freeLinePart(lineParts);
+    return;
+  }
+  stringToEncode = (char *) calloc(strlen(params) - 1, sizeof(char));
+  item = (Data *) calloc(1, sizeof(Data));
+
   if (stringToEncode == NULL || item == NULL) {
-    printf("Error: Allocation Error! \n");
+    free(stringToEncode);
+    free(item);
+    freeLinePart(lineParts);
+    return;
   }
 
   memcpy(stringToEncode, &params[1], strlen(params) - 2);
@@ -241,10 +291,37 @@ void encodeAscizOrder(DataItem **dataPicture, char *orderLine, unsigned long *ad
 
   for (i = 0; i <= strlen(stringToEncode); i++) {
     currentItem = initNewDataItem((long) stringToEncode[i], *address, byte);
-    addNewDataItem(dataPicture, currentItem);
+    addNewDataItem(dataPicture, lastDataItem, currentItem);
     (*address) += 1;
   }
   free(stringToEncode);
   free(item);
   freeLinePart(lineParts);
-}
\ No newline at end of file
+}
+
+/* Get the bytes that order adds to the data image, like encodeOrder and encodeAscizOrder add them,
+ * without building its items (for the check of the source without its images).
+ *
+ * Params:
+ * char *cmdName: the name of the order.
+ * char *params: the parameters of the order (NULL if it has none).
+ *
+ * Returns:
+ * unsigned long size: the number of bytes.
+*/
+unsigned long getOrderSize(char *cmdName, char *params) {
+  DataSize itemType;
+
+  if (params == NULL) {
+    return 0;
+  }
+  if (strcmp(cmdName, ".asciz") == 0) {
+    /* The characters between the quotation marks, and '\0'. */
+    return strlen(params) < 2 ? 0 : strlen(params) - 1;
+  }
+  itemType = getDataSizeByOrderName(cmdName);
+  if (itemType == -1) {
+    return 0;
+  }
+  return (unsigned long) getNumOfParams(params) * itemType;
+}
@@ -5,14 +5,18 @@
 
 void encodeRCmd(Command *command);
 
-void encodeICmd(Command *command, Label *labels);
+void encodeICmd(Command *command, LabelTable *labels);
 
-void encodeJCmd(Command *command, Label *labels);
+void encodeJCmd(Command *command, LabelTable *labels);
 
-long getLabelAddress(Label *labels, char *labelName);
+ErrorType checkCommandRange(Command *command, LabelTable *labels);
 
-void encodeOrder(DataItem **dataPicture, char *orderLine, unsigned long *address);
+long getLabelAddress(LabelTable *labels, char *labelName);
 
-void encodeAscizOrder(DataItem **dataPicture, char *orderLine, unsigned long *address);
+void encodeOrder(DataItem **dataPicture, DataItem **lastDataItem, char *orderLine, unsigned long *address);
+
+void encodeAscizOrder(DataItem **dataPicture, DataItem **lastDataItem, char *orderLine, unsigned long *address);
+
+unsigned long getOrderSize(char *cmdName, char *params);
 
 #endif
\ No newline at end of file
@@ -3,121 +3,100 @@
 
 /*
  * Creates a string that represents the bit field.
+ * The writers of the outputs do not allocate: the strings are written into the buffers of the caller.
  *
  * Params:
  * unsigned int item: the bit field.
  * int length: the size of the new string.
- * char *buf: a pointer to the new string.
+ * char *buf: a pointer to the new string (at least length + 1 chars).
  *
  * Return:
  * buf - a pointer to the new string.
  */
 char *createStrFromBitField(unsigned int item, const int length, char *buf) {
   int len = 0;
-  char *str = (char *) calloc(length + 1, sizeof(char));
-  if (str == NULL) {
-    printf("Error: Allocation Error! \n");
-    return NULL;
-  }
 
   /* If command is 0, just continue pad with zeros until str will be in the length of length. */
   while (len < length) {
     if (item & 1) {
-      str[length - len - 1] = '1';
+      buf[length - len - 1] = '1';
     } else {
-      str[length - len - 1] = '0';
+      buf[length - len - 1] = '0';
     }
 
     item >>= 1;
     len++;
   }
 
-  str[length] = '\0';
-  strcpy(buf, str);
-  free(str);
+  buf[length] = '\0';
   return buf;
 }
 
 /*
- * Prints the command table to an ob file, converting  to the hexadecimal representation.
+ * Prints the command table to the ob content, converting  to the hexadecimal representation.
  *
  * Params:
  * Command **commands: a linked list containing all the commands.
- * FILE *fptr: a pointer to the file to be printed.
- *
- * Return:
- * int count: the last memory place that printed.
+ * Buffer *buffer: the content of the ob file.
+ * int width: the number of digits of the addresses.
  */
-FILE *writeCommandIntoObjectFile(Command **commands, FILE *fptr) {
+void writeCommandIntoObjectFile(Command **commands, Buffer *buffer, int width) {
   long count = 100;
   long p1, p2, p3, p4;
   Command *head = *commands;
-  char *buf, *temp;
+  char buf[33], temp[33];
 
   while (head != NULL) {
-    /*Allocation of memory for storing string parts */
-    buf = (char *) calloc(33, sizeof(char));
-    temp = (char *) calloc(33, sizeof(char));
-    if (buf == NULL || temp == NULL) {
-      printf("Error: Allocation Error! \n");
-      return fptr;
-    }
+    buf[0] = '\0';
 
     /*Create a string representing the command in 32 characters, based on the byte field */
     if (head->type == r_cmd) {
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->opcode, 6, temp));
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rs, 5, temp));
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rt, 5, temp));
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rd, 5, temp));
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->funct, 5, temp));
-      buf = strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->unused, 6, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->opcode, 6, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rs, 5, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rt, 5, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->rd, 5, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->funct, 5, temp));
+      strcat(buf, createStrFromBitField(((RCommand *) (head->bits))->unused, 6, temp));
     } else if (head->type == i_cmd) {
-      buf = strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->opcode, 6, temp)));
-      buf = strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->rs, 5, temp)));
-      buf = strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->rt, 5, temp)));
-      buf = strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->immed, 16, temp)));
+      strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->opcode, 6, temp)));
+      strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->rs, 5, temp)));
+      strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->rt, 5, temp)));
+      strcat(buf, (createStrFromBitField(((ICommand *) (head->bits))->immed, 16, temp)));
     } else if (head->type == j_cmd) {
-      buf = strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->opcode, 6, temp)));
-      buf = strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->reg, 1, temp)));
-      buf = strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->address, 25, temp)));
+      strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->opcode, 6, temp)));
+      strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->reg, 1, temp)));
+      strcat(buf, (createStrFromBitField(((JCommand *) (head->bits))->address, 25, temp)));
     }
     /* Dividing the string into four parts, converting to the hexadecimal base and printing */
     p1 = cut(buf, 0, 8);
     p2 = cut(buf, 8, 8);
     p3 = cut(buf, 16, 8);
     p4 = cut(buf, 24, 8);
-    fprintf(fptr, "%04ld %02lX %02lX %02lX %02lX \n", head->address, p4, p3, p2, p1);
+    bufferPrintf(buffer, "%0*lu %02lX %02lX %02lX %02lX \n", width, head->address, p4, p3, p2, p1);
     count += 4;
 
     head = head->next;
-    free(buf);
-    free(temp);
   }
-  return fptr;
 }
 
 /*
- * Prints the dataPicture to an ob file, converting  to the hexadecimal representation.
+ * Prints the dataPicture to the ob content, converting  to the hexadecimal representation.
  *
  * Params:
  * DataItem **dataPicture : a linked list containing all the directives.
- * FILE *fptr: a pointer to the file to be printed.
+ * Buffer *buffer: the content of the ob file.
+ * int width: the number of digits of the addresses.
  */
-void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr) {
+void writeOrderIntoObjectFile(DataItem **dataPicture, Buffer *buffer, int width) {
   int placeInLIne = 1;
   long p1, p2, p3, p4;
   unsigned long count;
   DataItem *head = *dataPicture;
-  char *buf,*temp;
+  char *buf, temp[33];
   if(head != NULL){
     count = head->address;
   }
   while (head != NULL) {
-    temp = (char *) calloc(33, sizeof(char));
-    if (temp == NULL) {
-      printf("Error: Allocation Error! \n");
-      return;
-    }
 
     /*The function is divided according to the number of sections to be printed from each specific dataPicture
      * This section is for cases where only one section needs to be printed*/
@@ -125,14 +104,14 @@ void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr) {
       buf = createStrFromBitField((head->item).value, 8, temp);
       p1 = cut(buf, 0, 8);
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p1);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p1);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p1);
+        bufferPrintf(buffer, "%02lX ", p1);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p1);
+        bufferPrintf(buffer, "%02lX \n", p1);
         placeInLIne = 1;
       }
     }
@@ -143,26 +122,26 @@ void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr) {
       p2 = cut(buf, 8, 8);
       /*Print the p2 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p2);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p2);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p2);
+        bufferPrintf(buffer, "%02lX ", p2);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p2);
+        bufferPrintf(buffer, "%02lX \n", p2);
         placeInLIne = 1;
       }
       /*Print the p1 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p1);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p1);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p1);
+        bufferPrintf(buffer, "%02lX ", p1);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p1);
+        bufferPrintf(buffer, "%02lX \n", p1);
         placeInLIne = 1;
       }
 
@@ -176,54 +155,53 @@ void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr) {
       p4 = cut(buf, 24, 8);
       /*Print the p4 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p4);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p4);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p4);
+        bufferPrintf(buffer, "%02lX ", p4);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p4);
+        bufferPrintf(buffer, "%02lX \n", p4);
         placeInLIne = 1;
       }
       /*Print the p3 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p3);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p3);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p3);
+        bufferPrintf(buffer, "%02lX ", p3);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p3);
+        bufferPrintf(buffer, "%02lX \n", p3);
         placeInLIne = 1;
       }
       /*Print the p2 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p2);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p2);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p2);
+        bufferPrintf(buffer, "%02lX ", p2);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p2);
+        bufferPrintf(buffer, "%02lX \n", p2);
         placeInLIne = 1;
       }
       /*Print the p1 section in its proper place */
       if (placeInLIne == 1) {
-        fprintf(fptr, "%04ld %02lX ", count, p1);
+        bufferPrintf(buffer, "%0*lu %02lX ", width, count, p1);
         count += 4;
         placeInLIne++;
       } else if (placeInLIne == 2 || placeInLIne == 3) {
-        fprintf(fptr, "%02lX ", p1);
+        bufferPrintf(buffer, "%02lX ", p1);
         placeInLIne++;
       } else if (placeInLIne == 4) {
-        fprintf(fptr, "%02lX \n", p1);
+        bufferPrintf(buffer, "%02lX \n", p1);
         placeInLIne = 1;
       }
     }
-    free(buf);
     head = head->next;
   }
 }
@@ -240,137 +218,166 @@ void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr) {
  * long p1: number that preserves the value of the sub-string.
  */
 long cut(const char *buf, int begin, int end) {
-  long p;
-  char *part = (char *)calloc(9, sizeof(char));
-  if (part == NULL) {
-    printf("Error: Allocation Error! \n");
-    return -1;
-  }
+  char part[9];
+
+  memset(part, 0, sizeof(part));
   strncpy(part, buf + begin, end);
-  p = strtol(part, NULL, 2);
-  free(part);
-  return p;
+  return strtol(part, NULL, 2);
 }
 
 /*
- * Creates the ob file.
+ * Get the number of digits that the addresses of output file are printed with - at least 4, and more
+ * if the largest address is longer, so every line of the file has the same width.
  *
  * Params:
- * char *filename: the input file name.
+ * unsigned long address: the largest address of the file.
+ *
+ * Return:
+ * int width: the number of digits.
+ */
+int getAddressWidth(unsigned long address) {
+  int width = 1;
+
+  while (address >= 10) {
+    address /= 10;
+    width++;
+  }
+  return width < MIN_ADDRESS_WIDTH ? MIN_ADDRESS_WIDTH : width;
+}
+
+/*
+ * Creates the content of the ob file.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
  * Command **commands: the commands linked list.
  * DataItem **dataPicture: the dataPicture linked list.
  * unsigned long ICF: the memory length of the Orders image.
  * unsigned long IDF: the memory length of the dataPicture image.
  */
 void
-createObjectFile(char *filename, Command **commands, DataItem **dataPicture, unsigned long ICF, unsigned long IDF) {
-  char *name = changeFileName(filename, ".ob");
-  FILE *fp = fopen(name, "w");
+createObjectFile(Outputs *outputs, Command **commands, DataItem **dataPicture, unsigned long ICF, unsigned long IDF) {
+  int width = getAddressWidth(IDF > 0 ? IDF - 1 : 0);
 
-  fprintf(fp, "\t \t %ld %ld \n", ICF - 100, IDF - ICF);
-  fp = writeCommandIntoObjectFile(commands, fp);
-  writeOrderIntoObjectFile(dataPicture, fp);
-  free(name);
-  fclose(fp);
+  outputs->hasObject = true;
+  bufferPrintf(&outputs->object, "\t \t %ld %ld \n", ICF - 100, IDF - ICF);
+  writeCommandIntoObjectFile(commands, &outputs->object, width);
+  writeOrderIntoObjectFile(dataPicture, &outputs->object, width);
 }
 
 /*
- * Creates the entry file.
+ * Creates the content of the entry file.
  *
  * Params:
- * Label *labels: a pointer to a linked list of all labels.
- * char *filename: the name of the input file.
+ * Outputs *outputs: the contents of the output files.
+ * LabelTable *labels: a pointer to the labels table.
  */
-void createEntryFile(Label *labels, char *filename) {
-  int count = 0;
-  Label *head = labels;
-  FILE *fp;
-  char *name;
+void createEntryFile(Outputs *outputs, LabelTable *labels) {
+  unsigned long largest = 0;
+  int width;
+  SymbolId id;
 
-  name = changeFileName(filename, ".ent");
-  fp = fopen(name, "w");
-  while (head) {
-    if (head->attr.isEntry == true) {
-      fprintf(fp, "%s %04ld \n", head->symbol, head->value);
-      count +=1;
+  for (id = 0; id < labels->length; id++) {
+    if ((labels->items[id].attr & ATTR_ENTRY) && labels->items[id].value > largest) {
+      largest = labels->items[id].value;
     }
-    head = head->next;
   }
-  if(count == 0){
-    remove(name);
+  width = getAddressWidth(largest);
+
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_ENTRY) {
+      bufferPrintf(&outputs->entries, "%s %0*lu \n", getLabelName(labels, id), width, labels->items[id].value);
+      outputs->hasEntries = true;
+    }
   }
-  free(name);
-  fclose(fp);
 }
 
 /*
- * creates the extern file.
+ * creates the content of the extern file.
  *
  * Params:
- * Label *labels: a pointer to a linked list of all labels.
- * char *filename: the name of the input file.
+ * Outputs *outputs: the contents of the output files.
+ * LabelTable *labels: a pointer to the labels table.
  */
-void createExternalFile(Label *labels, char *filename) {
-  Label *head = labels;
-  FILE *fp;
-  int i, count = 0;
-  char *name;
+void createExternalFile(Outputs *outputs, LabelTable *labels) {
+  unsigned long largest = 0;
+  Label *label;
+  SymbolId id;
+  int i, width;
 
-  name = changeFileName(filename, ".ext");
-  fp = fopen(name, "w");
-  while (head) {
-    if (head->attr.isExternal == true) {
-      for (i = 0; i < head->appearancesLength; i++) {
-        fprintf(fp, "%s %04lu \n", head->symbol, head->appearances[i]);
+  for (id = 0; id < labels->length; id++) {
+    label = &labels->items[id];
+    for (i = 0; (label->attr & ATTR_EXTERNAL) && i < label->appearancesLength; i++) {
+      if (label->appearances[i] > largest) {
+        largest = label->appearances[i];
       }
-      count +=1;
     }
-    head = head->next;
   }
-  if(count == 0){
-    remove(name);
+  width = getAddressWidth(largest);
+
+  for (id = 0; id < labels->length; id++) {
+    label = &labels->items[id];
+    if (label->attr & ATTR_EXTERNAL) {
+      for (i = 0; i < label->appearancesLength; i++) {
+        bufferPrintf(&outputs->externals, "%s %0*lu \n", getLabelName(labels, id), width, label->appearances[i]);
+      }
+      outputs->hasExternals = true;
+    }
   }
-  free(name);
-  fclose(fp);
 }
 
 /*
- * Replaces the end of the function name in the 'ext' string.
+ * Initialize empty contents of output files.
  *
  * Params:
- * char *name: the name of the file.
- * char *ext: the file extension.
- *
- * Return:
- * char *filname - the new name of the file.
+ * Outputs *outputs: the contents of the output files.
  */
-char *changeFileName(char *name, char *ext) {
-  size_t fileNameLen = strlen(name) - 3 + strlen(ext);
-  char *fileName = (char *) calloc(fileNameLen + 1, sizeof(char));
-  if (name == NULL) {
-    printf("Error: Allocation Error! \n");
-    return NULL;
-  }
-  fileName = strncpy(fileName, name, strlen(name) - 3);
-  fileName[strlen(name) - 3] = '\0';
-  strcat(fileName, ext);
-  return fileName;
+void initOutputs(Outputs *outputs) {
+  initBuffer(&outputs->object);
+  initBuffer(&outputs->entries);
+  initBuffer(&outputs->externals);
+  initBuffer(&outputs->symbols);
+  initBuffer(&outputs->report);
+  initBuffer(&outputs->listing);
+  initBuffer(&outputs->debug);
+  resetOutputs(outputs);
 }
 
-/* Make sure the extension of filename is ".as".
+/*
+ * Empty the contents of output files, but keep their memory for the next source.
  *
  * Params:
- * char *filename: file name.
- *
- * Returns:
- * Boolean isAsFile: true if file from type of as, otherwise - return false.
-*/
-Boolean isAsFile(char *filename){
-  size_t length = strlen(filename);
-  const char *extension = &filename[length - 3];
+ * Outputs *outputs: the contents of the output files.
+ */
+void resetOutputs(Outputs *outputs) {
+  resetBuffer(&outputs->object);
+  resetBuffer(&outputs->entries);
+  resetBuffer(&outputs->externals);
+  resetBuffer(&outputs->symbols);
+  resetBuffer(&outputs->report);
+  resetBuffer(&outputs->listing);
+  resetBuffer(&outputs->debug);
+  outputs->hasObject = false;
+  outputs->hasEntries = false;
+  outputs->hasExternals = false;
+  outputs->hasSymbols = false;
+  outputs->hasReport = false;
+  outputs->hasListing = false;
+  outputs->hasDebug = false;
+}
 
-  if(strcmp(extension, ".as") == 0){
-    return true;
-  }
-  return false;
-}
\ No newline at end of file
+/*
+ * Free the memory of the contents of output files.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ */
+void freeOutputs(Outputs *outputs) {
+  freeBuffer(&outputs->object);
+  freeBuffer(&outputs->entries);
+  freeBuffer(&outputs->externals);
+  freeBuffer(&outputs->symbols);
+  freeBuffer(&outputs->report);
+  freeBuffer(&outputs->listing);
+  freeBuffer(&outputs->debug);
+}
@@ -3,25 +3,52 @@
 
 #include "Datatypes.h"
 #include "parserInput.h"
-
+#include "buffer.h"
+
+
+/* Data structure representing the contents of the output files of one source. */
+typedef struct outputs {
+    Buffer object;
+    Buffer entries;
+    Buffer externals;
+    Buffer symbols;
+    Buffer report;
+    Buffer listing;
+    Buffer debug;
+    Boolean hasObject;
+    Boolean hasEntries;
+    Boolean hasExternals;
+    Boolean hasSymbols;
+    Boolean hasReport;
+    Boolean hasListing;
+    Boolean hasDebug;
+} Outputs;
+
+/* The addresses of the outputs are printed with at least 4 digits, and with the digits of the largest
+ * address of the file if it is longer (up to 8 digits for the 25 bits addresses). */
+#define MIN_ADDRESS_WIDTH 4
 
 char *createStrFromBitField(unsigned int item, const int length, char *buf);
 
-FILE *writeCommandIntoObjectFile(Command **commands, FILE *fptr);
+void writeCommandIntoObjectFile(Command **commands, Buffer *buffer, int width);
+
+void writeOrderIntoObjectFile(DataItem **dataPicture, Buffer *buffer, int width);
 
-void writeOrderIntoObjectFile(DataItem **dataPicture, FILE *fptr);
+int getAddressWidth(unsigned long address);
 
-void createObjectFile(char *filename, Command **commands, DataItem **dataPicture, unsigned long ICF, unsigned long IDF);
+void createObjectFile(Outputs *outputs, Command **commands, DataItem **dataPicture, unsigned long ICF, unsigned long IDF);
 
-void createEntryFile(Label *labels, char *filename);
+void createEntryFile(Outputs *outputs, LabelTable *labels);
 
 long cut(const char *buf, int begin, int end);
 
-void createExternalFile(Label *labels, char* filename);
+void createExternalFile(Outputs *outputs, LabelTable *labels);
+
+void initOutputs(Outputs *outputs);
 
-char *changeFileName(char* name, char *ext);
+void resetOutputs(Outputs *outputs);
 
-Boolean isAsFile(char *filename);
+void freeOutputs(Outputs *outputs);
 
 
 #endif
\ No newline at end of file
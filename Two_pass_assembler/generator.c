@@ -0,0 +1,323 @@
+#include "generator.h"
+#include "constants.h"
+
+/* Branches jump to one of the last labels of code lines, so their offset always fits 16 bits (the
+ * labels of data lines are placed after all the code). */
+#define BRANCH_WINDOW 16
+/* The length of the too long lines of the errors, the lines of the assembler are 80 chars at most. */
+#define LONG_LINE_LENGTH 90
+
+/* Data structure representing the state of one generation. */
+typedef struct generator {
+    Buffer *source;
+    GeneratorMix *mix;
+    unsigned long random;
+    unsigned long numOfLabels;
+    unsigned long numOfExterns;
+    unsigned long codeLabels[BRANCH_WINDOW];
+    unsigned long numOfCodeLabels;
+} Generator;
+
+unsigned long nextRandom(Generator *generator, unsigned long range);
+
+char *randomRegister(Generator *generator);
+
+void randomLabel(Generator *generator, char *name, Boolean near);
+
+Boolean generateLine(Generator *generator);
+
+Boolean generateData(Generator *generator);
+
+Boolean generateError(Generator *generator);
+
+/* Set the default mix - mostly instructions, like the sources in tests.
+ *
+ * Params:
+ * GeneratorMix *mix: the mix to fill.
+*/
+void initGeneratorMix(GeneratorMix *mix) {
+  mix->rWeight = 30;
+  mix->iWeight = 30;
+  mix->branchWeight = 10;
+  mix->jWeight = 10;
+  mix->dataWeight = 20;
+  mix->labelsPercent = 20;
+  mix->numOfExterns = 16;
+  mix->numOfEntries = 16;
+  mix->dataItems = 6;
+  mix->stringLength = 20;
+  mix->errorsPercent = 0;
+}
+
+/* Set mix that is mostly data lines, with long data lines and errors in some of the lines - the lists of
+ * the data and of the errors grow with the source, unlike in the default mix.
+ *
+ * Params:
+ * GeneratorMix *mix: the mix to fill.
+*/
+void initDataErrorsMix(GeneratorMix *mix) {
+  initGeneratorMix(mix);
+  mix->rWeight = 10;
+  mix->iWeight = 10;
+  mix->branchWeight = 5;
+  mix->jWeight = 5;
+  mix->dataWeight = 70;
+  /* The longest .dw line of 8 items is still shorter than MAX_LINE_LENGTH. */
+  mix->dataItems = 8;
+  mix->stringLength = 60;
+  mix->errorsPercent = 10;
+}
+
+/* Generate source of numOfLines lines (with '\n'), valid unless the mix has errors. The .extern lines
+ * are first, the .entry lines are last and refer to labels that were defined.
+ *
+ * Params:
+ * Buffer *source: the buffer to append the source to.
+ * unsigned long seed: the seed of the random choices.
+ * unsigned long numOfLines: the number of lines.
+ * GeneratorMix *mix: the mix of the lines.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean generateSource(Buffer *source, unsigned long seed, unsigned long numOfLines, GeneratorMix *mix) {
+  Generator generator;
+  unsigned long line = 0;
+  unsigned long numOfEntries;
+  Boolean status;
+  int i;
+
+  generator.source = source;
+  generator.mix = mix;
+  generator.random = seed;
+  generator.numOfLabels = 0;
+  generator.numOfCodeLabels = 0;
+
+  for (i = 0; i < mix->numOfExterns && line < numOfLines / 8; i++, line++) {
+    if (bufferPrintf(source, ".extern X%d\n", i) == false) {
+      return false;
+    }
+  }
+  generator.numOfExterns = (unsigned long) i;
+
+  numOfEntries = (unsigned long) mix->numOfEntries;
+  if (numOfEntries > numOfLines / 8) {
+    numOfEntries = numOfLines / 8;
+  }
+  for (; line < numOfLines - numOfEntries; line++) {
+    if (generateLine(&generator) == false) {
+      return false;
+    }
+  }
+
+  /* The entries are spread over the labels, every label is entry once at most. */
+  for (i = 0; line < numOfLines; i++, line++) {
+    if (generator.numOfLabels == 0) {
+      status = bufferPrintf(source, "stop\n");
+    } else {
+      status = bufferPrintf(source, ".entry L%lu\n", (unsigned long) i * generator.numOfLabels / numOfEntries);
+    }
+    if (status == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Get the next random number (linear congruential generator of 31 bits).
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ * unsigned long range: the count of the possible numbers.
+ *
+ * Returns:
+ * unsigned long number: number between 0 and range - 1.
+*/
+unsigned long nextRandom(Generator *generator, unsigned long range) {
+  generator->random = (generator->random * 1103515245UL + 12345UL) & 0x7FFFFFFFUL;
+  return (generator->random >> 8) % range;
+}
+
+/* Get random register.
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ *
+ * Returns:
+ * char *name: the name of the register.
+*/
+char *randomRegister(Generator *generator) {
+  return registerName[nextRandom(generator, 32)];
+}
+
+/* Get the name of random label that was already defined (or of extern).
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ * char *name: array to copy the name into.
+ * Boolean near: true for one of the last labels of code lines, for branches (externs are not chosen then).
+*/
+void randomLabel(Generator *generator, char *name, Boolean near) {
+  unsigned long label;
+  unsigned long window;
+
+  if (near == false && generator->numOfExterns > 0 && nextRandom(generator, 4) == 0) {
+    sprintf(name, "X%lu", nextRandom(generator, generator->numOfExterns));
+    return;
+  }
+  if (generator->numOfLabels == 0 || (near == true && generator->numOfCodeLabels == 0)) {
+    name[0] = '\0';
+    return;
+  }
+  if (near == true) {
+    window = generator->numOfCodeLabels < BRANCH_WINDOW ? generator->numOfCodeLabels : BRANCH_WINDOW;
+    label = generator->codeLabels[(generator->numOfCodeLabels - 1 - nextRandom(generator, window)) % BRANCH_WINDOW];
+  } else {
+    label = nextRandom(generator, generator->numOfLabels);
+  }
+  sprintf(name, "L%lu", label);
+}
+
+/* Generate one line of code or data, with or without label.
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean generateLine(Generator *generator) {
+  GeneratorMix *mix = generator->mix;
+  Buffer *source = generator->source;
+  char target[MAX_LABEL_LENGTH + 1];
+  unsigned long total = mix->rWeight + mix->iWeight + mix->branchWeight + mix->jWeight + mix->dataWeight;
+  unsigned long kind;
+
+  /* The sources without errors take the same random numbers as before there were errors in the mix. */
+  if (mix->errorsPercent > 0 && nextRandom(generator, 100) < (unsigned long) mix->errorsPercent) {
+    return generateError(generator);
+  }
+  kind = nextRandom(generator, total == 0 ? 1 : total);
+  if (nextRandom(generator, 100) < (unsigned long) mix->labelsPercent) {
+    if (kind < total - mix->dataWeight) {
+      generator->codeLabels[generator->numOfCodeLabels++ % BRANCH_WINDOW] = generator->numOfLabels;
+    }
+    bufferPrintf(source, "L%lu: ", generator->numOfLabels++);
+  }
+
+  if (kind < (unsigned long) mix->rWeight) {
+    if (nextRandom(generator, 8) < 5) {
+      bufferPrintf(source, "%s %s, %s, %s\n", rACmd[nextRandom(generator, 5)], randomRegister(generator),
+                   randomRegister(generator), randomRegister(generator));
+    } else {
+      bufferPrintf(source, "%s %s, %s\n", rMCmd[nextRandom(generator, 3)], randomRegister(generator),
+                   randomRegister(generator));
+    }
+    return source->overflow == true ? false : true;
+  }
+  kind -= mix->rWeight;
+  if (kind < (unsigned long) mix->iWeight) {
+    bufferPrintf(source, "%s %s, %ld, %s\n", iACmd[nextRandom(generator, 11)], randomRegister(generator),
+                 (long) nextRandom(generator, 65536) - 32768, randomRegister(generator));
+    return source->overflow == true ? false : true;
+  }
+  kind -= mix->iWeight;
+  if (kind < (unsigned long) mix->branchWeight) {
+    randomLabel(generator, target, true);
+    if (target[0] == '\0') {
+      bufferPrintf(source, "stop\n");
+    } else {
+      bufferPrintf(source, "%s %s, %s, %s\n", iBCmd[nextRandom(generator, 4)], randomRegister(generator),
+                   randomRegister(generator), target);
+    }
+    return source->overflow == true ? false : true;
+  }
+  kind -= mix->branchWeight;
+  if (kind < (unsigned long) mix->jWeight) {
+    randomLabel(generator, target, false);
+    if (target[0] == '\0') {
+      bufferPrintf(source, "stop\n");
+    } else if (nextRandom(generator, 8) == 0) {
+      bufferPrintf(source, "jmp %s\n", randomRegister(generator));
+    } else {
+      bufferPrintf(source, "%s %s\n", nextRandom(generator, 3) == 0 ? "jmp" : jCmd[nextRandom(generator, 2)], target);
+    }
+    return source->overflow == true ? false : true;
+  }
+  return generateData(generator);
+}
+
+/* Generate the directive of data line (.db, .dh, .dw or .asciz).
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean generateData(Generator *generator) {
+  GeneratorMix *mix = generator->mix;
+  Buffer *source = generator->source;
+  unsigned long type = nextRandom(generator, 4);
+  char *name;
+  unsigned long count;
+  unsigned long i;
+  long limit;
+
+  if (type == 3) {
+    appendBuffer(source, ".asciz \"", 8);
+    count = nextRandom(generator, mix->stringLength + 1);
+    for (i = 0; i < count; i++) {
+      bufferPrintf(source, "%c", (char) ('a' + nextRandom(generator, 26)));
+    }
+    appendBuffer(source, "\"\n", 2);
+    return source->overflow == true ? false : true;
+  }
+
+  /* .db, .dh or .dw, with values that fit the size of their items (the largest one is left out,
+   * the validation does not accept it). */
+  name = type == 0 ? ".db" : type == 1 ? ".dh" : ".dw";
+  limit = type == 0 ? 128 : type == 1 ? 32768 : 1000000;
+  appendBuffer(source, name, strlen(name));
+  count = 1 + nextRandom(generator, mix->dataItems < 1 ? 1 : mix->dataItems);
+  for (i = 0; i < count; i++) {
+    bufferPrintf(source, "%s%ld", i == 0 ? " " : ",", (long) nextRandom(generator, 2 * limit - 1) - limit);
+  }
+  appendBuffer(source, "\n", 1);
+  return source->overflow == true ? false : true;
+}
+
+/* Generate line with error, without label: too long line (pass 1), .extern of label of the source (the
+ * directives), register out of the range, branch to label that does not exist or data value out of the
+ * range of its directive (the validation).
+ *
+ * Params:
+ * Generator *generator: pointer to the generator.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean generateError(Generator *generator) {
+  Buffer *source = generator->source;
+  unsigned long kind = nextRandom(generator, 5);
+  int i;
+
+  if (kind == 0) {
+    appendBuffer(source, ";", 1);
+    for (i = 0; i < LONG_LINE_LENGTH; i++) {
+      appendBuffer(source, "x", 1);
+    }
+    appendBuffer(source, "\n", 1);
+  } else if (kind == 1 && generator->numOfLabels > 0) {
+    bufferPrintf(source, ".extern L%lu\n", nextRandom(generator, generator->numOfLabels));
+  } else if (kind == 1 || kind == 2) {
+    bufferPrintf(source, "add %s, %s, $%lu\n", randomRegister(generator), randomRegister(generator),
+                 32 + nextRandom(generator, 32));
+  } else if (kind == 3) {
+    bufferPrintf(source, "bne %s, %s, MISSING%lu\n", randomRegister(generator), randomRegister(generator),
+                 nextRandom(generator, 1000));
+  } else {
+    bufferPrintf(source, ".db %lu\n", 128 + nextRandom(generator, 1000));
+  }
+  return source->overflow == true ? false : true;
+}
@@ -0,0 +1,35 @@
+#ifndef MAMAN14_GENERATOR_H
+#define MAMAN14_GENERATOR_H
+
+#include "buffer.h"
+
+/*
+ * Generator of synthetic sources for benchmarks - valid ones, or with lines with errors when the mix asks for them.
+ * The same seed and mix always generate the same source, so the inputs of the benchmarks do not have to be committed.
+ */
+
+/* Data structure representing the mix of the generated source. The kinds of lines are chosen by
+ * their weights, and every line gets label by labelsPercent. errorsPercent of the lines (0 by
+ * default) are lines with errors of pass 1, of the directives or of the validation instead. */
+typedef struct generatorMix {
+    int rWeight;
+    int iWeight;
+    int branchWeight;
+    int jWeight;
+    int dataWeight;
+    int labelsPercent;
+    int numOfExterns;
+    int numOfEntries;
+    /* The most items of .db/.dh/.dw line, and the longest string of .asciz line. */
+    int dataItems;
+    int stringLength;
+    int errorsPercent;
+} GeneratorMix;
+
+void initGeneratorMix(GeneratorMix *mix);
+
+void initDataErrorsMix(GeneratorMix *mix);
+
+Boolean generateSource(Buffer *source, unsigned long seed, unsigned long numOfLines, GeneratorMix *mix);
+
+#endif
@@ -0,0 +1,237 @@
+#include "globalIndex.h"
+
+Boolean addIndexFile(GlobalIndex *index, char *filename);
+
+Boolean addSymbolFile(SymbolFiles **symbolFiles, SymbolId *length, SymbolId symbol, int file);
+
+void freeSymbolFiles(SymbolFiles *symbolFiles, SymbolId length);
+
+void printIndexFiles(GlobalIndex *index, SymbolFiles *symbolFiles);
+
+/* Initialize empty global index.
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+*/
+void initGlobalIndex(GlobalIndex *index) {
+  initLabelTable(&index->entries);
+  initLabelTable(&index->externals);
+  index->entryFiles = NULL;
+  index->externalFiles = NULL;
+  index->entryFilesLength = 0;
+  index->externalFilesLength = 0;
+  index->files = NULL;
+  index->filesLength = 0;
+  index->filesCapacity = 0;
+  index->failedFiles = 0;
+  pthread_mutex_init(&index->lock, NULL);
+}
+
+/* Free all the memory of global index.
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+*/
+void freeGlobalIndex(GlobalIndex *index) {
+  int i;
+
+  freeLabelTable(&index->entries);
+  freeLabelTable(&index->externals);
+  freeSymbolFiles(index->entryFiles, index->entryFilesLength);
+  freeSymbolFiles(index->externalFiles, index->externalFilesLength);
+  index->entryFiles = NULL;
+  index->externalFiles = NULL;
+  index->entryFilesLength = 0;
+  index->externalFilesLength = 0;
+  for (i = 0; i < index->filesLength; i++) {
+    free(index->files[i]);
+  }
+  free(index->files);
+  index->files = NULL;
+  index->filesLength = 0;
+  index->filesCapacity = 0;
+  index->failedFiles = 0;
+  pthread_mutex_destroy(&index->lock);
+}
+
+/* Add file name to the files array of global index (the lock is already taken).
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+ * char *filename: the name of the file.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean addIndexFile(GlobalIndex *index, char *filename) {
+  int capacity;
+  char **files;
+
+  if (index->filesLength == index->filesCapacity) {
+    capacity = index->filesCapacity == 0 ? 16 : index->filesCapacity * 2;
+    files = (char **) realloc(index->files, capacity * sizeof(char *));
+    if (files == NULL) {
+      printf("Error: Allocation Error! \n");
+      return false;
+    }
+    index->files = files;
+    index->filesCapacity = capacity;
+  }
+
+  index->files[index->filesLength] = duplicateStr(filename);
+  if (index->files[index->filesLength] == NULL) {
+    return false;
+  }
+  index->filesLength++;
+  return true;
+}
+
+/* Add file to the files of symbol, the array of the files of the symbols grows to the symbol.
+ *
+ * Params:
+ * SymbolFiles **symbolFiles: pointer to the files of the symbols of one table.
+ * SymbolId *length: pointer to the length of the array.
+ * SymbolId symbol: the symbol.
+ * int file: the index of the file in the files array.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean addSymbolFile(SymbolFiles **symbolFiles, SymbolId *length, SymbolId symbol, int file) {
+  SymbolFiles *grown, *files;
+  SymbolId capacity;
+  int *items;
+
+  if (symbol >= *length) {
+    capacity = *length == 0 ? 64 : *length * 2;
+    while (capacity <= symbol) {
+      capacity *= 2;
+    }
+    grown = (SymbolFiles *) realloc(*symbolFiles, capacity * sizeof(SymbolFiles));
+    if (grown == NULL) {
+      printf("Error: Allocation Error! \n");
+      return false;
+    }
+    memset(grown + *length, 0, (capacity - *length) * sizeof(SymbolFiles));
+    *symbolFiles = grown;
+    *length = capacity;
+  }
+
+  files = &(*symbolFiles)[symbol];
+  if (files->length == files->capacity) {
+    items = (int *) realloc(files->files, (files->capacity == 0 ? 2 : files->capacity * 2) * sizeof(int));
+    if (items == NULL) {
+      printf("Error: Allocation Error! \n");
+      return false;
+    }
+    files->files = items;
+    files->capacity = files->capacity == 0 ? 2 : files->capacity * 2;
+  }
+  files->files[files->length++] = file;
+  return true;
+}
+
+/* Free the files of the symbols of one table.
+ *
+ * Params:
+ * SymbolFiles *symbolFiles: the files of the symbols.
+ * SymbolId length: the length of the array.
+*/
+void freeSymbolFiles(SymbolFiles *symbolFiles, SymbolId length) {
+  SymbolId i;
+
+  for (i = 0; i < length; i++) {
+    free(symbolFiles[i].files);
+  }
+  free(symbolFiles);
+}
+
+/* Publish the entries and the externals of one file into the global index. File that was not assembled
+ * publishes only the entries that it declares, so the files that use them are not reported.
+ * Safe to be called from several threads at the same time.
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+ * char *filename: the name of the file.
+ * LabelTable *labels: the labels table of the file.
+ * Boolean failed: true if the file has errors.
+*/
+void publishFileSymbols(GlobalIndex *index, char *filename, LabelTable *labels, Boolean failed) {
+  SymbolId id, symbol;
+  int file;
+
+  pthread_mutex_lock(&index->lock);
+  if (failed == true) {
+    index->failedFiles++;
+  }
+  if (addIndexFile(index, filename) == false) {
+    pthread_mutex_unlock(&index->lock);
+    return;
+  }
+  file = index->filesLength - 1;
+
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_ENTRY) {
+      symbol = addNewLabel(&index->entries, getLabelName(labels, id), labels->items[id].value, labels->items[id].attr);
+      if (symbol != NO_SYMBOL) {
+        addSymbolFile(&index->entryFiles, &index->entryFilesLength, symbol, file);
+      }
+    } else if ((labels->items[id].attr & ATTR_EXTERNAL) && failed == false) {
+      symbol = addNewLabel(&index->externals, getLabelName(labels, id), labels->items[id].value,
+                           labels->items[id].attr);
+      if (symbol != NO_SYMBOL) {
+        addSymbolFile(&index->externalFiles, &index->externalFilesLength, symbol, file);
+      }
+    }
+  }
+  pthread_mutex_unlock(&index->lock);
+}
+
+/* Print the names of the files of symbol.
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+ * SymbolFiles *symbolFiles: the files of the symbol.
+*/
+void printIndexFiles(GlobalIndex *index, SymbolFiles *symbolFiles) {
+  int i;
+  for (i = 0; i < symbolFiles->length; i++) {
+    fprintf(stderr, " %s", index->files[symbolFiles->files[i]]);
+  }
+  fprintf(stderr, " \n");
+}
+
+/* Print all entries that defined in more than one file, and all externals that no file defines as entry.
+ * When some file was not assembled, its entries may be missing, so the externals are not reported.
+ *
+ * Params:
+ * GlobalIndex *index: pointer to the global index.
+ *
+ * Returns:
+ * int numOfErrors: the number of problems found.
+*/
+int reportGlobalIndex(GlobalIndex *index) {
+  int numOfErrors = 0;
+  SymbolId id;
+
+  for (id = 0; id < index->entries.length && id < index->entryFilesLength; id++) {
+    if (index->entryFiles[id].length > 1) {
+      fprintf(stderr, "Error! entry: %s is defined in more than one file:", getLabelName(&index->entries, id));
+      printIndexFiles(index, &index->entryFiles[id]);
+      numOfErrors++;
+    }
+  }
+
+  if (index->failedFiles > 0) {
+    return numOfErrors;
+  }
+  for (id = 0; id < index->externals.length && id < index->externalFilesLength; id++) {
+    if (findLabel(&index->entries, getLabelName(&index->externals, id)) == NO_SYMBOL) {
+      fprintf(stderr, "Error! external: %s is not an entry of any file, used in:",
+              getLabelName(&index->externals, id));
+      printIndexFiles(index, &index->externalFiles[id]);
+      numOfErrors++;
+    }
+  }
+  return numOfErrors;
+}
@@ -0,0 +1,39 @@
+#ifndef MAMAN14_GLOBALINDEX_H
+#define MAMAN14_GLOBALINDEX_H
+
+#include <pthread.h>
+#include "Datatypes.h"
+
+/* Data structure representing the files that one symbol of the index is published by, as indexes in files array. */
+typedef struct symbolFiles {
+    int *files;
+    int length;
+    int capacity;
+} SymbolFiles;
+
+/* Data structure representing index of the symbols of all the files in one batch.
+ * The files of the symbols of each table are kept by their SymbolId. Files that were not assembled publish only
+ * the entries that they declare, and are counted so the externals are not reported as missing. */
+typedef struct globalIndex {
+    LabelTable entries;
+    LabelTable externals;
+    SymbolFiles *entryFiles;
+    SymbolFiles *externalFiles;
+    SymbolId entryFilesLength;
+    SymbolId externalFilesLength;
+    char **files;
+    int filesLength;
+    int filesCapacity;
+    int failedFiles;
+    pthread_mutex_t lock;
+} GlobalIndex;
+
+void initGlobalIndex(GlobalIndex *index);
+
+void freeGlobalIndex(GlobalIndex *index);
+
+void publishFileSymbols(GlobalIndex *index, char *filename, LabelTable *labels, Boolean failed);
+
+int reportGlobalIndex(GlobalIndex *index);
+
+#endif
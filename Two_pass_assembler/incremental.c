@@ -0,0 +1,728 @@
+#include "incremental.h"
+#include "parserInput.h"
+#include "encoding.h"
+#include "validation.h"
+#include "symbolFile.h"
+#include "report.h"
+#include "listing.h"
+#include "debugFile.h"
+
+
+Boolean setSourceLine(SourceLine *line, const char *text, unsigned long length, Boolean newline);
+
+void parseChunk(LineChunk *chunk);
+
+void freeChunk(LineChunk *chunk);
+
+void freeSourceLine(SourceLine *line);
+
+Boolean endSourceLine(IncrementalSource *source, int index);
+
+Boolean isLineEqual(SourceLine *line, const char *text, unsigned long length);
+
+void linkChunks(IncrementalSource *source, Command **commands, DataItem **dataPicture);
+
+void passChunkDirectives(IncrementalSource *source);
+
+void validateChunks(IncrementalSource *source);
+
+void encodeChunkCommand(LineChunk *chunk, LabelTable *labels);
+
+void writeChunksListing(IncrementalSource *source, Command **commands, DataItem **dataPicture, unsigned long IDF);
+
+/* Initialize empty resident source.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+*/
+void initIncrementalSource(IncrementalSource *source) {
+  initAssemblerContext(&source->context);
+  initBuffer(&source->checkedLabels);
+  source->labelsVersion = 1;
+  source->lines = NULL;
+  source->numOfLines = 0;
+  source->linesCapacity = 0;
+}
+
+/* Free all the memory of the resident source and its context.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+*/
+void freeIncrementalSource(IncrementalSource *source) {
+  int i;
+
+  for (i = 0; i < source->numOfLines; i++) {
+    freeSourceLine(&source->lines[i]);
+  }
+  free(source->lines);
+  source->lines = NULL;
+  source->numOfLines = 0;
+  source->linesCapacity = 0;
+  freeBuffer(&source->checkedLabels);
+  freeAssemblerContext(&source->context);
+}
+
+/* Replace lines of the source by new lines, and parse only the new lines.
+ * Lines are inserted when count is 0, and removed when the text is empty.
+ * Every line but the last line of the source ends with '\n' - it is added when it is missing.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ * int first: the index of the first line to replace.
+ * int count: the number of lines to replace.
+ * const char *text: the new lines (does not have to end with '\0').
+ * unsigned long length: the length of the new lines in bytes.
+ *
+ * Returns:
+ * Boolean status: true if the lines were replaced, false if the lines are out of the source or there
+ *                 is no memory (some of the new lines may be empty then).
+*/
+Boolean replaceSourceLines(IncrementalSource *source, int first, int count, const char *text, unsigned long length) {
+  int numOfNewLines = 0;
+  int capacity;
+  int i;
+  unsigned long position;
+  unsigned long end;
+  SourceLine *lines;
+  Boolean status = true;
+
+  if (first < 0 || count < 0 || first + count > source->numOfLines) {
+    return false;
+  }
+
+  for (position = 0; position < length; position++) {
+    if (text[position] == '\n' || position == length - 1) {
+      numOfNewLines++;
+    }
+  }
+
+  if (source->numOfLines - count + numOfNewLines > source->linesCapacity) {
+    capacity = source->linesCapacity == 0 ? 64 : source->linesCapacity;
+    while (capacity < source->numOfLines - count + numOfNewLines) {
+      capacity *= 2;
+    }
+    lines = (SourceLine *) realloc(source->lines, capacity * sizeof(SourceLine));
+    if (lines == NULL) {
+      return false;
+    }
+    source->lines = lines;
+    source->linesCapacity = capacity;
+  }
+
+  for (i = first; i < first + count; i++) {
+    freeSourceLine(&source->lines[i]);
+  }
+  memmove(source->lines + first + numOfNewLines, source->lines + first + count,
+          (source->numOfLines - first - count) * sizeof(SourceLine));
+  source->numOfLines += numOfNewLines - count;
+
+  position = 0;
+  for (i = first; i < first + numOfNewLines; i++) {
+    end = position;
+    while (end < length - 1 && text[end] != '\n') {
+      end++;
+    }
+    if (setSourceLine(&source->lines[i], text + position, end + 1 - position, false) == false) {
+      status = false;
+    }
+    position = end + 1;
+  }
+
+  /* The lines around the new lines are joined to them in the source without '\n'. */
+  if (endSourceLine(source, first - 1) == false || endSourceLine(source, first + numOfNewLines - 1) == false) {
+    status = false;
+  }
+  return status;
+}
+
+/* Load new content of the source - only the lines that are different from the resident lines are
+ * replaced (the lines between the same first lines and the same last lines).
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ * const char *data: the new content of the source (does not have to end with '\0').
+ * unsigned long length: the length of the content in bytes.
+ *
+ * Returns:
+ * Boolean status: the same as replaceSourceLines.
+*/
+Boolean loadIncrementalSource(IncrementalSource *source, const char *data, unsigned long length) {
+  unsigned long begin = 0;
+  unsigned long end = length;
+  unsigned long position;
+  int first = 0;
+  int last = source->numOfLines;
+
+  /* Skip the same first lines. */
+  while (first < last && begin < end) {
+    position = begin;
+    while (position < end - 1 && data[position] != '\n') {
+      position++;
+    }
+    if (isLineEqual(&source->lines[first], data + begin, position + 1 - begin) == false) {
+      break;
+    }
+    begin = position + 1;
+    first++;
+  }
+
+  /* Skip the same last lines. */
+  while (first < last && begin < end) {
+    position = end - 1;
+    while (position > begin && data[position - 1] != '\n') {
+      position--;
+    }
+    if (isLineEqual(&source->lines[last - 1], data + position, end - position) == false) {
+      break;
+    }
+    end = position;
+    last--;
+  }
+
+  if (first == last && begin == end) {
+    return true;
+  }
+  return replaceSourceLines(source, first, last - first, data + begin, end - begin);
+}
+
+/* Assemble the resident source again, after its lines were replaced.
+ * The outputs and the errors in the context are the same as assembleSource would create from the whole
+ * source, but only the work that depends on the replaced lines is done again.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ *
+ * Returns:
+ * AssemblerStatus status: the same as assembleSource.
+*/
+AssemblerStatus reassembleSource(IncrementalSource *source) {
+  AssemblerContext *context = &source->context;
+  LabelTable *labels = &context->labels;
+  Outputs *outputs = &context->outputs;
+  Command *commands = NULL;
+  DataItem *dataPicture = NULL;
+  unsigned long ICF;
+  unsigned long DCF;
+  int i, j;
+  LineChunk *chunk;
+  ErrorType errorType;
+
+  resetAssemblerContext(context);
+  reportPhase(context, pass1_phase, true);
+  linkChunks(source, &commands, &dataPicture);
+  reportPhase(context, pass1_phase, false);
+  reportPhase(context, directives_phase, true);
+  passChunkDirectives(source);
+  /* add each data label ICF */
+  updateDataLabels(labels, context->IC);
+  reportPhase(context, directives_phase, false);
+  reportPhase(context, validate_phase, true);
+  validateChunks(source);
+  reportPhase(context, validate_phase, false);
+  ICF = context->IC;
+  DCF = context->DC + ICF;
+
+  if (context->numOfErrors != 0) {
+    return source_errors;
+  }
+
+  reportPhase(context, pass2_phase, true);
+  updateDataPictureAddress(&dataPicture, ICF);
+  for (i = 0; i < source->numOfLines; i++) {
+    for (j = 0; j < source->lines[i].numOfChunks; j++) {
+      chunk = &source->lines[i].chunks[j];
+      if (chunk->linked == true && chunk->command != NULL) {
+        encodeChunkCommand(chunk, labels);
+        errorType = checkCommandRange(chunk->command, labels);
+        if (errorType != valid) {
+          addNewError(&context->errors, &context->lastError,
+                      initNewError(getMessageErrorType(errorType), chunk->command->lineNumber));
+          context->numOfErrors++;
+        }
+      }
+    }
+  }
+  reportPhase(context, pass2_phase, false);
+  if (context->numOfErrors != 0) {
+    return source_errors;
+  }
+
+  reportPhase(context, externals_phase, true);
+  updateExternalAppearancesLabels(&commands, labels);
+  reportPhase(context, externals_phase, false);
+  reportPhase(context, object_phase, true);
+  createObjectFile(outputs, &commands, &dataPicture, ICF, DCF);
+  reportPhase(context, object_phase, false);
+  reportPhase(context, entries_phase, true);
+  createEntryFile(outputs, labels);
+  reportPhase(context, entries_phase, false);
+  reportPhase(context, externals_file_phase, true);
+  createExternalFile(outputs, labels);
+  reportPhase(context, externals_file_phase, false);
+  if (context->sym == true) {
+    reportPhase(context, symbols_phase, true);
+    createSymbolFile(outputs, labels);
+    reportPhase(context, symbols_phase, false);
+  }
+  if (context->report == true) {
+    reportPhase(context, report_phase, true);
+    createReportFile(outputs, &commands, &dataPicture, labels);
+    reportPhase(context, report_phase, false);
+  }
+  if (context->listing == true) {
+    reportPhase(context, listing_phase, true);
+    writeChunksListing(source, &commands, &dataPicture, DCF);
+    reportPhase(context, listing_phase, false);
+  }
+  if (context->debug == true) {
+    reportPhase(context, debug_phase, true);
+    createDebugFile(outputs, &commands, &dataPicture, ICF, DCF);
+    reportPhase(context, debug_phase, false);
+  }
+  return isOutputOverflowed(outputs) == true ? output_overflow : assembled;
+}
+
+/* Copy the text of line, cut it into chunks like getSourceLine reads them, and parse each chunk.
+ *
+ * Params:
+ * SourceLine *line: pointer to the line (its memory is not freed).
+ * const char *text: the text of the line.
+ * unsigned long length: the length of the text.
+ * Boolean newline: true to add '\n' to the end of the text.
+ *
+ * Returns:
+ * Boolean status: true if the line was parsed, false if there is no memory (the line is empty then).
+*/
+Boolean setSourceLine(SourceLine *line, const char *text, unsigned long length, Boolean newline) {
+  Source source;
+  char chunkText[MAX_LINE_LENGTH + 1];
+  int numOfChunks = 0;
+
+  line->text = NULL;
+  line->length = 0;
+  line->chunks = NULL;
+  line->numOfChunks = 0;
+
+  line->text = (char *) malloc(length + 2);
+  if (line->text == NULL) {
+    return false;
+  }
+  memcpy(line->text, text, length);
+  if (newline == true) {
+    line->text[length++] = '\n';
+  }
+  line->text[length] = '\0';
+  line->length = length;
+
+  source.data = line->text;
+  source.length = length;
+  source.position = 0;
+  while (getSourceLine(&source, chunkText, MAX_LINE_LENGTH + 1) != -1) {
+    numOfChunks++;
+  }
+  if (numOfChunks == 0) {
+    return true;
+  }
+
+  line->chunks = (LineChunk *) calloc(numOfChunks, sizeof(LineChunk));
+  if (line->chunks == NULL) {
+    free(line->text);
+    line->text = NULL;
+    line->length = 0;
+    return false;
+  }
+
+  source.position = 0;
+  for (line->numOfChunks = 0; line->numOfChunks < numOfChunks; line->numOfChunks++) {
+    line->chunks[line->numOfChunks].read = getSourceLine(&source, line->chunks[line->numOfChunks].text,
+                                                         MAX_LINE_LENGTH + 1);
+    parseChunk(&line->chunks[line->numOfChunks]);
+  }
+  return true;
+}
+
+/* Parse chunk by itself - the first pass of the chunk with addresses from 0, and what the directives
+ * pass reads from it. The addresses are given when the chunks are linked.
+ *
+ * Params:
+ * LineChunk *chunk: pointer to the chunk, its text and read are set.
+*/
+void parseChunk(LineChunk *chunk) {
+  char line[MAX_LINE_LENGTH + 1];
+  unsigned long size = 0;
+  LineType type;
+  LineParts *lineParts;
+  char *cmd;
+
+  chunk->checkedVersion = 0;
+  chunk->directive = DIRECTIVE_NONE;
+
+  /* The rest of too long line is not read. */
+  if (chunk->read > MAX_LINE_LENGTH) {
+    return;
+  }
+
+  strcpy(line, chunk->text);
+  type = getLineType(line);
+  if (type == order_line || type == cmd_line) {
+    lineParts = getCommandParts(line);
+    if (lineParts == NULL) {
+      return;
+    }
+    if (lineParts->labelName != NULL) {
+      chunk->label = duplicateStr(lineParts->labelName);
+      chunk->labelAttr = type == order_line ? ATTR_DATA : ATTR_CODE;
+    }
+
+    if (type == order_line) {
+      cmd = lineParts->cmdName;
+      if (strcmp(cmd, ".asciz") == 0) {
+        encodeAscizOrder(&chunk->data, &chunk->lastData, line, &size);
+      } else if (strcmp(cmd, ".extern") != 0 && strcmp(cmd, ".entry") != 0) {
+        encodeOrder(&chunk->data, &chunk->lastData, line, &size);
+      }
+    } else {
+      chunk->command = initNewCommand(line, 0);
+    }
+    freeLinePart(lineParts);
+  }
+
+  strcpy(line, chunk->text);
+  lineParts = getCommandParts(line);
+  if (lineParts == NULL || lineParts->cmdName == NULL) {
+    freeLinePart(lineParts);
+    return;
+  }
+  if (strcmp(lineParts->cmdName, ".extern") == 0) {
+    chunk->directive = DIRECTIVE_EXTERN;
+    chunk->params = duplicateStr(lineParts->params);
+  } else if (strcmp(lineParts->cmdName, ".entry") == 0) {
+    chunk->directive = DIRECTIVE_ENTRY;
+    chunk->params = duplicateStr(lineParts->params);
+  } else {
+    chunk->directive = DIRECTIVE_OTHER;
+  }
+  freeLinePart(lineParts);
+}
+
+/* Free the memory of chunk.
+ *
+ * Params:
+ * LineChunk *chunk: pointer to the chunk.
+*/
+void freeChunk(LineChunk *chunk) {
+  /* The lists of the chunks are linked to each other, free only the items of this chunk. */
+  if (chunk->lastData != NULL) {
+    chunk->lastData->next = NULL;
+    freeDataPicture(&chunk->data);
+  }
+  if (chunk->command != NULL) {
+    chunk->command->next = NULL;
+    freeCommands(&chunk->command);
+  }
+  free(chunk->label);
+  free(chunk->params);
+  free(chunk->operandName);
+}
+
+/* Free the memory of line.
+ *
+ * Params:
+ * SourceLine *line: pointer to the line.
+*/
+void freeSourceLine(SourceLine *line) {
+  int i;
+
+  for (i = 0; i < line->numOfChunks; i++) {
+    freeChunk(&line->chunks[i]);
+  }
+  free(line->chunks);
+  free(line->text);
+}
+
+/* Add '\n' to the end of line that is not the last line of the source, if it is missing.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ * int index: the index of the line (it may be out of the source).
+ *
+ * Returns:
+ * Boolean status: false if there is no memory, otherwise - true.
+*/
+Boolean endSourceLine(IncrementalSource *source, int index) {
+  SourceLine *line;
+  SourceLine oldLine;
+  Boolean status;
+
+  if (index < 0 || index >= source->numOfLines - 1) {
+    return true;
+  }
+  line = &source->lines[index];
+  if (line->length > 0 && line->text[line->length - 1] == '\n') {
+    return true;
+  }
+
+  oldLine = *line;
+  status = setSourceLine(line, oldLine.text, oldLine.length, true);
+  freeSourceLine(&oldLine);
+  return status;
+}
+
+/* Indicate if the text of line is the same as the text.
+ *
+ * Params:
+ * SourceLine *line: pointer to the line.
+ * const char *text: the text.
+ * unsigned long length: the length of the text.
+ *
+ * Returns:
+ * Boolean status: true if the texts are the same, otherwise - false.
+*/
+Boolean isLineEqual(SourceLine *line, const char *text, unsigned long length) {
+  if (line->length == length && (length == 0 || memcmp(line->text, text, length) == 0)) {
+    return true;
+  }
+  return false;
+}
+
+/* Pass 1 of the resident chunks - add the labels to the labels table, give addresses to the commands
+ * and to the data items, and link them into the commands list and the data picture.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ * Command **commands: pointer to the commands list.
+ * DataItem **dataPicture: pointer to the data picture.
+*/
+void linkChunks(IncrementalSource *source, Command **commands, DataItem **dataPicture) {
+  AssemblerContext *context = &source->context;
+  Command **commandsTail = commands;
+  DataItem **dataTail = dataPicture;
+  DataItem *item;
+  LineChunk *chunk;
+  Error *error;
+  int i, j;
+
+  for (i = 0; i < source->numOfLines; i++) {
+    for (j = 0; j < source->lines[i].numOfChunks; j++) {
+      chunk = &source->lines[i].chunks[j];
+      chunk->linked = false;
+
+      /* The rest of too long line is not read. */
+      if (context->skipLine == true) {
+        context->skipLine = false;
+        continue;
+      }
+
+      context->numOfLines++;
+      if (chunk->read > MAX_LINE_LENGTH) {
+        error = initNewError("line length is over than 80. \n", context->numOfLines);
+        addNewError(&context->errors, &context->lastError, error);
+        context->numOfErrors++;
+        context->skipLine = true;
+        continue;
+      }
+      chunk->linked = true;
+
+      if (chunk->label != NULL) {
+        addNewLabel(&context->labels, chunk->label, chunk->labelAttr == ATTR_DATA ? context->DC : context->IC,
+                    chunk->labelAttr);
+      }
+      if (chunk->command != NULL) {
+        chunk->command->address = context->IC;
+        chunk->command->lineNumber = context->numOfLines;
+        *commandsTail = chunk->command;
+        commandsTail = &chunk->command->next;
+        context->IC += 4;
+      }
+      if (chunk->data != NULL) {
+        *dataTail = chunk->data;
+        for (item = chunk->data;; item = item->next) {
+          item->address = context->DC;
+          item->lineNumber = context->numOfLines;
+          context->DC += item->size;
+          if (item == chunk->lastData) {
+            break;
+          }
+        }
+        dataTail = &chunk->lastData->next;
+      }
+    }
+  }
+  *commandsTail = NULL;
+  *dataTail = NULL;
+}
+
+/* Mark each label that pass to entry/external directive, like passDirectives.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+*/
+void passChunkDirectives(IncrementalSource *source) {
+  AssemblerContext *context = &source->context;
+  LabelTable *labels = &context->labels;
+  char errorMsg[MAX_LINE_LENGTH + 100];
+  Boolean skip = false;
+  int numOfLines = 0;
+  Error *error;
+  LineChunk *chunk;
+  int i, j;
+
+  for (i = 0; i < source->numOfLines; i++) {
+    for (j = 0; j < source->lines[i].numOfChunks; j++) {
+      chunk = &source->lines[i].chunks[j];
+      if (skip == true) {
+        skip = false;
+        continue;
+      }
+      if (chunk->read > MAX_LINE_LENGTH) {
+        numOfLines++;
+        skip = true;
+        continue;
+      }
+      if (chunk->directive == DIRECTIVE_NONE) {
+        continue;
+      }
+      /* Directive without label - the validation reports it. */
+      if (chunk->params == NULL) {
+        numOfLines++;
+        continue;
+      }
+
+      if (chunk->directive == DIRECTIVE_EXTERN) {
+        if (isLabelExists(labels, chunk->params) == true) {
+          sprintf(errorMsg, "The label: %s, label that exist this file could not be external! \n", chunk->params);
+          error = initNewError(errorMsg, numOfLines);
+          addNewError(&context->errors, &context->lastError, error);
+          context->numOfErrors++;
+          numOfLines++;
+          continue;
+        }
+        addNewLabel(labels, chunk->params, 0, ATTR_EXTERNAL);
+      } else if (chunk->directive == DIRECTIVE_ENTRY) {
+        markLabelAsEntry(labels, chunk->params);
+      }
+      numOfLines++;
+    }
+  }
+}
+
+/* Validate the chunks like validateFile. The result of each chunk is kept with the version of the
+ * labels names, and it is checked again only when it is new or when the names were changed.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+*/
+void validateChunks(IncrementalSource *source) {
+  AssemblerContext *context = &source->context;
+  LabelTable *labels = &context->labels;
+  char line[MAX_LINE_LENGTH + 1];
+  Boolean skip = false;
+  int numOfLines = 0;
+  Error *error;
+  LineChunk *chunk;
+  int i, j;
+
+  if (source->checkedLabels.length != labels->namesLength ||
+      (labels->namesLength > 0 && memcmp(source->checkedLabels.data, labels->names, labels->namesLength) != 0)) {
+    source->labelsVersion++;
+    resetBuffer(&source->checkedLabels);
+    appendBuffer(&source->checkedLabels, labels->names, labels->namesLength);
+  }
+
+  for (i = 0; i < source->numOfLines; i++) {
+    for (j = 0; j < source->lines[i].numOfChunks; j++) {
+      chunk = &source->lines[i].chunks[j];
+      if (skip == true) {
+        skip = false;
+        continue;
+      }
+      numOfLines++;
+      if (chunk->read > MAX_LINE_LENGTH) {
+        skip = true;
+        continue;
+      }
+
+      if (chunk->checkedVersion != source->labelsVersion) {
+        strcpy(line, chunk->text);
+        chunk->check = checkLine(line, labels);
+        chunk->checkedVersion = source->labelsVersion;
+      }
+      if (chunk->check != valid) {
+        error = initNewError(getMessageErrorType(chunk->check), numOfLines);
+        addNewError(&context->errors, &context->lastError, error);
+        context->numOfErrors++;
+      }
+    }
+  }
+}
+
+/* Pass 2 of command of chunk - encode it, unless its encoding does not depend on what was changed:
+ * its own address and the value of the label that it refers to.
+ *
+ * Params:
+ * LineChunk *chunk: pointer to the chunk of the command.
+ * LabelTable *labels: labels table.
+*/
+void encodeChunkCommand(LineChunk *chunk, LabelTable *labels) {
+  Command *command = chunk->command;
+  SymbolId id;
+
+  if (command->bits != NULL) {
+    if (chunk->operandName == NULL) {
+      return;
+    }
+    id = findLabel(labels, chunk->operandName);
+    if (id != NO_SYMBOL && labels->items[id].value == chunk->operandValue &&
+        command->address == chunk->encodedAddress) {
+      command->operand = id;
+      return;
+    }
+    command->bits = NULL;
+  }
+
+  command->operand = NO_SYMBOL;
+  if (command->type == r_cmd) {
+    encodeRCmd(command);
+  } else if (command->type == i_cmd) {
+    encodeICmd(command, labels);
+  } else if (command->type == j_cmd) {
+    encodeJCmd(command, labels);
+  }
+
+  free(chunk->operandName);
+  chunk->operandName = NULL;
+  if (command->operand != NO_SYMBOL) {
+    chunk->operandName = duplicateStr(getLabelName(labels, command->operand));
+    chunk->operandValue = labels->items[command->operand].value;
+  }
+  chunk->encodedAddress = command->address;
+}
+
+/* Create the listing from the resident chunks, like createListingFile does from the source.
+ *
+ * Params:
+ * IncrementalSource *source: pointer to the source.
+ * Command **commands: pointer to the commands list (after pass 2).
+ * DataItem **dataPicture: pointer to the data picture (with the addresses after ICF).
+ * unsigned long IDF: the end of the data picture image.
+*/
+void writeChunksListing(IncrementalSource *source, Command **commands, DataItem **dataPicture, unsigned long IDF) {
+  AssemblerContext *context = &source->context;
+  ListingCursor cursor;
+  LineChunk *chunk;
+  int lineNumber = 0;
+  int i, j;
+
+  beginListingFile(&context->outputs, &cursor, commands, dataPicture, IDF, context->numOfLines);
+  for (i = 0; i < source->numOfLines; i++) {
+    for (j = 0; j < source->lines[i].numOfChunks; j++) {
+      chunk = &source->lines[i].chunks[j];
+      if (chunk->linked == true) {
+        lineNumber++;
+        writeListingLine(&context->outputs, &cursor, lineNumber, chunk->text, chunk->read - 1);
+      }
+    }
+  }
+  endListingFile(&context->outputs, &context->labels);
+}
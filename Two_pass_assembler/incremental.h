@@ -0,0 +1,70 @@
+#ifndef MAMAN14_INCREMENTAL_H
+#define MAMAN14_INCREMENTAL_H
+
+#include "libassembler.h"
+
+/*
+ * Incremental reassembly of source that is edited line by line (like in an editor).
+ * The source stays resident with the result of every line: its label, its data items, its command
+ * and encoding, and its validation. An edit parses only the lines that it replaced, and the
+ * reassembly only links the lines again - the addresses are moved, commands are encoded again only
+ * when their own address or the value of the label that they refer to was changed, and the lines
+ * are validated again only when the names of the labels were changed.
+ * The outputs and the errors are the same as assembling the whole source from the beginning.
+ */
+
+/* What the directives pass reads from chunk of line. */
+#define DIRECTIVE_NONE 0
+#define DIRECTIVE_OTHER 1
+#define DIRECTIVE_EXTERN 2
+#define DIRECTIVE_ENTRY 3
+
+/* Data structure representing the result of one chunk of line, as getSourceLine reads it. */
+typedef struct lineChunk {
+    char text[MAX_LINE_LENGTH + 1];
+    int read;
+    char *label;
+    Attributes labelAttr;
+    int directive;
+    char *params;
+    Command *command;
+    DataItem *data;
+    DataItem *lastData;
+    Boolean linked;
+    unsigned long checkedVersion;
+    ErrorType check;
+    char *operandName;
+    unsigned long operandValue;
+    unsigned long encodedAddress;
+} LineChunk;
+
+/* Data structure representing line of the source (with its '\n'). */
+typedef struct sourceLine {
+    char *text;
+    unsigned long length;
+    LineChunk *chunks;
+    int numOfChunks;
+} SourceLine;
+
+/* Data structure representing resident source and the context that holds its outputs and errors. */
+typedef struct incrementalSource {
+    AssemblerContext context;
+    SourceLine *lines;
+    int numOfLines;
+    int linesCapacity;
+    /* The names of the labels that the lines are validated with, and their version. */
+    Buffer checkedLabels;
+    unsigned long labelsVersion;
+} IncrementalSource;
+
+void initIncrementalSource(IncrementalSource *source);
+
+void freeIncrementalSource(IncrementalSource *source);
+
+Boolean replaceSourceLines(IncrementalSource *source, int first, int count, const char *text, unsigned long length);
+
+Boolean loadIncrementalSource(IncrementalSource *source, const char *data, unsigned long length);
+
+AssemblerStatus reassembleSource(IncrementalSource *source);
+
+#endif
@@ -0,0 +1,663 @@
+#include "libassembler.h"
+#include "parserInput.h"
+#include "encoding.h"
+#include "validation.h"
+#include "symbolFile.h"
+#include "report.h"
+#include "listing.h"
+#include "debugFile.h"
+
+char *phaseNames[NUM_OF_PHASES] = {
+    "read", "pass1", "directives", "validate", "pass2", "externals",
+    "object", "entries", "externals_file", "symbols", "report", "listing", "debug", "save"
+};
+
+void splitLines(AssemblerContext *context, const char *data, unsigned long length);
+
+void flushLine(AssemblerContext *context);
+
+void passLine(AssemblerContext *context, int read);
+
+void passDirectives(LabelTable *labels, Error **errors, Error **lastError, int *numOfErrors, Source *source);
+
+AssemblerStatus completeSource(AssemblerContext *context, const char *data, unsigned long length);
+
+void validateFile(Source *source, Error **errors, Error **lastError, LabelTable *labels, int *numOfErrors);
+
+void pass2(Command **commands, LabelTable *labels, Error **errors, Error **lastError, int *numOfErrors);
+
+/* Initialize the context of the assembler.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+*/
+void initAssemblerContext(AssemblerContext *context) {
+  initLabelTable(&context->labels);
+  initOutputs(&context->outputs);
+  initBuffer(&context->text);
+  context->errors = NULL;
+  context->commands = NULL;
+  context->dataPicture = NULL;
+  context->sym = false;
+  context->report = false;
+  context->listing = false;
+  context->debug = false;
+  context->check = false;
+  context->phaseHook = NULL;
+  context->phaseData = NULL;
+  resetAssemblerContext(context);
+}
+
+/* Empty the outputs and the errors of the last source (or the source that is fed), but keep
+ * the memory for the next one.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+*/
+void resetAssemblerContext(AssemblerContext *context) {
+  resetLabelTable(&context->labels);
+  resetOutputs(&context->outputs);
+  resetBuffer(&context->text);
+  freeErrors(&context->errors);
+  freeCommands(&context->commands);
+  freeDataPicture(&context->dataPicture);
+  context->lastCommand = NULL;
+  context->lastData = NULL;
+  context->lastError = NULL;
+  context->numOfErrors = 0;
+  context->lineLength = 0;
+  context->numOfLines = 0;
+  context->skipLine = false;
+  context->IC = 100;
+  context->DC = 0;
+}
+
+/* Free all the memory of the context (but not memory that the caller attached to the outputs).
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+*/
+void freeAssemblerContext(AssemblerContext *context) {
+  resetAssemblerContext(context);
+  freeLabelTable(&context->labels);
+  freeOutputs(&context->outputs);
+  freeBuffer(&context->text);
+}
+
+/* Assemble source from memory - run both passes and create the contents of the output files in the
+ * context, or the list of the errors of the source. The previous outputs of the context are replaced.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * const char *data: the source (does not have to end with '\0').
+ * unsigned long length: the length of the source in bytes.
+ *
+ * Returns:
+ * AssemblerStatus status: assembled, source_errors if the source has errors (there are no outputs),
+ *                         or output_overflow if attached output memory was too small for the outputs.
+*/
+AssemblerStatus assembleSource(AssemblerContext *context, const char *data, unsigned long length) {
+  resetAssemblerContext(context);
+  reportPhase(context, pass1_phase, true);
+  splitLines(context, data, length);
+  flushLine(context);
+  reportPhase(context, pass1_phase, false);
+  return completeSource(context, data, length);
+}
+
+/* Start new source that is fed in chunks, the previous outputs of the context are removed.
+ * The pass 1 phase begins here and ends in finishSource, so it is reported once for the source
+ * and not for every chunk or line.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+*/
+void beginSource(AssemblerContext *context) {
+  resetAssemblerContext(context);
+  reportPhase(context, pass1_phase, true);
+}
+
+/* Feed the next chunk of the source, the chunk may end in the middle of line.
+ * The first pass runs on every line that is completed by the chunk.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * const char *data: the chunk.
+ * unsigned long length: the length of the chunk in bytes.
+*/
+void feedSource(AssemblerContext *context, const char *data, unsigned long length) {
+  /* The source is kept for the checks that need the whole labels table. */
+  appendBuffer(&context->text, data, length);
+  splitLines(context, data, length);
+}
+
+/* Feed the next line of the source, that is cut like getSourceLine cuts it - until '\n', but not
+ * more than MAX_LINE_LENGTH chars. Longer line is cut here into pieces of MAX_LINE_LENGTH chars, the
+ * same pieces that getSourceLine gives. The first pass runs on every piece.
+ * It cannot be mixed with feedSource in the same source.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * const char *line: the line (does not have to end with '\0').
+ * int length: the length of the line in bytes.
+*/
+void feedSourceLine(AssemblerContext *context, const char *line, int length) {
+  int offset = 0, piece;
+
+  appendBuffer(&context->text, line, length);
+  do {
+    piece = length - offset > MAX_LINE_LENGTH ? MAX_LINE_LENGTH : length - offset;
+    memcpy(context->line, line + offset, piece);
+    context->line[piece] = '\0';
+    passLine(context, piece + 1);
+    offset += piece;
+  } while (offset < length);
+}
+
+/* End the source that was fed - run the first pass on its last line, resolve the labels
+ * and create the outputs, like assembleSource does with the whole source.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ *
+ * Returns:
+ * AssemblerStatus status: the same as assembleSource.
+*/
+AssemblerStatus finishSource(AssemblerContext *context) {
+  flushLine(context);
+  reportPhase(context, pass1_phase, false);
+  /* The checks that need the whole labels table read the kept source, without it the source fails. */
+  if (context->text.overflow == true) {
+    addNewError(&context->errors, &context->lastError, initNewError("source too large, it could not be kept in memory. \n",
+                                               context->numOfLines));
+    context->numOfErrors++;
+  }
+  return completeSource(context, context->text.data, context->text.length);
+}
+
+/* Cut the chunk into the lines that pass 1 reads (like getSourceLine does - until '\n', but not
+ * more than MAX_LINE_LENGTH chars), and run the first pass on every completed line.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * const char *data: the chunk.
+ * unsigned long length: the length of the chunk in bytes.
+*/
+void splitLines(AssemblerContext *context, const char *data, unsigned long length) {
+  unsigned long i;
+  char c;
+
+  for (i = 0; i < length; i++) {
+    c = data[i];
+    context->line[context->lineLength++] = c;
+    if (c == '\n' || context->lineLength == MAX_LINE_LENGTH) {
+      context->line[context->lineLength] = '\0';
+      passLine(context, context->lineLength + 1);
+      context->lineLength = 0;
+    }
+  }
+}
+
+/* Run the first pass on the last line of the source, if it does not end with '\n'.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+*/
+void flushLine(AssemblerContext *context) {
+  if (context->lineLength > 0) {
+    context->line[context->lineLength] = '\0';
+    passLine(context, context->lineLength + 1);
+    context->lineLength = 0;
+  }
+}
+
+/* Resolve the labels of the source after pass 1 read all of it, validate it and create the outputs
+ * (with context->check, only check the ranges of the labels of the commands).
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * const char *data: the whole source.
+ * unsigned long length: the length of the source in bytes.
+ *
+ * Returns:
+ * AssemblerStatus status: the same as assembleSource.
+*/
+AssemblerStatus completeSource(AssemblerContext *context, const char *data, unsigned long length) {
+  LabelTable *labels = &context->labels;
+  Outputs *outputs = &context->outputs;
+  Source source;
+  unsigned long ICF;
+  unsigned long DCF;
+  AssemblerStatus status = source_errors;
+
+  source.data = data;
+  source.length = length;
+  source.position = 0;
+
+  reportPhase(context, directives_phase, true);
+  passDirectives(labels, &context->errors, &context->lastError, &context->numOfErrors, &source);
+  /* add each data label ICF */
+  updateDataLabels(labels, context->IC);
+  reportPhase(context, directives_phase, false);
+  reportPhase(context, validate_phase, true);
+  validateFile(&source, &context->errors, &context->lastError, labels, &context->numOfErrors);
+  reportPhase(context, validate_phase, false);
+  ICF = context->IC;
+  DCF = context->DC + ICF;
+
+  if (context->numOfErrors == 0) {
+    reportPhase(context, pass2_phase, true);
+    updateDataPictureAddress(&context->dataPicture, ICF);
+    pass2(&context->commands, labels, &context->errors, &context->lastError, &context->numOfErrors);
+    reportPhase(context, pass2_phase, false);
+  }
+
+  if (context->numOfErrors == 0 && context->check == true) {
+    status = assembled;
+  } else if (context->numOfErrors == 0) {
+    reportPhase(context, externals_phase, true);
+    updateExternalAppearancesLabels(&context->commands, labels);
+    reportPhase(context, externals_phase, false);
+    reportPhase(context, object_phase, true);
+    createObjectFile(outputs, &context->commands, &context->dataPicture, ICF, DCF);
+    reportPhase(context, object_phase, false);
+    reportPhase(context, entries_phase, true);
+    createEntryFile(outputs, labels);
+    reportPhase(context, entries_phase, false);
+    reportPhase(context, externals_file_phase, true);
+    createExternalFile(outputs, labels);
+    reportPhase(context, externals_file_phase, false);
+    if (context->sym == true) {
+      reportPhase(context, symbols_phase, true);
+      createSymbolFile(outputs, labels);
+      reportPhase(context, symbols_phase, false);
+    }
+    if (context->report == true) {
+      reportPhase(context, report_phase, true);
+      createReportFile(outputs, &context->commands, &context->dataPicture, labels);
+      reportPhase(context, report_phase, false);
+    }
+    if (context->listing == true) {
+      reportPhase(context, listing_phase, true);
+      createListingFile(outputs, &context->commands, &context->dataPicture, labels, DCF, context->numOfLines, data,
+                        length);
+      reportPhase(context, listing_phase, false);
+    }
+    if (context->debug == true) {
+      reportPhase(context, debug_phase, true);
+      createDebugFile(outputs, &context->commands, &context->dataPicture, ICF, DCF);
+      reportPhase(context, debug_phase, false);
+    }
+    status = isOutputOverflowed(outputs) == true ? output_overflow : assembled;
+  }
+
+  freeCommands(&context->commands);
+  freeDataPicture(&context->dataPicture);
+  context->lastCommand = NULL;
+  context->lastData = NULL;
+  return status;
+}
+
+/* Call the phase hook of the context, if it has one.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context.
+ * AssemblerPhase phase: the phase.
+ * Boolean begin: true at the begin of the phase, false at its end.
+*/
+void reportPhase(AssemblerContext *context, AssemblerPhase phase, Boolean begin) {
+  if (context->phaseHook != NULL) {
+    context->phaseHook(context->phaseData, phase, begin);
+  }
+}
+
+/* Indicate if one of the output buffers could not hold its content.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ *
+ * Returns:
+ * Boolean status: true if any output is missing part of its content, otherwise - false.
+*/
+Boolean isOutputOverflowed(Outputs *outputs) {
+  if (outputs->object.overflow == true || outputs->entries.overflow == true ||
+      outputs->externals.overflow == true || outputs->symbols.overflow == true ||
+      outputs->report.overflow == true || outputs->listing.overflow == true ||
+      outputs->debug.overflow == true) {
+    return true;
+  }
+  return false;
+}
+
+/* Get next line from source.
+ *
+ * Params:
+ * Source *source: pointer to the source.
+ * char *line: array to copy the line into it.
+ * size_t length: max number of read from the line (read until \n but if the line length is more than length, read length chars).
+ *
+ * Returns:
+ * int length: num of char readed in the line.
+*/
+int getSourceLine(Source *source, char *line, int length) {
+  int cnt;
+  int c = 0;
+
+  if (length == 0)
+    return 0;
+
+  for (cnt = 0; c != '\n' && cnt < length - 1; cnt++) {
+    if (source->position == source->length) {
+      if (cnt == 0)
+        return -1;
+      break;
+    }
+    c = (unsigned char) source->data[source->position++];
+
+      line[cnt] = (char) c;
+  }
+    line[cnt] = '\0';
+  return cnt + 1;
+}
+
+/* Pass 1 of the assembler for one line - add its label to the labels table, and encode the orders.
+ * The entries and the externals are marked later by passDirectives, when all the labels are known.
+ *
+ * Params:
+ * AssemblerContext *context: pointer to the context, the line is in context->line.
+ * int read: the length of the line + 1 (like getSourceLine returns).
+*/
+void passLine(AssemblerContext *context, int read) {
+  LineType type;
+  char *labelName;
+  char *cmd;
+  char *line = context->line;
+  Command *command;
+  DataItem *last, *item;
+  Error *error;
+  char storage[LINE_PARTS_SIZE];
+  LineParts lineParts;
+
+  /* The rest of too long line is not read. */
+  if (context->skipLine == true) {
+    context->skipLine = false;
+    return;
+  }
+
+  if (read > MAX_LINE_LENGTH) {
+    context->numOfLines++;
+    error = initNewError("line length is over than 80. \n", context->numOfLines);
+    addNewError(&context->errors, &context->lastError, error);
+    context->numOfErrors++;
+    context->skipLine = true;
+    return;
+  }
+  type = getLineType(line);
+  if (type == invalid_line) {
+    context->numOfLines++;
+    return;
+  }
+  if (type == blank_line || type == comment_line) {
+    context->numOfLines++;
+    return;
+  } else {
+    /* The parts are cut in a copy on the stack. */
+    if (splitCommandParts(line, &lineParts, storage, sizeof(storage)) == false) {
+      context->numOfLines++;
+      return;
+    }
+    labelName = lineParts.labelName;
+    if (labelName != NULL) {
+      if (type == order_line) {
+        addNewLabel(&context->labels, labelName, context->DC, ATTR_DATA);
+      } else if (type == cmd_line) {
+        addNewLabel(&context->labels, labelName, context->IC, ATTR_CODE);
+      }
+    }
+
+    if (type == order_line) {
+      cmd = lineParts.cmdName;
+      if (strcmp(cmd, ".extern") == 0 || strcmp(cmd, ".entry") == 0) {
+        context->numOfLines++;
+        return;
+      }
+      if (context->check == true) {
+        context->DC += getOrderSize(cmd, lineParts.params);
+        context->numOfLines++;
+        return;
+      }
+      last = context->lastData;
+      if (strcmp(cmd, ".asciz") == 0) {
+        encodeAscizOrder(&context->dataPicture, &context->lastData, line, &context->DC);
+      } else {
+        encodeOrder(&context->dataPicture, &context->lastData, line, &context->DC);
+      }
+      /* The new items take the line number of the order, for the listing. */
+      for (item = last == NULL ? context->dataPicture : last->next; item != NULL; item = item->next) {
+        item->lineNumber = context->numOfLines + 1;
+      }
+    } else if (type == cmd_line) {
+      /* Only the commands that refer to labels are kept by the check, for the ranges of pass 2. */
+      if (context->check == false ||
+          (lineParts.params != NULL &&
+           (sortCmd(lineParts.cmdName) == i_branch_cmd || getCmdTypeByCommandName(lineParts.cmdName) == j_cmd))) {
+        command = initNewCommand(line, context->IC);
+        if (command != NULL) {
+          command->lineNumber = context->numOfLines + 1;
+        }
+        addNewCommand(&context->commands, &context->lastCommand, command);
+      }
+      context->IC += 4;
+    }
+  }
+  context->numOfLines++;
+}
+
+/* Read line by line, and mark each label that pass to entry/external command.
+ *
+ * Params:
+ * LabelTable *labels: labels table.
+ * Error **errors: pointer to errors linked list.
+ * Error **lastError: pointer to the last error of the list.
+ * int *numOfErrors: pointer to errors list length.
+ * Source *source: pointer to the source.
+*/
+void passDirectives(LabelTable *labels, Error **errors, Error **lastError, int *numOfErrors, Source *source) {
+  int read;
+  size_t len = 81;
+  char *cmd;
+  char *params;
+  Error *error;
+  int numOfLines = 0;
+  char line[81];
+  char storage[LINE_PARTS_SIZE];
+  LineParts lineParts;
+  char *errorMsg = (char *) calloc(100, sizeof(char));
+  if (errorMsg == NULL) {
+    (*numOfErrors)++;
+    return;
+  }
+
+  while ((read = getSourceLine(source, line, len)) != -1) {
+    if (read > MAX_LINE_LENGTH) {
+      numOfLines++;
+      read = getSourceLine(source, line, MAX_LINE_LENGTH + 1);
+      continue;
+    }
+    /* Blank line has no parts, they are cut in a copy on the stack. */
+    if (splitCommandParts(line, &lineParts, storage, sizeof(storage)) == false) {
+      continue;
+    }
+    cmd = lineParts.cmdName;
+    if (cmd == NULL) {
+      continue;
+    }
+
+    params = lineParts.params;
+    /* Directive without label - the validation reports it. */
+    if (params == NULL) {
+      numOfLines++;
+      continue;
+    }
+    if (strcmp(cmd, ".extern") == 0) {
+      if (isLabelExists(labels, params) == true) {
+        sprintf(errorMsg, "The label: %s, label that exist this file could not be external! \n", params);
+        error = initNewError(errorMsg, numOfLines);
+        addNewError(errors, lastError, error);
+        (*numOfErrors)++;
+        numOfLines++;
+        continue;
+      }
+      addNewLabel(labels, params, 0, ATTR_EXTERNAL);
+    } else if (strcmp(cmd, ".entry") == 0) {
+      markLabelAsEntry(labels, params);
+    }
+    numOfLines++;
+  }
+  free(errorMsg);
+}
+
+/* Pass 2 - encoded each command in the linked list, and report the commands whose label does not fit
+ * their encoding.
+ *
+ * Params:
+ * Command **commands: linked list of commands.
+ * LabelTable *labels: labels table.
+ * Error **errors: pointer to errors linked list.
+ * Error **lastError: pointer to the last error of the list.
+ * int *numOfErrors: pointer to errors list length.
+*/
+void pass2(Command **commands, LabelTable *labels, Error **errors, Error **lastError, int *numOfErrors) {
+  Command *head = *commands;
+  ErrorType errorType;
+
+  while (head != NULL) {
+    if (head->type == r_cmd) {
+      encodeRCmd(head);
+    } else if (head->type == i_cmd) {
+      encodeICmd(head, labels);
+    } else if (head->type == j_cmd) {
+      encodeJCmd(head, labels);
+    }
+    errorType = checkCommandRange(head, labels);
+    if (errorType != valid) {
+      addNewError(errors, lastError, initNewError(getMessageErrorType(errorType), head->lineNumber));
+      (*numOfErrors)++;
+    }
+    head = head->next;
+  }
+}
+
+/* Update the addresses of data picture by adding ICF.
+ *
+ * Params:
+ * DataItem **dataPicture: pointer to data picture linked list.
+ * unsigned long ICF: value of the last address in command picture.
+*/
+void updateDataPictureAddress(DataItem **dataPicture, unsigned long ICF) {
+  DataItem *head = *dataPicture;
+  while (head != NULL) {
+    head->address += ICF;
+    head = head->next;
+  }
+}
+
+/* Read line by line from file, and if it is commandLine / orderLine validate the content.
+ *
+ * Params:
+ * Source *source: pointer to the source.
+ * Error **error: pointer to errors table.
+ * Error **lastError: pointer to the last error of the table.
+ * LabelTable *labels: pointer to labels table.
+ * int numOfLabels: labels table length.
+ * int *numOfErrors: pointer to errors table length.
+*/
+void validateFile(Source *source, Error **errors, Error **lastError, LabelTable *labels, int *numOfErrors) {
+  int numOfLines = 0;
+  int read;
+  ErrorType errorType;
+  Error *error;
+  char *line = (char *) calloc(MAX_LINE_LENGTH + 1, sizeof(char));
+
+  if (line == NULL) {
+    (*numOfErrors)++;
+    return;
+  }
+  source->position = 0;
+
+  while ((read = getSourceLine(source, line, MAX_LINE_LENGTH + 1)) != -1) {
+    if (read > MAX_LINE_LENGTH) {
+      numOfLines++;
+      read = getSourceLine(source, line, MAX_LINE_LENGTH + 1);
+      continue;
+    }
+    numOfLines++;
+    errorType = checkLine(line, labels);
+    if (errorType != valid) {
+      error = initNewError(getMessageErrorType(errorType), numOfLines);
+      addNewError(errors, lastError, error);
+      (*numOfErrors)++;
+    }
+  }
+  free(line);
+}
+
+
+/* Free all command nodes from commands linked list.
+ *
+ * Params:
+ * Command **commands: pointer to commands linked list.
+*/
+void freeCommands(Command **commands) {
+  Command *currentCommand;
+
+  if (commands == NULL) {
+    return;
+  }
+
+  while (*commands) {
+    currentCommand = *commands;
+    *commands = (*commands)->next;
+    free(currentCommand->line);
+    free(currentCommand);
+  }
+}
+
+/* Free all errors nodes from errors linked list.
+ *
+ * Params:
+ * Error **errors: pointer to errors linked list.
+*/
+void freeErrors(Error **errors) {
+  Error *currentError;
+
+  if (errors == NULL) {
+    return;
+  }
+
+  while (*errors) {
+    currentError = *errors;
+    *errors = (*errors)->next;
+    free(currentError->message);
+    free(currentError);
+  }
+}
+
+/* Free all data items nodes from data picture linked list.
+ *
+ * Params:
+ * DataItem **dataPicture: pointer to data picture linked list.
+*/
+void freeDataPicture(DataItem **dataPicture) {
+  DataItem *currentDataItem;
+
+  if (dataPicture == NULL) {
+    return;
+  }
+
+  while (*dataPicture) {
+    currentDataItem = *dataPicture;
+    *dataPicture = (*dataPicture)->next;
+    free(currentDataItem);
+  }
+}
@@ -0,0 +1,128 @@
+#ifndef MAMAN14_LIBASSEMBLER_H
+#define MAMAN14_LIBASSEMBLER_H
+
+#include "Datatypes.h"
+#include "buffer.h"
+#include "files.h"
+
+/*
+ * Reentrant assembler library - assembles sources from memory into memory.
+ * It keeps no global state and never writes to stdio or to files, so every thread can assemble
+ * with its own context at the same time.
+ *
+ * The outputs of the last source stay in the context until the next source is assembled:
+ * outputs.object, outputs.entries, outputs.externals (and outputs.symbols when sym is true,
+ * outputs.report when report is true, outputs.listing when listing is true, and outputs.debug when
+ * debug is true) hold the contents of the .ob, .ent, .ext (and .sym, .json, .lst, .dbg) files, and errors is list of the errors of the source
+ * by their lines. The output buffers are owned by the library, unless the caller attaches its own
+ * memory to them with attachBuffer.
+ *
+ * Source that arrives in chunks can be fed instead: beginSource, feedSource for every chunk (it may
+ * end in the middle of line, the first pass runs on the lines as they are completed), and finishSource
+ * to resolve the labels and create the outputs. Source that is already cut into lines is fed
+ * with feedSourceLine instead of feedSource (line longer than MAX_LINE_LENGTH chars is cut there
+ * into the pieces that getSourceLine gives).
+ */
+
+#define MAX_LINE_LENGTH 80
+
+/* The phases of assembling source. read_phase and save_phase are of the caller (the library does not
+ * read or write files), it can report them with reportPhase. */
+typedef enum {
+    read_phase,
+    pass1_phase,
+    directives_phase,
+    validate_phase,
+    pass2_phase,
+    externals_phase,
+    object_phase,
+    entries_phase,
+    externals_file_phase,
+    symbols_phase,
+    report_phase,
+    listing_phase,
+    debug_phase,
+    save_phase
+} AssemblerPhase;
+
+#define NUM_OF_PHASES (save_phase + 1)
+
+extern char *phaseNames[NUM_OF_PHASES];
+
+/* Function that is called at the begin and at the end of every phase. */
+typedef void (*PhaseHook)(void *data, AssemblerPhase phase, Boolean begin);
+
+/* Data structure representing the memory that is kept warm between assembled sources. */
+typedef struct assemblerContext {
+    LabelTable labels;
+    Outputs outputs;
+    Error *errors;
+    int numOfErrors;
+    Boolean sym;
+    Boolean report;
+    Boolean listing;
+    Boolean debug;
+    /* Check the source only: the images are not built, pass 2 only checks the ranges of the labels,
+     * and there are no outputs. */
+    Boolean check;
+    /* The state of pass 1 while the source is fed. */
+    Buffer text;
+    char line[MAX_LINE_LENGTH + 1];
+    int lineLength;
+    int numOfLines;
+    Boolean skipLine;
+    Command *commands;
+    DataItem *dataPicture;
+    /* The last nodes of the lists, so they are appended without walking them. */
+    Command *lastCommand;
+    DataItem *lastData;
+    Error *lastError;
+    unsigned long IC;
+    unsigned long DC;
+    /* Optional hook for profiling, NULL when it is not used. */
+    PhaseHook phaseHook;
+    void *phaseData;
+} AssemblerContext;
+
+/* Data structure representing source in memory that is read line by line. */
+typedef struct source {
+    const char *data;
+    unsigned long length;
+    unsigned long position;
+} Source;
+
+typedef enum {
+    assembled, source_errors, output_overflow
+} AssemblerStatus;
+
+void initAssemblerContext(AssemblerContext *context);
+
+void resetAssemblerContext(AssemblerContext *context);
+
+void freeAssemblerContext(AssemblerContext *context);
+
+AssemblerStatus assembleSource(AssemblerContext *context, const char *data, unsigned long length);
+
+void beginSource(AssemblerContext *context);
+
+void feedSource(AssemblerContext *context, const char *data, unsigned long length);
+
+void feedSourceLine(AssemblerContext *context, const char *line, int length);
+
+AssemblerStatus finishSource(AssemblerContext *context);
+
+int getSourceLine(Source *source, char *line, int length);
+
+void reportPhase(AssemblerContext *context, AssemblerPhase phase, Boolean begin);
+
+void freeErrors(Error **errors);
+
+void freeCommands(Command **commands);
+
+void freeDataPicture(DataItem **dataPicture);
+
+void updateDataPictureAddress(DataItem **dataPicture, unsigned long ICF);
+
+Boolean isOutputOverflowed(Outputs *outputs);
+
+#endif
@@ -0,0 +1,393 @@
+#include "objectFile.h"
+#include "diskFiles.h"
+#include "validation.h"
+
+/* Data structure representing one module of the link - the outputs of the assembler for one source,
+ * and the places of its code and of its data in the linked image. */
+typedef struct linkModule {
+    char *name;
+    ObjectImage image;
+    ObjectSymbols entries;
+    ObjectSymbols externals;
+    unsigned long codeBase;
+    unsigned long dataBase;
+} LinkModule;
+
+Boolean loadLinkModule(LinkModule *module, char *name);
+
+unsigned long mapModuleAddress(LinkModule *module, unsigned long address);
+
+int addModuleEntries(LabelTable *symbols, int *symbolModules, LinkModule *modules, int numOfModules);
+
+void printEntryModules(LinkModule *modules, int numOfModules, char *name);
+
+int relocateModule(ObjectImage *linked, LinkModule *module, LabelTable *symbols, CmdSubtype *kinds, int width);
+
+void writeLinkMap(Buffer *buffer, LinkModule *modules, int numOfModules, LabelTable *symbols, int *symbolModules,
+                  int width);
+
+/*
+ * Linker of the outputs of the assembler into one image. The code of all the modules comes first, in
+ * the order of the arguments from address 100, and then their data in the same order. The addresses
+ * of the J commands and the distances of the branches are moved with their modules, and every
+ * reference of .ext file is resolved by the .ent files of the other modules. The image is written
+ * in the format of .ob file, with .map file of the modules and of the global symbols next to it.
+ *
+ * Usage: linker [--output=FILE.ob] a.ob b.ob ...
+ */
+int main(int args, char *argv[]) {
+  char *output = "linked.ob";
+  LinkModule *modules;
+  ObjectImage linked;
+  LabelTable symbols;
+  CmdSubtype kinds[64];
+  Buffer buffer;
+  int *symbolModules;
+  unsigned long base, numOfEntries = 0;
+  int numOfModules = 0, numOfErrors = 0, width, i;
+
+  modules = (LinkModule *) calloc((size_t) args, sizeof(LinkModule));
+  if (modules == NULL) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--output=", 9) == 0) {
+      output = argv[i] + 9;
+    } else if (strncmp(argv[i], "--", 2) == 0) {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    } else {
+      modules[numOfModules++].name = argv[i];
+    }
+  }
+  if (numOfModules == 0) {
+    printf("No file specified!");
+    exit(1);
+  }
+  if (strlen(output) < 3 || strcmp(output + strlen(output) - 3, ".ob") != 0) {
+    fprintf(stderr, "The output is not ob file: %s \n", output);
+    exit(1);
+  }
+
+  for (i = 0; i < numOfModules; i++) {
+    if (loadLinkModule(&modules[i], modules[i].name) == false) {
+      exit(1);
+    }
+  }
+
+  /* The code of the modules one after the other, and then their data. */
+  initObjectImage(&linked);
+  base = IMAGE_BASE;
+  for (i = 0; i < numOfModules; i++) {
+    modules[i].codeBase = base;
+    base += modules[i].image.codeSize;
+  }
+  linked.codeSize = base - IMAGE_BASE;
+  for (i = 0; i < numOfModules; i++) {
+    modules[i].dataBase = base;
+    base += modules[i].image.dataSize;
+  }
+  linked.dataSize = base - IMAGE_BASE - linked.codeSize;
+  linked.bytes = (unsigned char *) calloc(linked.codeSize + linked.dataSize + 1, sizeof(unsigned char));
+  if (linked.bytes == NULL) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+  for (i = 0; i < numOfModules; i++) {
+    memcpy(linked.bytes + (modules[i].codeBase - IMAGE_BASE), modules[i].image.bytes, modules[i].image.codeSize);
+    memcpy(linked.bytes + (modules[i].dataBase - IMAGE_BASE), modules[i].image.bytes + modules[i].image.codeSize,
+           modules[i].image.dataSize);
+  }
+  width = getAddressWidth(base > IMAGE_BASE ? base - 1 : IMAGE_BASE);
+
+  /* The kind of every opcode, by the tables of the commands. */
+  for (i = 0; i < 64; i++) {
+    kinds[i] = r_arithmetic_cmd;
+  }
+  for (i = 0; i < 27; i++) {
+    kinds[opcodes[i]] = sortCmd(commandsTable[i]);
+  }
+
+  /* The module of every global symbol, by its SymbolId. */
+  for (i = 0; i < numOfModules; i++) {
+    numOfEntries += modules[i].entries.length;
+  }
+  symbolModules = (int *) calloc(numOfEntries + 1, sizeof(int));
+  if (symbolModules == NULL) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+
+  initLabelTable(&symbols);
+  numOfErrors += addModuleEntries(&symbols, symbolModules, modules, numOfModules);
+  for (i = 0; i < numOfModules && numOfErrors == 0; i++) {
+    numOfErrors += relocateModule(&linked, &modules[i], &symbols, kinds, width);
+  }
+
+  if (numOfErrors == 0) {
+    initBuffer(&buffer);
+    writeObjectImage(&buffer, &linked);
+    saveOutputFile(output, ".ob", &buffer, true, false);
+    resetBuffer(&buffer);
+    writeLinkMap(&buffer, modules, numOfModules, &symbols, symbolModules, width);
+    saveOutputFile(output, ".map", &buffer, true, false);
+    freeBuffer(&buffer);
+  }
+
+  freeLabelTable(&symbols);
+  free(symbolModules);
+  freeObjectImage(&linked);
+  for (i = 0; i < numOfModules; i++) {
+    freeObjectImage(&modules[i].image);
+    freeObjectSymbols(&modules[i].entries);
+    freeObjectSymbols(&modules[i].externals);
+  }
+  free(modules);
+  return numOfErrors == 0 ? 0 : 1;
+}
+
+/* Load the .ob file of module, and its .ent and .ext files if they exist.
+ *
+ * Params:
+ * LinkModule *module: pointer to the module.
+ * char *name: the name of the .ob file.
+ *
+ * Returns:
+ * Boolean status: true if all the files of the module are valid, otherwise - false.
+*/
+Boolean loadLinkModule(LinkModule *module, char *name) {
+  unsigned long length;
+  char *content;
+  Boolean status;
+
+  initObjectImage(&module->image);
+  initObjectSymbols(&module->entries);
+  initObjectSymbols(&module->externals);
+  if (strlen(name) < 3 || strcmp(name + strlen(name) - 3, ".ob") != 0) {
+    fprintf(stderr, "File is not ob file: %s \n", name);
+    return false;
+  }
+
+  content = readFileContent(name, &length);
+  if (content == NULL) {
+    printf("Cannot open file %s \n", name);
+    return false;
+  }
+  status = loadObjectImage(&module->image, content, length);
+  free(content);
+  if (status == false) {
+    fprintf(stderr, "Error! %s is not a valid object file \n", name);
+    return false;
+  }
+  if (readSymbolsFile(&module->entries, name, ".ent") == false ||
+      readSymbolsFile(&module->externals, name, ".ext") == false) {
+    return false;
+  }
+  return true;
+}
+
+/* Get the address in the linked image of address of module - the code moves to the code base of the
+ * module, and the data to its data base.
+ *
+ * Params:
+ * LinkModule *module: pointer to the module.
+ * unsigned long address: the address in the image of the module.
+ *
+ * Returns:
+ * unsigned long address: the address in the linked image.
+*/
+unsigned long mapModuleAddress(LinkModule *module, unsigned long address) {
+  if (address < IMAGE_BASE + module->image.codeSize) {
+    return address - IMAGE_BASE + module->codeBase;
+  }
+  return address - IMAGE_BASE - module->image.codeSize + module->dataBase;
+}
+
+/* Add the entries of all the modules to the global symbols, with their addresses in the linked image.
+ * The module of every symbol is kept by its SymbolId, symbol that is entry of more than one module is error.
+ *
+ * Params:
+ * LabelTable *symbols: the global symbols.
+ * int *symbolModules: array (of the number of all the entries) for the module of every symbol.
+ * LinkModule *modules: the modules.
+ * int numOfModules: the number of the modules.
+ *
+ * Returns:
+ * int numOfErrors: the number of problems found.
+*/
+int addModuleEntries(LabelTable *symbols, int *symbolModules, LinkModule *modules, int numOfModules) {
+  int numOfErrors = 0, module;
+  unsigned long item;
+  SymbolId id, length;
+  char *name;
+
+  for (module = 0; module < numOfModules; module++) {
+    for (item = 0; item < modules[module].entries.length; item++) {
+      length = symbols->length;
+      id = addNewLabel(symbols, modules[module].entries.items[item].name,
+                       mapModuleAddress(&modules[module], modules[module].entries.items[item].address), ATTR_ENTRY);
+      if (id == NO_SYMBOL) {
+        printf("Error: Allocation Error! \n");
+        return numOfErrors + 1;
+      }
+      if (symbols->length > length) {
+        symbolModules[id] = module;
+        continue;
+      }
+
+      /* Reported once, at the second module that defines it, with all the modules that define it
+       * (there is no map then, so the symbol is marked by -1). */
+      if (symbolModules[id] >= 0) {
+        name = getLabelName(symbols, id);
+        fprintf(stderr, "Error! entry: %s is defined in more than one file:", name);
+        printEntryModules(modules, numOfModules, name);
+        symbolModules[id] = -1;
+        numOfErrors++;
+      }
+    }
+  }
+  return numOfErrors;
+}
+
+/* Print the names of the modules that have entry with the name.
+ *
+ * Params:
+ * LinkModule *modules: the modules.
+ * int numOfModules: the number of the modules.
+ * char *name: the name of the entry.
+*/
+void printEntryModules(LinkModule *modules, int numOfModules, char *name) {
+  unsigned long item;
+  int module;
+
+  for (module = 0; module < numOfModules; module++) {
+    for (item = 0; item < modules[module].entries.length; item++) {
+      if (strcmp(modules[module].entries.items[item].name, name) == 0) {
+        fprintf(stderr, " %s", modules[module].name);
+      }
+    }
+  }
+  fprintf(stderr, " \n");
+}
+
+/* Relocate the code of module into the linked image - the references of its .ext file get the
+ * addresses of their symbols, and the other J commands and the branches move with the module.
+ *
+ * Params:
+ * ObjectImage *linked: the linked image (with the code of the module already copied into it).
+ * LinkModule *module: pointer to the module.
+ * LabelTable *symbols: the global symbols.
+ * CmdSubtype *kinds: the kind of every opcode.
+ * int width: the width of the addresses in the messages.
+ *
+ * Returns:
+ * int numOfErrors: the number of problems found.
+*/
+int relocateModule(ObjectImage *linked, LinkModule *module, LabelTable *symbols, CmdSubtype *kinds, int width) {
+  unsigned long numOfWords = module->image.codeSize / 4, word, address, newAddress, target, item;
+  SymbolId *references, id;
+  CmdSubtype kind;
+  long distance;
+  int numOfErrors = 0;
+
+  references = (SymbolId *) malloc((numOfWords + 1) * sizeof(SymbolId));
+  if (references == NULL) {
+    printf("Error: Allocation Error! \n");
+    return 1;
+  }
+  for (item = 0; item < numOfWords; item++) {
+    references[item] = NO_SYMBOL;
+  }
+
+  for (item = 0; item < module->externals.length; item++) {
+    address = module->externals.items[item].address;
+    if (address < IMAGE_BASE || address >= IMAGE_BASE + module->image.codeSize || address % 4 != 0) {
+      fprintf(stderr, "Error! %s: external %s at %0*lu is not in the code \n", module->name,
+              module->externals.items[item].name, width, address);
+      numOfErrors++;
+      continue;
+    }
+    id = findLabel(symbols, module->externals.items[item].name);
+    if (id == NO_SYMBOL) {
+      fprintf(stderr, "Error! external: %s is not an entry of any file, used in: %s \n",
+              module->externals.items[item].name, module->name);
+      numOfErrors++;
+      continue;
+    }
+    references[(address - IMAGE_BASE) / 4] = id;
+  }
+
+  for (item = 0; item < numOfWords && numOfErrors == 0; item++) {
+    address = IMAGE_BASE + item * 4;
+    newAddress = mapModuleAddress(module, address);
+    word = getImageWord(&module->image, address);
+    kind = kinds[(word >> 26) & 0x3F];
+
+    if (kind == i_branch_cmd) {
+      if (references[item] != NO_SYMBOL) {
+        target = symbols->items[references[item]].value;
+      } else {
+        distance = (long) (word & 0xFFFF) - ((word & 0x8000) ? 0x10000L : 0);
+        target = mapModuleAddress(module, (unsigned long) ((long) address + distance));
+      }
+      distance = (long) target - (long) newAddress;
+      if (distance > MAX_BRANCH_DISTANCE || distance < MIN_BRANCH_DISTANCE) {
+        fprintf(stderr, "Error! %s: branch at %0*lu is out of range after linking \n", module->name, width,
+                newAddress);
+        numOfErrors++;
+      }
+      setImageWord(linked, newAddress, (word & ~0xFFFFUL) | ((unsigned long) distance & 0xFFFF));
+    } else if ((kind == j_jump_cmd || kind == J_cmd) && (word & (1UL << 25)) == 0) {
+      if (references[item] != NO_SYMBOL) {
+        target = symbols->items[references[item]].value;
+      } else {
+        target = mapModuleAddress(module, word & MAX_ADDRESS);
+      }
+      if (target > MAX_ADDRESS) {
+        fprintf(stderr, "Error! %s: address at %0*lu is out of range after linking \n", module->name, width,
+                newAddress);
+        numOfErrors++;
+      }
+      setImageWord(linked, newAddress, (word & ~MAX_ADDRESS) | (target & MAX_ADDRESS));
+    }
+  }
+  free(references);
+  return numOfErrors;
+}
+
+/* Write the map of the link - the place of the code and of the data of every module, and then every
+ * global symbol with its address in the linked image and its module.
+ *
+ * Params:
+ * Buffer *buffer: the content of the .map file.
+ * LinkModule *modules: the modules.
+ * int numOfModules: the number of the modules.
+ * LabelTable *symbols: the global symbols.
+ * int *symbolModules: the module of every symbol.
+ * int width: the width of the addresses.
+*/
+void writeLinkMap(Buffer *buffer, LinkModule *modules, int numOfModules, LabelTable *symbols, int *symbolModules,
+                  int width) {
+  int nameWidth = 0, i;
+  SymbolId id;
+
+  for (i = 0; i < numOfModules; i++) {
+    if ((int) strlen(modules[i].name) > nameWidth) {
+      nameWidth = (int) strlen(modules[i].name);
+    }
+  }
+
+  bufferPrintf(buffer, "modules:\n");
+  for (i = 0; i < numOfModules; i++) {
+    bufferPrintf(buffer, "%-*s code %0*lu %lu data %0*lu %lu\n", nameWidth, modules[i].name, width,
+                 modules[i].codeBase, modules[i].image.codeSize, width, modules[i].dataBase,
+                 modules[i].image.dataSize);
+  }
+
+  bufferPrintf(buffer, "\nsymbols:\n");
+  for (id = 0; id < symbols->length; id++) {
+    bufferPrintf(buffer, "%-*s %0*lu %s\n", MAX_LABEL_LENGTH, getLabelName(symbols, id), width,
+                 symbols->items[id].value, modules[symbolModules[id]].name);
+  }
+}
@@ -0,0 +1,227 @@
+#include "listing.h"
+
+unsigned long getCommandWord(Command *command);
+
+void writeListingRow(Buffer *buffer, ListingCursor *cursor, unsigned long address, unsigned char *bytes, int count,
+                     int lineNumber, const char *text, int length);
+
+char *getAttributesName(Attributes attr);
+
+/*
+ * Creates the content of the listing file from the source in memory.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * Command **commands: the commands linked list (after pass 2).
+ * DataItem **dataPicture: the dataPicture linked list (with the addresses after ICF).
+ * LabelTable *labels: a pointer to the labels table.
+ * unsigned long IDF: the end of the dataPicture image.
+ * int numOfLines: the number of lines of the source.
+ * const char *data: the source (does not have to end with '\0').
+ * unsigned long length: the length of the source in bytes.
+ */
+void createListingFile(Outputs *outputs, Command **commands, DataItem **dataPicture, LabelTable *labels,
+                       unsigned long IDF, int numOfLines, const char *data, unsigned long length) {
+  ListingCursor cursor;
+  unsigned long position = 0, end;
+  int lineNumber = 0;
+
+  beginListingFile(outputs, &cursor, commands, dataPicture, IDF, numOfLines);
+  /* Source without errors has no line that is cut by its length, so every '\n' ends line. */
+  while (position < length) {
+    for (end = position; end < length && data[end] != '\n'; end++) {
+    }
+    lineNumber++;
+    writeListingLine(outputs, &cursor, lineNumber, data + position, (int) (end - position));
+    position = end + 1;
+  }
+  endListingFile(outputs, labels);
+}
+
+/*
+ * Begin the listing - the header, and the place of the first command and data item.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * ListingCursor *cursor: the place of the listing to initialize.
+ * Command **commands: the commands linked list (after pass 2).
+ * DataItem **dataPicture: the dataPicture linked list (with the addresses after ICF).
+ * unsigned long IDF: the end of the dataPicture image.
+ * int numOfLines: the number of lines of the source.
+ */
+void beginListingFile(Outputs *outputs, ListingCursor *cursor, Command **commands, DataItem **dataPicture,
+                      unsigned long IDF, int numOfLines) {
+  cursor->command = *commands;
+  cursor->data = *dataPicture;
+  cursor->addressWidth = getAddressWidth(IDF > 0 ? IDF - 1 : 0);
+  cursor->lineWidth = getAddressWidth((unsigned long) numOfLines);
+  outputs->hasListing = true;
+  bufferPrintf(&outputs->listing, "%-*s  %-*s  %*s  %s\n", cursor->addressWidth, "addr",
+               LISTING_ROW_BYTES * 3 - 1, "bytes", cursor->lineWidth, "line", "source");
+}
+
+/*
+ * Write line of the source into the listing, with the bytes of its command or its data items.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * ListingCursor *cursor: the place of the listing, it is moved after the items of the line.
+ * int lineNumber: the number of the line.
+ * const char *text: the text of the line (does not have to end with '\0').
+ * int length: the length of the text.
+ */
+void writeListingLine(Outputs *outputs, ListingCursor *cursor, int lineNumber, const char *text, int length) {
+  unsigned char bytes[LISTING_ROW_BYTES];
+  unsigned long word, address = 0;
+  int row = lineNumber;
+  int count = 0, i;
+
+  while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r')) {
+    length--;
+  }
+
+  if (cursor->command != NULL && cursor->command->lineNumber == lineNumber) {
+    /* The bytes of the command are in the order of the memory, the lowest first. */
+    word = getCommandWord(cursor->command);
+    for (i = 0; i < 4; i++) {
+      bytes[i] = (unsigned char) ((word >> (8 * i)) & 0xFF);
+    }
+    writeListingRow(&outputs->listing, cursor, cursor->command->address, bytes, 4, lineNumber, text, length);
+    cursor->command = cursor->command->next;
+    return;
+  }
+
+  if (cursor->data == NULL || cursor->data->lineNumber != lineNumber) {
+    writeListingRow(&outputs->listing, cursor, 0, bytes, -1, lineNumber, text, length);
+    return;
+  }
+
+  /* The data items of the line are consecutive, their bytes fill rows from the address of the first. */
+  address = cursor->data->address;
+  while (cursor->data != NULL && cursor->data->lineNumber == lineNumber) {
+    for (i = 0; i < (int) cursor->data->size; i++) {
+      bytes[count++] = (unsigned char) (((unsigned long) cursor->data->item.value >> (8 * i)) & 0xFF);
+      if (count == LISTING_ROW_BYTES) {
+        writeListingRow(&outputs->listing, cursor, address, bytes, count, row, text, length);
+        address += count;
+        count = 0;
+        /* Only the first row has the line. */
+        row = 0;
+      }
+    }
+    cursor->data = cursor->data->next;
+  }
+  if (count > 0) {
+    writeListingRow(&outputs->listing, cursor, address, bytes, count, row, text, length);
+  }
+}
+
+/*
+ * End the listing with the symbols section - every label with its value and attributes.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * LabelTable *labels: a pointer to the labels table.
+ */
+void endListingFile(Outputs *outputs, LabelTable *labels) {
+  unsigned long largest = 0;
+  int width;
+  SymbolId id;
+
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].value > largest) {
+      largest = labels->items[id].value;
+    }
+  }
+  width = getAddressWidth(largest);
+
+  bufferPrintf(&outputs->listing, "\nsymbols:\n");
+  for (id = 0; id < labels->length; id++) {
+    bufferPrintf(&outputs->listing, "%-*s %0*lu %s%s\n", MAX_LABEL_LENGTH, getLabelName(labels, id), width,
+                 labels->items[id].value, getAttributesName(labels->items[id].attr),
+                 (labels->items[id].attr & ATTR_ENTRY) ? " entry" : "");
+  }
+}
+
+/* Get the 32 bits word of encoded command, like its bytes are written into the object file.
+ *
+ * Params:
+ * Command *command: the encoded command.
+ *
+ * Returns:
+ * unsigned long word: the word of the command.
+*/
+unsigned long getCommandWord(Command *command) {
+  if (command->bits == NULL) {
+    return 0;
+  }
+  if (command->type == r_cmd) {
+    return ((unsigned long) command->encoding.r.opcode << 26) | ((unsigned long) command->encoding.r.rs << 21) |
+           ((unsigned long) command->encoding.r.rt << 16) | ((unsigned long) command->encoding.r.rd << 11) |
+           ((unsigned long) command->encoding.r.funct << 6) | (unsigned long) command->encoding.r.unused;
+  } else if (command->type == i_cmd) {
+    return ((unsigned long) command->encoding.i.opcode << 26) | ((unsigned long) command->encoding.i.rs << 21) |
+           ((unsigned long) command->encoding.i.rt << 16) | ((unsigned long) command->encoding.i.immed & 0xFFFF);
+  }
+  return ((unsigned long) command->encoding.j.opcode << 26) | ((unsigned long) command->encoding.j.reg << 25) |
+         (unsigned long) command->encoding.j.address;
+}
+
+/* Write row of the listing: the address and the bytes (count -1 leaves both empty), and the line
+ * number and its text (line 0 leaves both empty).
+ *
+ * Params:
+ * Buffer *buffer: the content of the listing.
+ * ListingCursor *cursor: the place of the listing, with the widths of its columns.
+ * unsigned long address: the address of the first byte.
+ * unsigned char *bytes: the bytes of the row.
+ * int count: the number of the bytes.
+ * int lineNumber: the number of the line.
+ * const char *text: the text of the line.
+ * int length: the length of the text.
+*/
+void writeListingRow(Buffer *buffer, ListingCursor *cursor, unsigned long address, unsigned char *bytes, int count,
+                     int lineNumber, const char *text, int length) {
+  static const char digits[] = "0123456789ABCDEF";
+  char column[LISTING_ROW_BYTES * 3 + 1];
+  int i;
+
+  for (i = 0; i < LISTING_ROW_BYTES; i++) {
+    column[i * 3] = i < count ? digits[bytes[i] >> 4] : ' ';
+    column[i * 3 + 1] = i < count ? digits[bytes[i] & 0xF] : ' ';
+    column[i * 3 + 2] = ' ';
+  }
+  column[LISTING_ROW_BYTES * 3 - 1] = '\0';
+
+  if (lineNumber == 0) {
+    /* The continuation row ends after its bytes. */
+    column[count * 3 - 1] = '\0';
+    bufferPrintf(buffer, "%0*lu  %s\n", cursor->addressWidth, address, column);
+    return;
+  }
+  if (count == -1) {
+    bufferPrintf(buffer, "%*s  %s  %*d  ", cursor->addressWidth, "", column, cursor->lineWidth, lineNumber);
+  } else {
+    bufferPrintf(buffer, "%0*lu  %s  %*d  ", cursor->addressWidth, address, column, cursor->lineWidth, lineNumber);
+  }
+  appendBuffer(buffer, text, (unsigned long) length);
+  appendBuffer(buffer, "\n", 1);
+}
+
+/* Get the name of the kind of label by its attributes.
+ *
+ * Params:
+ * Attributes attr: the attributes of the label.
+ *
+ * Returns:
+ * char *name: code, data or external.
+*/
+char *getAttributesName(Attributes attr) {
+  if (attr & ATTR_EXTERNAL) {
+    return "external";
+  }
+  if (attr & ATTR_DATA) {
+    return "data";
+  }
+  return "code";
+}
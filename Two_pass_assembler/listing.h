@@ -0,0 +1,45 @@
+#ifndef MAMAN14_LISTING_H
+#define MAMAN14_LISTING_H
+
+#include "Datatypes.h"
+#include "files.h"
+
+/*
+ * Source listing, written as text into .lst file. Every line of the source is one row:
+ *
+ *   addr  bytes        line  source
+ *   0100  40 48 65 00     4  MAIN: add $3,$5,$9
+ *
+ * The address and the bytes (in the order of the memory, like the .ob file) are of the command of
+ * the line, or of its data items - data of more than 4 bytes continues in the next rows, that have
+ * only the address and the bytes. Lines without command or data have only the line and the source.
+ * After the lines comes the symbols section: every label with its value and attributes, in the
+ * order of the labels table.
+ *
+ * The listing is written after pass 2 in one walk over the lines of the source that are in memory,
+ * that takes the commands and the data items from their lists by their line numbers - the source is
+ * not parsed again.
+ */
+
+/* The number of bytes in one row of the listing. */
+#define LISTING_ROW_BYTES 4
+
+/* Data structure representing the place of the listing in the commands list and in the data picture. */
+typedef struct listingCursor {
+    Command *command;
+    DataItem *data;
+    int addressWidth;
+    int lineWidth;
+} ListingCursor;
+
+void beginListingFile(Outputs *outputs, ListingCursor *cursor, Command **commands, DataItem **dataPicture,
+                      unsigned long IDF, int numOfLines);
+
+void writeListingLine(Outputs *outputs, ListingCursor *cursor, int lineNumber, const char *text, int length);
+
+void endListingFile(Outputs *outputs, LabelTable *labels);
+
+void createListingFile(Outputs *outputs, Command **commands, DataItem **dataPicture, LabelTable *labels,
+                       unsigned long IDF, int numOfLines, const char *data, unsigned long length);
+
+#endif
@@ -0,0 +1,494 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include "libassembler.h"
+#include "encoding.h"
+#include "validation.h"
+#include "files.h"
+#include "generator.h"
+#include "allocations.h"
+#include "disassembly.h"
+
+#define DEFAULT_LINES 2000
+#define WARMUP_TIME 0.05
+#define RUN_TIME 0.2
+#define NUM_OF_RUNS 5
+#define NUM_OF_KERNELS 9
+
+/* Data structure representing the realistic inputs of the kernels - lines of generated source and
+ * what pass 1 made of them. */
+typedef struct benchInput {
+    char **lines;
+    int numOfLines;
+    AssemblerContext context;
+    Command **iCommands;
+    int numOfICommands;
+    char **labelNames;
+    int numOfLabels;
+    DataItem *dataPicture;
+    unsigned long numOfDataItems;
+    Buffer output;
+    ObjectImage image;
+    /* The results of the kernels are added here, so the compiler does not remove the calls. */
+    unsigned long sink;
+} BenchInput;
+
+/* Function that runs one operation of the kernel per input item, and returns the bytes it handled. */
+typedef unsigned long (*Kernel)(BenchInput *input, unsigned long *operations);
+
+Boolean initBenchInput(BenchInput *input, unsigned long seed, unsigned long numOfLines);
+
+void freeBenchInput(BenchInput *input);
+
+double getTime(void);
+
+void measureKernel(char *name, Kernel kernel, BenchInput *input);
+
+int compareDoubles(const void *first, const void *second);
+
+unsigned long benchGetCommandParts(BenchInput *input, unsigned long *operations);
+
+unsigned long benchGetLineType(BenchInput *input, unsigned long *operations);
+
+unsigned long benchCheckLine(BenchInput *input, unsigned long *operations);
+
+unsigned long benchBitFields(BenchInput *input, unsigned long *operations);
+
+unsigned long benchEncodeICmd(BenchInput *input, unsigned long *operations);
+
+unsigned long benchGetLabelAddress(BenchInput *input, unsigned long *operations);
+
+unsigned long benchWriteOrder(BenchInput *input, unsigned long *operations);
+
+unsigned long benchLoadObjectImage(BenchInput *input, unsigned long *operations);
+
+unsigned long benchDisassembleImage(BenchInput *input, unsigned long *operations);
+
+/*
+ * Microbenchmarks of the hot kernels of the assembler, on the lines of generated source.
+ * Every kernel is warmed up, then timed in some runs (the median is reported) as ns per
+ * operation, allocations per operation and throughput of its input in MB/s.
+ *
+ * Usage: microbench [--seed=N] [--lines=N] [kernel ...]
+ */
+int main(int args, char *argv[]) {
+  char *names[NUM_OF_KERNELS] = {"getCommandParts", "getLineType", "checkLine", "createStrFromBitField/cut",
+                                 "encodeICmd", "getLabelAddress", "writeOrderIntoObjectFile", "loadObjectImage",
+                                 "disassembleImage"};
+  Kernel kernels[NUM_OF_KERNELS];
+  unsigned long seed = 1;
+  unsigned long numOfLines = DEFAULT_LINES;
+  Boolean selected[NUM_OF_KERNELS];
+  Boolean all = true;
+  BenchInput input;
+  int i, j;
+
+  kernels[0] = benchGetCommandParts;
+  kernels[1] = benchGetLineType;
+  kernels[2] = benchCheckLine;
+  kernels[3] = benchBitFields;
+  kernels[4] = benchEncodeICmd;
+  kernels[5] = benchGetLabelAddress;
+  kernels[6] = benchWriteOrder;
+  kernels[7] = benchLoadObjectImage;
+  kernels[8] = benchDisassembleImage;
+
+  for (j = 0; j < NUM_OF_KERNELS; j++) {
+    selected[j] = false;
+  }
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+      continue;
+    }
+    if (strncmp(argv[i], "--lines=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfLines = strtoul(argv[i] + 8, NULL, 10);
+      continue;
+    }
+    for (j = 0; j < NUM_OF_KERNELS && strncmp(argv[i], names[j], strlen(argv[i])) != 0; j++) {
+    }
+    if (j == NUM_OF_KERNELS) {
+      fprintf(stderr, "Unknown kernel: %s \n", argv[i]);
+      exit(1);
+    }
+    selected[j] = true;
+    all = false;
+  }
+
+  if (initBenchInput(&input, seed, numOfLines) == false) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+  startCountingAllocations();
+
+  printf("%-26s %12s %12s %12s\n", "kernel", "ns/op", "allocs/op", "MB/s");
+  for (j = 0; j < NUM_OF_KERNELS; j++) {
+    if (all == true || selected[j] == true) {
+      measureKernel(names[j], kernels[j], &input);
+    }
+  }
+  freeBenchInput(&input);
+  return 0;
+}
+
+/* Generate the source, and prepare the inputs of the kernels from it: its lines, the labels table
+ * of the first pass, the I commands, the data picture and the image of its object file.
+ *
+ * Params:
+ * BenchInput *input: the inputs to fill.
+ * unsigned long seed: the seed of the generator.
+ * unsigned long numOfLines: the number of lines.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, false if there is no memory.
+*/
+Boolean initBenchInput(BenchInput *input, unsigned long seed, unsigned long numOfLines) {
+  GeneratorMix mix;
+  Buffer source;
+  LineParts *lineParts;
+  Command *command;
+  char *line, *end;
+  unsigned long address = 100;
+  unsigned long dataAddress = 0;
+  DataItem *lastData = NULL;
+  DataItem *item;
+  SymbolId id;
+
+  initGeneratorMix(&mix);
+  initBuffer(&source);
+  if (generateSource(&source, seed, numOfLines, &mix) == false) {
+    return false;
+  }
+
+  /* The labels table is left in the context by the first pass. */
+  initAssemblerContext(&input->context);
+  assembleSource(&input->context, source.data, source.length);
+  initObjectImage(&input->image);
+  if (loadObjectImage(&input->image, input->context.outputs.object.data, input->context.outputs.object.length) ==
+      false) {
+    return false;
+  }
+
+  input->lines = (char **) calloc(numOfLines, sizeof(char *));
+  input->iCommands = (Command **) calloc(numOfLines, sizeof(Command *));
+  input->labelNames = (char **) calloc(input->context.labels.length + 1, sizeof(char *));
+  if (input->lines == NULL || input->iCommands == NULL || input->labelNames == NULL) {
+    return false;
+  }
+  input->numOfLines = 0;
+  input->numOfICommands = 0;
+  input->dataPicture = NULL;
+  input->sink = 0;
+  initBuffer(&input->output);
+
+  for (line = source.data; line < source.data + source.length; line = end + 1) {
+    end = strchr(line, '\n');
+    *end = '\0';
+    input->lines[input->numOfLines++] = line;
+    lineParts = getCommandParts(line);
+    if (getLineType(line) == cmd_line) {
+      command = initNewCommand(line, address);
+      address += 4;
+      if (command != NULL && command->type == i_cmd) {
+        input->iCommands[input->numOfICommands++] = command;
+      } else {
+        freeCommands(&command);
+      }
+    } else if (getLineType(line) == order_line && lineParts != NULL &&
+               strcmp(lineParts->cmdName, ".asciz") == 0) {
+      encodeAscizOrder(&input->dataPicture, &lastData, line, &dataAddress);
+    } else if (getLineType(line) == order_line && lineParts != NULL && lineParts->cmdName[1] == 'd') {
+      encodeOrder(&input->dataPicture, &lastData, line, &dataAddress);
+    }
+    freeLinePart(lineParts);
+  }
+  /* The lines stay in the memory of the source. */
+  source.data = NULL;
+
+  input->numOfDataItems = 0;
+  for (item = input->dataPicture; item != NULL; item = item->next) {
+    input->numOfDataItems++;
+  }
+  input->numOfLabels = 0;
+  for (id = 0; id < input->context.labels.length; id++) {
+    input->labelNames[input->numOfLabels++] = input->context.labels.names + input->context.labels.items[id].name;
+  }
+  return true;
+}
+
+/* Free all the inputs.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+*/
+void freeBenchInput(BenchInput *input) {
+  int i;
+
+  for (i = 0; i < input->numOfICommands; i++) {
+    freeCommands(&input->iCommands[i]);
+  }
+  if (input->numOfLines > 0) {
+    free(input->lines[0]);
+  }
+  free(input->lines);
+  free(input->iCommands);
+  free(input->labelNames);
+  freeDataPicture(&input->dataPicture);
+  freeBuffer(&input->output);
+  freeObjectImage(&input->image);
+  freeAssemblerContext(&input->context);
+}
+
+/* Get the time of monotonic clock.
+ *
+ * Returns:
+ * double time: the time in seconds.
+*/
+double getTime(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/* Warm up the kernel, then time some runs of it and print the median.
+ * Every run repeats the kernel over its whole input until RUN_TIME passes.
+ *
+ * Params:
+ * char *name: the name of the kernel.
+ * Kernel kernel: the kernel.
+ * BenchInput *input: the inputs.
+*/
+void measureKernel(char *name, Kernel kernel, BenchInput *input) {
+  double times[NUM_OF_RUNS];
+  double begin, now;
+  unsigned long operations, runOperations, bytes = 0, runBytes;
+  unsigned long allocations, totalOperations = 0;
+  int i;
+
+  begin = getTime();
+  do {
+    kernel(input, &operations);
+  } while (getTime() - begin < WARMUP_TIME);
+
+  allocations = getAllocationsCount();
+  for (i = 0; i < NUM_OF_RUNS; i++) {
+    runOperations = 0;
+    runBytes = 0;
+    begin = getTime();
+    do {
+      runBytes += kernel(input, &operations);
+      runOperations += operations;
+      now = getTime();
+    } while (now - begin < RUN_TIME);
+    times[i] = (now - begin) / runOperations;
+    bytes = runBytes / runOperations;
+    totalOperations += runOperations;
+  }
+  allocations = getAllocationsCount() - allocations;
+
+  qsort(times, NUM_OF_RUNS, sizeof(double), compareDoubles);
+  printf("%-26s %12.1f %12.2f %12.1f\n", name, times[NUM_OF_RUNS / 2] * 1e9,
+         (double) allocations / totalOperations, bytes / times[NUM_OF_RUNS / 2] / 1e6);
+}
+
+/* Compare two doubles, for sorting.
+ *
+ * Params:
+ * const void *first: pointer to the first double.
+ * const void *second: pointer to the second double.
+ *
+ * Returns:
+ * int result: negative, zero or positive like their order.
+*/
+int compareDoubles(const void *first, const void *second) {
+  double difference = *(double *) first - *(double *) second;
+
+  if (difference < 0) {
+    return -1;
+  }
+  return difference > 0 ? 1 : 0;
+}
+
+/* Split every line into its label, command and parameters.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the lines.
+*/
+unsigned long benchGetCommandParts(BenchInput *input, unsigned long *operations) {
+  unsigned long bytes = 0;
+  int i;
+
+  for (i = 0; i < input->numOfLines; i++) {
+    freeLinePart(getCommandParts(input->lines[i]));
+    bytes += strlen(input->lines[i]);
+  }
+  *operations = input->numOfLines;
+  return bytes;
+}
+
+/* Classify every line.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the lines.
+*/
+unsigned long benchGetLineType(BenchInput *input, unsigned long *operations) {
+  unsigned long bytes = 0;
+  int i;
+
+  for (i = 0; i < input->numOfLines; i++) {
+    input->sink += getLineType(input->lines[i]);
+    bytes += strlen(input->lines[i]);
+  }
+  *operations = input->numOfLines;
+  return bytes;
+}
+
+/* Validate every line with the labels table, on copy of the line (the validation trims it).
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the lines.
+*/
+unsigned long benchCheckLine(BenchInput *input, unsigned long *operations) {
+  char line[MAX_LINE_LENGTH + 1];
+  unsigned long bytes = 0;
+  int i;
+
+  for (i = 0; i < input->numOfLines; i++) {
+    strcpy(line, input->lines[i]);
+    input->sink += checkLine(line, &input->context.labels);
+    bytes += strlen(input->lines[i]);
+  }
+  *operations = input->numOfLines;
+  return bytes;
+}
+
+/* Print the bits of every I command and cut them into its 4 bytes, like the object file writer.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the words.
+*/
+unsigned long benchBitFields(BenchInput *input, unsigned long *operations) {
+  char buf[33], temp[33];
+  int i;
+
+  for (i = 0; i < input->numOfICommands; i++) {
+    buf[0] = '\0';
+    strcat(buf, createStrFromBitField(input->iCommands[i]->address >> 2, 6, temp));
+    strcat(buf, createStrFromBitField(i, 5, temp));
+    strcat(buf, createStrFromBitField(i >> 5, 5, temp));
+    strcat(buf, createStrFromBitField(input->iCommands[i]->address, 16, temp));
+    input->sink += cut(buf, 0, 8) + cut(buf, 8, 8) + cut(buf, 16, 8) + cut(buf, 24, 8);
+  }
+  *operations = input->numOfICommands;
+  return 4 * (unsigned long) input->numOfICommands;
+}
+
+/* Encode every I command.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the lines of the commands.
+*/
+unsigned long benchEncodeICmd(BenchInput *input, unsigned long *operations) {
+  unsigned long bytes = 0;
+  Command *command;
+  int i;
+
+  for (i = 0; i < input->numOfICommands; i++) {
+    command = input->iCommands[i];
+    encodeICmd(command, &input->context.labels);
+    command->bits = NULL;
+    bytes += strlen(command->line);
+  }
+  *operations = input->numOfICommands;
+  return bytes;
+}
+
+/* Look every label up by its name.
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the names.
+*/
+unsigned long benchGetLabelAddress(BenchInput *input, unsigned long *operations) {
+  unsigned long bytes = 0;
+  int i;
+
+  for (i = 0; i < input->numOfLabels; i++) {
+    input->sink += getLabelAddress(&input->context.labels, input->labelNames[i]);
+    bytes += strlen(input->labelNames[i]);
+  }
+  *operations = input->numOfLabels;
+  return bytes;
+}
+
+/* Write the whole data picture into the object file content (an operation is one data item).
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes that were written.
+*/
+unsigned long benchWriteOrder(BenchInput *input, unsigned long *operations) {
+  resetBuffer(&input->output);
+  writeOrderIntoObjectFile(&input->dataPicture, &input->output, MIN_ADDRESS_WIDTH);
+  *operations = input->numOfDataItems;
+  return input->output.length;
+}
+
+/* Load the object file of the source into image (an operation is one word of the image).
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the object file.
+*/
+unsigned long benchLoadObjectImage(BenchInput *input, unsigned long *operations) {
+  input->sink += loadObjectImage(&input->image, input->context.outputs.object.data,
+                                 input->context.outputs.object.length);
+  *operations = (input->image.codeSize + input->image.dataSize + 3) / 4;
+  return input->context.outputs.object.length;
+}
+
+/* Disassemble the image of the object file of the source (an operation is one word of the image).
+ *
+ * Params:
+ * BenchInput *input: the inputs.
+ * unsigned long *operations: pointer to store the number of operations.
+ *
+ * Returns:
+ * unsigned long bytes: the bytes of the object file.
+*/
+unsigned long benchDisassembleImage(BenchInput *input, unsigned long *operations) {
+  resetBuffer(&input->output);
+  input->sink += disassembleImage(&input->output, &input->image, NULL, NULL);
+  *operations = (input->image.codeSize + input->image.dataSize + 3) / 4;
+  return input->context.outputs.object.length;
+}
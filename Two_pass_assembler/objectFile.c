@@ -0,0 +1,293 @@
+#include "objectFile.h"
+
+/* The value of every character as hexadecimal digit, -1 if it is not hexadecimal digit. */
+const signed char hexDigitValues[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+
+unsigned long readDecimal(const char *data, unsigned long length, unsigned long *position, Boolean *found);
+
+void skipSpaces(const char *data, unsigned long length, unsigned long *position, Boolean newlines);
+
+/*
+ * Initialize empty image.
+ *
+ * Params:
+ * ObjectImage *image: pointer to the image.
+ */
+void initObjectImage(ObjectImage *image) {
+  image->bytes = NULL;
+  image->codeSize = 0;
+  image->dataSize = 0;
+}
+
+/*
+ * Free the memory of image.
+ *
+ * Params:
+ * ObjectImage *image: pointer to the image.
+ */
+void freeObjectImage(ObjectImage *image) {
+  free(image->bytes);
+  initObjectImage(image);
+}
+
+/*
+ * Load the content of .ob file into image - the lengths of the code and of the data from the header,
+ * and then the bytes of every line. The addresses of the lines have to follow each other from 100.
+ *
+ * Params:
+ * ObjectImage *image: pointer to the image (it is replaced).
+ * const char *data: the content of the file (does not have to end with '\0').
+ * unsigned long length: the length of the content in bytes.
+ *
+ * Returns:
+ * Boolean status: true if the content is valid image, otherwise - false.
+ */
+Boolean loadObjectImage(ObjectImage *image, const char *data, unsigned long length) {
+  const unsigned char *position, *end = (const unsigned char *) data + length;
+  unsigned long offset = 0, size, filled = 0, address;
+  unsigned char *bytes;
+  Boolean found;
+  int high, low;
+
+  freeObjectImage(image);
+  skipSpaces(data, length, &offset, false);
+  image->codeSize = readDecimal(data, length, &offset, &found);
+  if (found == false) {
+    return false;
+  }
+  skipSpaces(data, length, &offset, false);
+  image->dataSize = readDecimal(data, length, &offset, &found);
+  if (found == false || image->codeSize % 4 != 0) {
+    return false;
+  }
+  size = image->codeSize + image->dataSize;
+  bytes = image->bytes = (unsigned char *) calloc(size + 1, sizeof(unsigned char));
+  if (bytes == NULL) {
+    return false;
+  }
+
+  /* The lines, in one pass over the content - the digits are decoded by table, not by conditions. */
+  position = (const unsigned char *) data + offset;
+  while (position < end) {
+    if (*position == '\n' || *position == '\r' || *position == ' ' || *position == '\t') {
+      position++;
+      continue;
+    }
+    if (*position < '0' || *position > '9') {
+      return false;
+    }
+    address = 0;
+    while (position < end && *position >= '0' && *position <= '9') {
+      address = address * 10 + (unsigned long) (*position++ - '0');
+    }
+    if (address != IMAGE_BASE + filled) {
+      return false;
+    }
+
+    /* The bytes of the line - pairs of digits after spaces, until the end of the line. */
+    while (1) {
+      while (position < end && *position == ' ') {
+        position++;
+      }
+      if (position == end || (high = hexDigitValues[*position]) < 0) {
+        break;
+      }
+      if (position + 1 == end || (low = hexDigitValues[position[1]]) < 0 || filled == size) {
+        return false;
+      }
+      bytes[filled++] = (unsigned char) ((high << 4) | low);
+      position += 2;
+    }
+    if (position < end && *position != '\n' && *position != '\r') {
+      return false;
+    }
+  }
+  return filled == size ? true : false;
+}
+
+/*
+ * Write image in the format of .ob file, like createObjectFile writes it: the header, and then 4
+ * bytes on every line from address 100 (the last line of the data may be shorter).
+ *
+ * Params:
+ * Buffer *buffer: the content of the .ob file.
+ * ObjectImage *image: pointer to the image.
+ */
+void writeObjectImage(Buffer *buffer, ObjectImage *image) {
+  unsigned long size = image->codeSize + image->dataSize, offset;
+  unsigned char *bytes = image->bytes;
+  int width = getAddressWidth(IMAGE_BASE + size - 1);
+
+  bufferPrintf(buffer, "\t \t %ld %ld \n", (long) image->codeSize, (long) image->dataSize);
+  for (offset = 0; offset + 4 <= size; offset += 4) {
+    bufferPrintf(buffer, "%0*lu %02X %02X %02X %02X \n", width, IMAGE_BASE + offset, bytes[offset],
+                 bytes[offset + 1], bytes[offset + 2], bytes[offset + 3]);
+  }
+  /* The last line of the data, without the end of the line. */
+  if (offset < size) {
+    bufferPrintf(buffer, "%0*lu ", width, IMAGE_BASE + offset);
+    for (; offset < size; offset++) {
+      bufferPrintf(buffer, "%02X ", bytes[offset]);
+    }
+  }
+}
+
+/*
+ * Initialize empty symbols.
+ *
+ * Params:
+ * ObjectSymbols *symbols: pointer to the symbols.
+ */
+void initObjectSymbols(ObjectSymbols *symbols) {
+  symbols->items = NULL;
+  symbols->length = 0;
+  symbols->capacity = 0;
+}
+
+/*
+ * Free the memory of symbols.
+ *
+ * Params:
+ * ObjectSymbols *symbols: pointer to the symbols.
+ */
+void freeObjectSymbols(ObjectSymbols *symbols) {
+  free(symbols->items);
+  initObjectSymbols(symbols);
+}
+
+/*
+ * Load the content of .ent or .ext file - the name and the address on every line - and add them to
+ * the symbols.
+ *
+ * Params:
+ * ObjectSymbols *symbols: pointer to the symbols.
+ * const char *data: the content of the file (does not have to end with '\0').
+ * unsigned long length: the length of the content in bytes.
+ *
+ * Returns:
+ * Boolean status: true if the content is valid, otherwise - false.
+ */
+Boolean loadObjectSymbols(ObjectSymbols *symbols, const char *data, unsigned long length) {
+  unsigned long position = 0, begin, capacity;
+  ObjectSymbol *items;
+  Boolean found;
+
+  while (1) {
+    skipSpaces(data, length, &position, true);
+    if (position == length) {
+      return true;
+    }
+    for (begin = position; position < length && !isspace((unsigned char) data[position]); position++) {
+    }
+    if (position - begin > MAX_LABEL_LENGTH) {
+      return false;
+    }
+
+    if (symbols->length == symbols->capacity) {
+      capacity = symbols->capacity == 0 ? 16 : symbols->capacity * 2;
+      items = (ObjectSymbol *) realloc(symbols->items, capacity * sizeof(ObjectSymbol));
+      if (items == NULL) {
+        return false;
+      }
+      symbols->items = items;
+      symbols->capacity = capacity;
+    }
+    memcpy(symbols->items[symbols->length].name, data + begin, position - begin);
+    symbols->items[symbols->length].name[position - begin] = '\0';
+
+    skipSpaces(data, length, &position, false);
+    symbols->items[symbols->length].address = readDecimal(data, length, &position, &found);
+    if (found == false) {
+      return false;
+    }
+    symbols->length++;
+  }
+}
+
+/*
+ * Get the 32 bits word of the image at address - its 4 bytes, the lowest first.
+ *
+ * Params:
+ * ObjectImage *image: pointer to the image.
+ * unsigned long address: the address of the word (in the image).
+ *
+ * Returns:
+ * unsigned long word: the word.
+ */
+unsigned long getImageWord(ObjectImage *image, unsigned long address) {
+  unsigned char *bytes = image->bytes + (address - IMAGE_BASE);
+
+  return (unsigned long) bytes[0] | ((unsigned long) bytes[1] << 8) | ((unsigned long) bytes[2] << 16) |
+         ((unsigned long) bytes[3] << 24);
+}
+
+/*
+ * Set the 32 bits word of the image at address - its 4 bytes, the lowest first.
+ *
+ * Params:
+ * ObjectImage *image: pointer to the image.
+ * unsigned long address: the address of the word (in the image).
+ * unsigned long word: the word.
+ */
+void setImageWord(ObjectImage *image, unsigned long address, unsigned long word) {
+  unsigned char *bytes = image->bytes + (address - IMAGE_BASE);
+
+  bytes[0] = (unsigned char) (word & 0xFF);
+  bytes[1] = (unsigned char) ((word >> 8) & 0xFF);
+  bytes[2] = (unsigned char) ((word >> 16) & 0xFF);
+  bytes[3] = (unsigned char) ((word >> 24) & 0xFF);
+}
+
+/* Read decimal number.
+ *
+ * Params:
+ * const char *data: the content.
+ * unsigned long length: the length of the content in bytes.
+ * unsigned long *position: pointer to the position of the number, it is moved after it.
+ * Boolean *found: pointer to flag - true if there is number at the position, otherwise - false.
+ *
+ * Returns:
+ * unsigned long value: the number.
+*/
+unsigned long readDecimal(const char *data, unsigned long length, unsigned long *position, Boolean *found) {
+  unsigned long value = 0;
+
+  *found = false;
+  while (*position < length && data[*position] >= '0' && data[*position] <= '9') {
+    value = value * 10 + (unsigned long) (data[*position] - '0');
+    (*position)++;
+    *found = true;
+  }
+  return value;
+}
+
+/* Skip spaces and tabs (and with newlines, also the ends of the lines).
+ *
+ * Params:
+ * const char *data: the content.
+ * unsigned long length: the length of the content in bytes.
+ * unsigned long *position: pointer to the position, it is moved after the spaces.
+ * Boolean newlines: true to skip also '\n' and '\r'.
+*/
+void skipSpaces(const char *data, unsigned long length, unsigned long *position, Boolean newlines) {
+  while (*position < length && (data[*position] == ' ' || data[*position] == '\t' ||
+                                (newlines == true && (data[*position] == '\n' || data[*position] == '\r')))) {
+    (*position)++;
+  }
+}
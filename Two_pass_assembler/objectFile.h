@@ -0,0 +1,55 @@
+#ifndef MAMAN14_OBJECTFILE_H
+#define MAMAN14_OBJECTFILE_H
+
+#include "Datatypes.h"
+#include "files.h"
+
+/*
+ * Loading of the outputs of the assembler back into memory: the image of .ob file (its header - the
+ * lengths of the code and of the data - and the bytes of every line, from address 100), and the
+ * symbols of .ent and .ext files (name and address on every line). The image is written again in the
+ * format of the assembler by writeObjectImage.
+ */
+
+/* The address of the first byte of the code. */
+#define IMAGE_BASE 100
+
+/* Data structure representing the image of .ob file - the code, and then the data. */
+typedef struct objectImage {
+    unsigned char *bytes;
+    unsigned long codeSize;
+    unsigned long dataSize;
+} ObjectImage;
+
+/* Data structure representing symbol of .ent file, or reference to external of .ext file. */
+typedef struct objectSymbol {
+    char name[MAX_LABEL_LENGTH + 1];
+    unsigned long address;
+} ObjectSymbol;
+
+/* Data structure representing the symbols of .ent or .ext file. */
+typedef struct objectSymbols {
+    ObjectSymbol *items;
+    unsigned long length;
+    unsigned long capacity;
+} ObjectSymbols;
+
+void initObjectImage(ObjectImage *image);
+
+void freeObjectImage(ObjectImage *image);
+
+Boolean loadObjectImage(ObjectImage *image, const char *data, unsigned long length);
+
+void writeObjectImage(Buffer *buffer, ObjectImage *image);
+
+void initObjectSymbols(ObjectSymbols *symbols);
+
+void freeObjectSymbols(ObjectSymbols *symbols);
+
+Boolean loadObjectSymbols(ObjectSymbols *symbols, const char *data, unsigned long length);
+
+unsigned long getImageWord(ObjectImage *image, unsigned long address);
+
+void setImageWord(ObjectImage *image, unsigned long address, unsigned long word);
+
+#endif
@@ -0,0 +1,138 @@
+#include "options.h"
+#include "cache.h"
+#include "daemon.h"
+#include "prefetch.h"
+#include "stats.h"
+
+/* Indicate if command line argument is an option (starts with "--").
+ *
+ * Params:
+ * char *arg: the command line argument.
+ *
+ * Returns:
+ * Boolean status: true if the argument is an option, otherwise - false.
+*/
+Boolean isOption(char *arg) {
+  if (strncmp(arg, "--", 2) == 0) {
+    return true;
+  }
+  return false;
+}
+
+/* Read all options from command line arguments, the rest of arguments are the input files.
+ *
+ * Params:
+ * int args: number of arguments.
+ * char *argv[]: the arguments.
+ * Options *options: the options to fill.
+ *
+ * Returns:
+ * Boolean status: true if all the options are valid, otherwise - false.
+*/
+Boolean parseOptions(int args, char *argv[], Options *options) {
+  int i;
+
+  options->batch = false;
+  options->sym = false;
+  options->report = false;
+  options->listing = false;
+  options->debug = false;
+  options->check = false;
+  options->watch = false;
+  options->pipeline = false;
+  options->prefetch = 0;
+  options->stats = STATS_NONE;
+  options->counters = false;
+  options->tracePath = NULL;
+  options->cacheDir = NULL;
+  options->cacheSize = DEFAULT_CACHE_SIZE;
+  options->socketPath = NULL;
+  options->workers = DEFAULT_WORKERS;
+
+  for (i = 1; i < args; i++) {
+    if (isOption(argv[i]) == false) {
+      continue;
+    }
+
+    if (strcmp(argv[i], "--batch") == 0) {
+      options->batch = true;
+    } else if (strcmp(argv[i], "--sym") == 0) {
+      options->sym = true;
+    } else if (strcmp(argv[i], "--report") == 0) {
+      options->report = true;
+    } else if (strcmp(argv[i], "--lst") == 0) {
+      options->listing = true;
+    } else if (strcmp(argv[i], "--dbg") == 0) {
+      options->debug = true;
+    } else if (strcmp(argv[i], "--check") == 0) {
+      options->check = true;
+    } else if (strcmp(argv[i], "--watch") == 0) {
+      options->watch = true;
+    } else if (strcmp(argv[i], "--pipeline") == 0) {
+      options->pipeline = true;
+    } else if (strcmp(argv[i], "--prefetch") == 0) {
+      options->prefetch = DEFAULT_PREFETCH;
+    } else if (strncmp(argv[i], "--prefetch=", 11) == 0 && atoi(argv[i] + 11) > 0) {
+      options->prefetch = atoi(argv[i] + 11);
+    } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=table") == 0) {
+      options->stats = STATS_TABLE;
+    } else if (strcmp(argv[i], "--stats=json") == 0) {
+      options->stats = STATS_JSON;
+    } else if (strcmp(argv[i], "--counters") == 0) {
+      options->counters = true;
+    } else if (strncmp(argv[i], "--trace=", 8) == 0 && argv[i][8] != '\0') {
+      options->tracePath = argv[i] + 8;
+    } else if (strcmp(argv[i], "--cache") == 0) {
+      options->cacheDir = DEFAULT_CACHE_DIR;
+    } else if (strncmp(argv[i], "--cache=", 8) == 0 && argv[i][8] != '\0') {
+      options->cacheDir = argv[i] + 8;
+    } else if (strncmp(argv[i], "--cache-size=", 13) == 0 && atol(argv[i] + 13) > 0) {
+      options->cacheSize = (unsigned long) atol(argv[i] + 13);
+    } else if (strcmp(argv[i], "--daemon") == 0) {
+      options->socketPath = defaultSocketPath();
+    } else if (strncmp(argv[i], "--daemon=", 9) == 0 && argv[i][9] != '\0') {
+      options->socketPath = argv[i] + 9;
+    } else if (strncmp(argv[i], "--workers=", 10) == 0 && atoi(argv[i] + 10) > 0) {
+      options->workers = atoi(argv[i] + 10);
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      return false;
+    }
+  }
+
+  if (options->watch == true && options->batch == true) {
+    fprintf(stderr, "The options --watch and --batch cannot be used together \n");
+    return false;
+  }
+  /* The counters are reported with the statistics. */
+  if (options->counters == true && options->stats == STATS_NONE) {
+    options->stats = STATS_TABLE;
+  }
+  if (options->stats != STATS_NONE && (options->watch == true || options->socketPath != NULL)) {
+    fprintf(stderr, "The options --stats and --counters cannot be used with --watch or --daemon \n");
+    return false;
+  }
+  if (options->tracePath != NULL && (options->watch == true || options->socketPath != NULL)) {
+    fprintf(stderr, "The option --trace cannot be used with --watch or --daemon \n");
+    return false;
+  }
+  if ((options->report == true || options->listing == true || options->debug == true) &&
+      options->socketPath != NULL) {
+    fprintf(stderr, "The options --report, --lst and --dbg cannot be used with --daemon \n");
+    return false;
+  }
+  if (options->check == true &&
+      (options->sym == true || options->report == true || options->listing == true || options->debug == true ||
+       options->batch == true || options->cacheDir != NULL || options->watch == true || options->socketPath != NULL)) {
+    fprintf(stderr, "The option --check cannot be used with --sym, --report, --lst, --dbg, --batch, --cache, --watch "
+                    "or --daemon \n");
+    return false;
+  }
+  if (options->socketPath != NULL &&
+      (options->watch == true || options->batch == true || options->cacheDir != NULL || options->pipeline == true ||
+       options->prefetch > 0)) {
+    fprintf(stderr, "The option --daemon cannot be used with --watch, --batch, --cache, --pipeline or --prefetch \n");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,30 @@
+#ifndef MAMAN14_OPTIONS_H
+#define MAMAN14_OPTIONS_H
+
+#include "Datatypes.h"
+
+/* Data structure representing the command line options of the assembler. */
+typedef struct options {
+    Boolean batch;
+    Boolean sym;
+    Boolean report;
+    Boolean listing;
+    Boolean debug;
+    Boolean check;
+    Boolean watch;
+    Boolean pipeline;
+    int prefetch;
+    int stats;
+    Boolean counters;
+    char *tracePath;
+    char *cacheDir;
+    unsigned long cacheSize;
+    char *socketPath;
+    int workers;
+} Options;
+
+Boolean isOption(char *arg);
+
+Boolean parseOptions(int args, char *argv[], Options *options);
+
+#endif
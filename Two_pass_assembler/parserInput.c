@@ -28,14 +28,22 @@ Boolean isCommentLine(char *line) {
  * if the command/order is in array return true, otherwise return false.
 */
 Boolean isDirectiveInArray(char *line, char **arr, int length) {
-  char *string, *found, *iterator;
+  char storage[LINE_PARTS_SIZE];
+  char *string = storage, *found, *iterator;
+  Boolean status = false;
   int i;
   line = trimStr(line);
-  string = duplicateStr(line);
-  iterator = string;
-  if (string == NULL) {
-    return false;
+
+  /* The line is cut in a copy on the stack, only longer line is copied into dynamic memory. */
+  if (strlen(line) < sizeof(storage)) {
+    strcpy(storage, line);
+  } else {
+    string = duplicateStr(line);
+    if (string == NULL) {
+      return false;
+    }
   }
+  iterator = string;
 
   found = myStrsep(&iterator, " ");
 
@@ -43,20 +51,16 @@ Boolean isDirectiveInArray(char *line, char **arr, int length) {
     found = myStrsep(&iterator, " ");
   }
 
-  if (found == NULL) {
-    free(string);
-    return false;
-  }
-
-  for (i = 0; i < length; i++) {
+  for (i = 0; found != NULL && i < length && status == false; i++) {
     if (strcmp(found, *(arr + i)) == 0) {
-      free(string);
-      return true;
+      status = true;
     }
   }
 
-  free(string);
-  return false;
+  if (string != storage) {
+    free(string);
+  }
+  return status;
 }
 
 /* Indicate if the line is an order line.
@@ -117,17 +121,10 @@ LineType getLineType(char *line) {
  * int index: the index of register in the registerTable.
 */
 int getRegisterIndexFromParam(char *param) {
-  char *index = calloc(strlen(param), sizeof(char));
-  int reg;
-  if (index == NULL) {
-    printf("Error: Allocation Error! \n");
+  if (*param == '\0') {
     return -1;
   }
-  memcpy(index, &param[1], strlen(param) - 1);
-  index[strlen(param) - 1] = '\0';
-  reg = atoi(index);
-  free(index);
-  return reg;
+  return atoi(param + 1);
 }
 
 /* Get command name and return its index in commands array.
@@ -215,12 +212,17 @@ DataSize getDataSizeByOrderName(char *cmdName) {
  * int numOfParams: number of params in command.
 */
 int getNumOfParamData(char *command) {
-  char *params, *line, *cmd, *iterator;
+  char *params, *cmd;
   int numOfParams = 0;
   LineParts *lineParts = getCommandParts(command);
   cmd = lineParts->cmdName;
   params = lineParts->params;
 
+  if (params == NULL) {
+    freeLinePart(lineParts);
+    return 0;
+  }
+
   /* In this command the string come in one chunk with quotations. */
   if (strcmp(cmd, ".asciz") == 0) {
     /* Ignore quotations */
@@ -229,43 +231,46 @@ int getNumOfParamData(char *command) {
     return numOfParams;
   }
 
+  numOfParams = getNumOfParams(params);
+  freeLinePart(lineParts);
+  return numOfParams;
+}
+
+/* Get the number of the parameters of command, that are separated by commas (empty parameters are
+ * counted too).
+ *
+ * Params:
+ * char *params: the parameters of the command (NULL if it has none).
+ *
+ * Returns:
+ * int numOfParams: number of params.
+*/
+int getNumOfParams(char *params) {
+  int numOfParams = 1;
+
   if (params == NULL) {
-    freeLinePart(lineParts);
     return 0;
   }
-
-  line = duplicateStr(params);
-  if (line == NULL) {
-    freeLinePart(lineParts);
-    return -1;
-  }
-
-  iterator = line;
-  while (myStrsep(&iterator, ",") != NULL) {
-    numOfParams++;
+  for (; *params != '\0'; params++) {
+    if (*params == ',') {
+      numOfParams++;
+    }
   }
-
-  free(line);
-  freeLinePart(lineParts);
   return numOfParams;
 }
 
 /* Check if label is already exists by its name.
  *
  * Params:
- * Label *labels: label table.
+ * LabelTable *labels: label table.
  * char *labelName: name of the label we want to check if exists.
  *
  * Returns:
  * Boolean status: true if label exists, otherwise - false.
 */
-Boolean isLabelExists(Label *labels, char *labelName) {
-  Label *lastLabel = labels;
-  while (lastLabel != NULL) {
-    if (strcmp(lastLabel->symbol, labelName) == 0) {
-      return true;
-    }
-    lastLabel = lastLabel->next;
+Boolean isLabelExists(LabelTable *labels, char *labelName) {
+  if (findLabel(labels, labelName) != NO_SYMBOL) {
+    return true;
   }
   return false;
 }
@@ -279,8 +284,12 @@ Boolean isLabelExists(Label *labels, char *labelName) {
  * Boolean isRegister: if it register return true, otherwise return false.
  */
 Boolean isParamRegister(char *param) {
-  int reg = getRegisterIndexFromParam(param);
-  if (reg < 32 && reg > 0) {
+  int reg;
+  if (param[0] != '$') {
+    return false;
+  }
+  reg = getRegisterIndexFromParam(param);
+  if (reg < 32 && reg >= 0) {
     return true;
   }
   return false;
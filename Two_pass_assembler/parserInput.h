@@ -40,7 +40,9 @@ char *readLabel(char *command);
 
 int getNumOfParamData(char *command);
 
-Boolean isLabelExists(Label *labels, char *labelName);
+int getNumOfParams(char *params);
+
+Boolean isLabelExists(LabelTable *labels, char *labelName);
 
 Boolean isParamRegister(char *param);
 
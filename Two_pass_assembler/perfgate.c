@@ -0,0 +1,454 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+#include "libassembler.h"
+#include "generator.h"
+#include "allocations.h"
+
+#define DEFAULT_BASELINE "tests/perf_baseline.txt"
+#define DEFAULT_RUNS 5
+#define DEFAULT_TOLERANCE 30.0
+#define E2E_LINES 100000
+#define MAX_METRICS 64
+#define MAX_METRIC_NAME 64
+/* The smallest changes of times that are regressions, below them it is noise of the timer. */
+#define MIN_CHANGE_MS 1.0
+#define MIN_CHANGE_NS 5.0
+/* The passes of the reference kernel over the generated source. */
+#define REFERENCE_PASSES 4
+/* The runs of the microbenchmarks (every one reports the median of its own runs already). */
+#define KERNEL_RUNS 3
+#define MAX_KERNELS 16
+
+/* Data structure representing one measured metric, and the noise of its runs (0 if unknown). */
+typedef struct metric {
+    char name[MAX_METRIC_NAME];
+    double value;
+    double noise;
+    double minChange;
+    Boolean count;
+} Metric;
+
+/* Data structure representing the timing of the phases of one run. */
+typedef struct phaseTimer {
+    double begin[NUM_OF_PHASES];
+    double phases[NUM_OF_PHASES];
+} PhaseTimer;
+
+unsigned long referenceSink = 0;
+
+double getTime(void);
+
+double timeReference(const char *data, unsigned long length);
+
+void timePhase(void *data, AssemblerPhase phase, Boolean begin);
+
+Boolean measureEndToEnd(Metric *metrics, int *length, Buffer *source, int runs, double *reference);
+
+Boolean measureKernels(Metric *metrics, int *length, Buffer *source, char *microbench);
+
+void addMetric(Metric *metrics, int *length, char *name, double *samples, int runs, double minChange);
+
+Boolean writeBaseline(char *path, Metric *metrics, int length);
+
+int compareBaseline(char *path, Metric *metrics, int length, double tolerance);
+
+int compareDoubles(const void *first, const void *second);
+
+/*
+ * Performance regression gate: run the end-to-end benchmark (every phase of the library, with all the
+ * outputs, on generated source of 100k lines, the median of some runs) and the kernel microbenchmarks,
+ * and compare them with the baseline. The times are not kept in ms or ns, that differ from machine to
+ * machine, but as ratios to the time of fixed reference kernel that runs before every run of them -
+ * so the baseline of one machine holds on other ones, as long as they are faster or slower for the
+ * assembler like for the reference. A time regresses when its ratio grows by more than the tolerance
+ * (or than the noise of its runs, if it is larger); an allocation count regresses when it grows at all.
+ *
+ * Usage: perfgate [--baseline=FILE] [--runs=N] [--tolerance=PERCENT] [--microbench=PATH] [--write]
+ */
+int main(int args, char *argv[]) {
+  char *baseline = DEFAULT_BASELINE;
+  char *microbench = "./microbench";
+  int runs = DEFAULT_RUNS;
+  double tolerance = DEFAULT_TOLERANCE;
+  Boolean write = false;
+  Metric metrics[MAX_METRICS];
+  GeneratorMix mix;
+  Buffer source;
+  double reference;
+  int length = 0;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--baseline=", 11) == 0) {
+      baseline = argv[i] + 11;
+    } else if (strncmp(argv[i], "--runs=", 7) == 0 && atoi(argv[i] + 7) > 0) {
+      runs = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--tolerance=", 12) == 0 && atof(argv[i] + 12) > 0) {
+      tolerance = atof(argv[i] + 12);
+    } else if (strncmp(argv[i], "--microbench=", 13) == 0) {
+      microbench = argv[i] + 13;
+    } else if (strcmp(argv[i], "--write") == 0) {
+      write = true;
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  initGeneratorMix(&mix);
+  initBuffer(&source);
+  if (generateSource(&source, 1, E2E_LINES, &mix) == false) {
+    printf("Error: Allocation Error! \n");
+    exit(1);
+  }
+  startCountingAllocations();
+  if (measureEndToEnd(metrics, &length, &source, runs, &reference) == false ||
+      measureKernels(metrics, &length, &source, microbench) == false) {
+    freeBuffer(&source);
+    exit(1);
+  }
+  freeBuffer(&source);
+  printf("The reference kernel takes %.3f ms, the times are ratios to it (e2e: ms per ms, kernels: ns per ms) \n",
+         reference);
+
+  if (write == true) {
+    if (writeBaseline(baseline, metrics, length) == false) {
+      exit(1);
+    }
+    printf("The baseline was written to %s \n", baseline);
+    return 0;
+  }
+  return compareBaseline(baseline, metrics, length, tolerance);
+}
+
+/* Get the time of monotonic clock.
+ *
+ * Returns:
+ * double time: the time in seconds.
+*/
+double getTime(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/* Run the reference kernel - hash and count the bytes of the source some times. It is plain loop over
+ * memory, that does not change with the assembler, so its time is the speed of the machine.
+ *
+ * Params:
+ * const char *data: the source.
+ * unsigned long length: the length of the source.
+ *
+ * Returns:
+ * double time: the time of the kernel in ms.
+*/
+double timeReference(const char *data, unsigned long length) {
+  unsigned long hash = 2166136261UL, lines = 0, i;
+  double begin = getTime();
+  int pass;
+
+  for (pass = 0; pass < REFERENCE_PASSES; pass++) {
+    for (i = 0; i < length; i++) {
+      hash = ((hash ^ (unsigned char) data[i]) * 16777619UL) & 0xFFFFFFFFUL;
+      if (data[i] == '\n' || data[i] == ',') {
+        lines++;
+      }
+    }
+  }
+  /* The result is kept, so the loop is not removed by the compiler. */
+  referenceSink += hash + lines;
+  return (getTime() - begin) * 1000;
+}
+
+/* The phase hook of the end-to-end runs - add the time of every phase.
+ *
+ * Params:
+ * void *data: pointer to the timer.
+ * AssemblerPhase phase: the phase.
+ * Boolean begin: true at the begin of the phase, false at its end.
+*/
+void timePhase(void *data, AssemblerPhase phase, Boolean begin) {
+  PhaseTimer *timer = (PhaseTimer *) data;
+
+  if (begin == true) {
+    timer->begin[phase] = getTime();
+  } else {
+    timer->phases[phase] += getTime() - timer->begin[phase];
+  }
+}
+
+/* Assemble generated source with all the outputs some times, and add the median of every phase and of
+ * the total (as ratios to the reference kernel that ran just before the same run), and of the allocations.
+ *
+ * Params:
+ * Metric *metrics: the metrics.
+ * int *length: pointer to the number of the metrics.
+ * Buffer *source: the generated source.
+ * int runs: the number of runs.
+ * double *reference: pointer to store the median time of the reference kernel in ms.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean measureEndToEnd(Metric *metrics, int *length, Buffer *source, int runs, double *reference) {
+  double samples[NUM_OF_PHASES + 3][DEFAULT_RUNS * 4];
+  double references[DEFAULT_RUNS * 4];
+  char name[MAX_METRIC_NAME];
+  AssemblerContext context;
+  PhaseTimer timer;
+  unsigned long allocations;
+  double begin;
+  int run, i;
+
+  if (runs > DEFAULT_RUNS * 4) {
+    runs = DEFAULT_RUNS * 4;
+  }
+  initAssemblerContext(&context);
+  context.sym = true;
+  context.report = true;
+  context.listing = true;
+  context.debug = true;
+  context.phaseHook = timePhase;
+  context.phaseData = &timer;
+  for (run = 0; run < runs; run++) {
+    for (i = 0; i < NUM_OF_PHASES; i++) {
+      timer.phases[i] = 0;
+    }
+    references[run] = timeReference(source->data, source->length);
+    allocations = getAllocationsCount();
+    begin = getTime();
+    if (assembleSource(&context, source->data, source->length) != assembled) {
+      printf("The generated source was not assembled \n");
+      freeAssemblerContext(&context);
+      return false;
+    }
+    samples[NUM_OF_PHASES][run] = (getTime() - begin) * 1000 / references[run];
+    samples[NUM_OF_PHASES + 1][run] = (double) (getAllocationsCount() - allocations);
+    for (i = 0; i < NUM_OF_PHASES; i++) {
+      samples[i][run] = timer.phases[i] * 1000 / references[run];
+    }
+  }
+  freeAssemblerContext(&context);
+
+  qsort(references, runs, sizeof(double), compareDoubles);
+  *reference = references[runs / 2];
+
+  /* The phases of the command line (read and save) do not run in the library. */
+  for (i = pass1_phase; i < save_phase; i++) {
+    sprintf(name, "e2e.%s.ref", phaseNames[i]);
+    addMetric(metrics, length, name, samples[i], runs, MIN_CHANGE_MS / *reference);
+  }
+  addMetric(metrics, length, "e2e.total.ref", samples[NUM_OF_PHASES], runs, MIN_CHANGE_MS / *reference);
+  addMetric(metrics, length, "e2e.allocations", samples[NUM_OF_PHASES + 1], runs, 0);
+  return true;
+}
+
+/* Run the microbenchmarks some times, each one after the reference kernel, and add the median of their ns
+ * per operation (as ratios to the reference kernel of the same run) and of their allocations per operation.
+ *
+ * Params:
+ * Metric *metrics: the metrics.
+ * int *length: pointer to the number of the metrics.
+ * Buffer *source: the generated source, for the reference kernel.
+ * char *microbench: the path of the microbenchmarks.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean measureKernels(Metric *metrics, int *length, Buffer *source, char *microbench) {
+  char line[MAX_FORMAT_LENGTH];
+  char kernel[MAX_FORMAT_LENGTH];
+  char name[MAX_FORMAT_LENGTH];
+  char kernels[MAX_KERNELS][MAX_METRIC_NAME];
+  double times[MAX_KERNELS][KERNEL_RUNS];
+  double allocations[MAX_KERNELS][KERNEL_RUNS];
+  double references[KERNEL_RUNS];
+  double ns, allocs, throughput, reference;
+  FILE *output;
+  int found = 0, runFound, run, i;
+
+  for (run = 0; run < KERNEL_RUNS; run++) {
+    references[run] = timeReference(source->data, source->length);
+    if ((output = popen(microbench, "r")) == NULL) {
+      printf("Cannot run %s \n", microbench);
+      return false;
+    }
+    runFound = 0;
+    while (fgets(line, sizeof(line), output) != NULL) {
+      if (sscanf(line, "%40s %lf %lf %lf", kernel, &ns, &allocs, &throughput) != 4) {
+        continue;
+      }
+      /* Every run prints the same kernels in the same order. */
+      if (runFound == MAX_KERNELS || (run > 0 && (runFound == found || strcmp(kernels[runFound], kernel) != 0))) {
+        runFound = -1;
+        break;
+      }
+      strcpy(kernels[runFound], kernel);
+      times[runFound][run] = ns / references[run];
+      allocations[runFound][run] = allocs;
+      runFound++;
+    }
+    if (pclose(output) != 0 || runFound <= 0 || (run > 0 && runFound != found)) {
+      printf("The microbenchmarks failed (%s) \n", microbench);
+      return false;
+    }
+    found = runFound;
+  }
+
+  qsort(references, KERNEL_RUNS, sizeof(double), compareDoubles);
+  reference = references[KERNEL_RUNS / 2];
+  for (i = 0; i < found; i++) {
+    sprintf(name, "kernel.%.40s.ref", kernels[i]);
+    addMetric(metrics, length, name, times[i], KERNEL_RUNS, MIN_CHANGE_NS / reference);
+    sprintf(name, "kernel.%.40s.allocs", kernels[i]);
+    addMetric(metrics, length, name, allocations[i], KERNEL_RUNS, 0);
+  }
+  return true;
+}
+
+/* Add metric - the median of its samples, and their noise (the median absolute deviation).
+ *
+ * Params:
+ * Metric *metrics: the metrics.
+ * int *length: pointer to the number of the metrics.
+ * char *name: the name of the metric.
+ * double *samples: the samples of the runs (they are sorted).
+ * int runs: the number of the samples.
+ * double minChange: the smallest change of time that is regression, 0 for count (it has no noise).
+*/
+void addMetric(Metric *metrics, int *length, char *name, double *samples, int runs, double minChange) {
+  double deviations[DEFAULT_RUNS * 4];
+  Metric *metric;
+  int i;
+
+  if (*length == MAX_METRICS) {
+    return;
+  }
+  metric = &metrics[(*length)++];
+  strncpy(metric->name, name, MAX_METRIC_NAME - 1);
+  metric->name[MAX_METRIC_NAME - 1] = '\0';
+  metric->minChange = minChange;
+  metric->count = minChange > 0 ? false : true;
+  qsort(samples, runs, sizeof(double), compareDoubles);
+  metric->value = samples[runs / 2];
+  for (i = 0; i < runs; i++) {
+    deviations[i] = samples[i] > metric->value ? samples[i] - metric->value : metric->value - samples[i];
+  }
+  qsort(deviations, runs, sizeof(double), compareDoubles);
+  metric->noise = deviations[runs / 2];
+}
+
+/* Write the metrics as the new baseline.
+ *
+ * Params:
+ * char *path: the path of the baseline.
+ * Metric *metrics: the metrics.
+ * int length: the number of the metrics.
+ *
+ * Returns:
+ * Boolean status: true if succeeded, otherwise - false.
+*/
+Boolean writeBaseline(char *path, Metric *metrics, int length) {
+  FILE *fptr = fopen(path, "w");
+  int i;
+
+  if (fptr == NULL) {
+    printf("Cannot create file %s \n", path);
+    return false;
+  }
+  fprintf(fptr, "# Baseline of make perfcheck (written by make perfbaseline): metric value\n");
+  fprintf(fptr, "# The times (.ref) are ratios to the reference kernel of the same run: e2e in ms per ms, kernels in ns "
+                "per ms.\n");
+  for (i = 0; i < length; i++) {
+    fprintf(fptr, "%s %.3f\n", metrics[i].name, metrics[i].value);
+  }
+  fclose(fptr);
+  return true;
+}
+
+/* Compare the metrics with the baseline, and print table of their changes.
+ *
+ * Params:
+ * char *path: the path of the baseline.
+ * Metric *metrics: the metrics.
+ * int length: the number of the metrics.
+ * double tolerance: the percent that time may grow by.
+ *
+ * Returns:
+ * int status: 0 if nothing regressed, otherwise - 1.
+*/
+int compareBaseline(char *path, Metric *metrics, int length, double tolerance) {
+  char line[MAX_FORMAT_LENGTH];
+  char name[MAX_FORMAT_LENGTH];
+  double value, limit, change;
+  FILE *fptr = fopen(path, "r");
+  char *verdict;
+  int regressions = 0;
+  int i;
+
+  if (fptr == NULL) {
+    printf("Cannot open the baseline %s (make perfbaseline writes it) \n", path);
+    return 1;
+  }
+
+  printf("%-40s %14s %14s %10s\n", "metric", "baseline", "current", "change");
+  while (fgets(line, sizeof(line), fptr) != NULL) {
+    if (line[0] == '#' || sscanf(line, "%63s %lf", name, &value) != 2) {
+      continue;
+    }
+    for (i = 0; i < length && strcmp(metrics[i].name, name) != 0; i++) {
+    }
+    if (i == length) {
+      printf("%-40s %14.3f %14s %10s  MISSING\n", name, value, "-", "-");
+      regressions++;
+      continue;
+    }
+
+    change = value > 0 ? (metrics[i].value - value) * 100 / value : 0;
+    if (metrics[i].count == true) {
+      /* Counts are exact - any growth is regression. */
+      limit = value + 0.005;
+    } else {
+      limit = value * (1 + tolerance / 100);
+      if (value + 3 * metrics[i].noise > limit) {
+        limit = value + 3 * metrics[i].noise;
+      }
+      if (value + metrics[i].minChange > limit) {
+        limit = value + metrics[i].minChange;
+      }
+    }
+    verdict = "ok";
+    if (metrics[i].value > limit) {
+      verdict = "REGRESSED";
+      regressions++;
+    }
+    printf("%-40s %14.3f %14.3f %+9.1f%%  %s\n", name, value, metrics[i].value, change, verdict);
+  }
+  fclose(fptr);
+
+  if (regressions > 0) {
+    printf("Error! %d metrics regressed (the tolerance of times is %.0f%%). \n", regressions, tolerance);
+    return 1;
+  }
+  return 0;
+}
+
+/* Compare two doubles, for sorting.
+ *
+ * Params:
+ * const void *first: pointer to the first double.
+ * const void *second: pointer to the second double.
+ *
+ * Returns:
+ * int result: negative, zero or positive like their order.
+*/
+int compareDoubles(const void *first, const void *second) {
+  double difference = *(double *) first - *(double *) second;
+
+  if (difference < 0) {
+    return -1;
+  }
+  return difference > 0 ? 1 : 0;
+}
@@ -0,0 +1,273 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include "pipeline.h"
+#include "ring.h"
+#include "trace.h"
+
+/* Data structure representing block of the file, empty block ends the file. */
+typedef struct block {
+    char data[PIPELINE_BLOCK_SIZE];
+    unsigned long length;
+} Block;
+
+/* Data structure representing lines that the lexer passes together to pass 1. */
+typedef struct lineBatch {
+    char lines[PIPELINE_BATCH_LINES][MAX_LINE_LENGTH];
+    int lengths[PIPELINE_BATCH_LINES];
+    int count;
+    Boolean last;
+} LineBatch;
+
+/* Data structure representing the stages of one source and the rings between them. */
+typedef struct pipeline {
+    FILE *file;
+    Ring blocks;
+    Ring freeBlocks;
+    Ring batches;
+    Ring freeBatches;
+    Block *blockPool;
+    LineBatch *batchPool;
+    Boolean readFailed;
+} Pipeline;
+
+Boolean initPipeline(Pipeline *pipeline, FILE *fptr);
+
+void freePipeline(Pipeline *pipeline);
+
+void *readBlocks(void *argument);
+
+void *cutLines(void *argument);
+
+LineBatch *addBatchLine(Pipeline *pipeline, LineBatch *batch, char *line, int length);
+
+void feedBlocks(Pipeline *pipeline, AssemblerContext *context);
+
+/* Assemble source from stream with the pipeline, like assembleSource does with the whole source.
+ *
+ * Params:
+ * FILE *fptr: pointer to the source (already open).
+ * AssemblerContext *context: the context of the assembler.
+ * AssemblerStatus *status: the status of finishSource (source_errors if the source cannot be read).
+ *
+ * Returns:
+ * Boolean started: true if the source was assembled, false if the pipeline cannot start (nothing
+ *                  was read from the stream then).
+*/
+Boolean pipelineStream(FILE *fptr, AssemblerContext *context, AssemblerStatus *status) {
+  Pipeline pipeline;
+  pthread_t reader;
+  pthread_t lexer;
+  LineBatch *batch;
+  Boolean last = false;
+  int i;
+
+  if (initPipeline(&pipeline, fptr) == false ||
+      pthread_create(&reader, NULL, readBlocks, &pipeline) != 0) {
+    freePipeline(&pipeline);
+    return false;
+  }
+
+  /* Pass 1 is one phase from the first line to the last (with the waits for the lines), like
+   * without the pipeline. */
+  beginSource(context);
+  if (pthread_create(&lexer, NULL, cutLines, &pipeline) != 0) {
+    /* Without lexer, the blocks are cut into lines by feedSource. */
+    feedBlocks(&pipeline, context);
+  } else {
+    while (last == false) {
+      batch = (LineBatch *) popRingWait(&pipeline.batches);
+      for (i = 0; i < batch->count; i++) {
+        feedSourceLine(context, batch->lines[i], batch->lengths[i]);
+      }
+      last = batch->last;
+      pushRingWait(&pipeline.freeBatches, batch);
+    }
+    pthread_join(lexer, NULL);
+  }
+  pthread_join(reader, NULL);
+
+  if (pipeline.readFailed == true) {
+    reportPhase(context, pass1_phase, false);
+    resetAssemblerContext(context);
+    *status = source_errors;
+  } else {
+    *status = finishSource(context);
+  }
+  freePipeline(&pipeline);
+  return true;
+}
+
+/* Allocate the rings and the blocks and the batches, all of them are free at first.
+ *
+ * Params:
+ * Pipeline *pipeline: pointer to the pipeline.
+ * FILE *fptr: the source.
+ *
+ * Returns:
+ * Boolean status: true if the pipeline is ready, false if there is no memory.
+*/
+Boolean initPipeline(Pipeline *pipeline, FILE *fptr) {
+  int i;
+  Boolean status = true;
+
+  pipeline->file = fptr;
+  pipeline->readFailed = false;
+  pipeline->blockPool = (Block *) malloc(PIPELINE_BLOCKS * sizeof(Block));
+  pipeline->batchPool = (LineBatch *) malloc(PIPELINE_BATCHES * sizeof(LineBatch));
+  if (initRing(&pipeline->blocks, PIPELINE_BLOCKS) == false) {
+    status = false;
+  }
+  if (initRing(&pipeline->freeBlocks, PIPELINE_BLOCKS) == false) {
+    status = false;
+  }
+  if (initRing(&pipeline->batches, PIPELINE_BATCHES) == false) {
+    status = false;
+  }
+  if (initRing(&pipeline->freeBatches, PIPELINE_BATCHES) == false) {
+    status = false;
+  }
+  if (status == false || pipeline->blockPool == NULL || pipeline->batchPool == NULL) {
+    return false;
+  }
+
+  for (i = 0; i < PIPELINE_BLOCKS; i++) {
+    pushRing(&pipeline->freeBlocks, &pipeline->blockPool[i]);
+  }
+  for (i = 0; i < PIPELINE_BATCHES; i++) {
+    pushRing(&pipeline->freeBatches, &pipeline->batchPool[i]);
+  }
+  return true;
+}
+
+/* Free the memory of the pipeline, after its threads are done.
+ *
+ * Params:
+ * Pipeline *pipeline: pointer to the pipeline.
+*/
+void freePipeline(Pipeline *pipeline) {
+  freeRing(&pipeline->blocks);
+  freeRing(&pipeline->freeBlocks);
+  freeRing(&pipeline->batches);
+  freeRing(&pipeline->freeBatches);
+  free(pipeline->blockPool);
+  free(pipeline->batchPool);
+}
+
+/* The reader stage - read the file into free blocks, until the end of the file.
+ *
+ * Params:
+ * void *argument: pointer to the pipeline.
+ *
+ * Returns:
+ * void *result: NULL.
+*/
+void *readBlocks(void *argument) {
+  Pipeline *pipeline = (Pipeline *) argument;
+  Block *block;
+  long bytes = 0;
+
+  nameTraceThread("pipeline reader");
+  traceBegin("read", "pipeline", NULL);
+  do {
+    block = (Block *) popRingWait(&pipeline->freeBlocks);
+    block->length = fread(block->data, 1, PIPELINE_BLOCK_SIZE, pipeline->file);
+    if (block->length == 0 && ferror(pipeline->file)) {
+      pipeline->readFailed = true;
+    }
+    bytes += (long) block->length;
+    pushRingWait(&pipeline->blocks, block);
+  } while (block->length > 0);
+  traceEnd("read", "pipeline", -1, bytes);
+  return NULL;
+}
+
+/* The lexer stage - cut the blocks into lines like getSourceLine (until '\n', but not more than
+ * MAX_LINE_LENGTH chars), the line may continue in the next block.
+ *
+ * Params:
+ * void *argument: pointer to the pipeline.
+ *
+ * Returns:
+ * void *result: NULL.
+*/
+void *cutLines(void *argument) {
+  Pipeline *pipeline = (Pipeline *) argument;
+  LineBatch *batch = (LineBatch *) popRingWait(&pipeline->freeBatches);
+  char line[MAX_LINE_LENGTH];
+  int lineLength = 0;
+  unsigned long length;
+  unsigned long i;
+  Block *block;
+  long lines = 0;
+  char c;
+
+  nameTraceThread("pipeline lexer");
+  traceBegin("lex", "pipeline", NULL);
+  batch->count = 0;
+  batch->last = false;
+  do {
+    block = (Block *) popRingWait(&pipeline->blocks);
+    length = block->length;
+    for (i = 0; i < length; i++) {
+      c = block->data[i];
+      line[lineLength++] = c;
+      if (c == '\n' || lineLength == MAX_LINE_LENGTH) {
+        batch = addBatchLine(pipeline, batch, line, lineLength);
+        lineLength = 0;
+        lines++;
+      }
+    }
+    pushRingWait(&pipeline->freeBlocks, block);
+  } while (length > 0);
+
+  if (lineLength > 0) {
+    batch = addBatchLine(pipeline, batch, line, lineLength);
+    lines++;
+  }
+  batch->last = true;
+  traceEnd("lex", "pipeline", lines, -1);
+  pushRingWait(&pipeline->batches, batch);
+  return NULL;
+}
+
+/* Add line to the batch, and pass the batch to pass 1 when it is full.
+ *
+ * Params:
+ * Pipeline *pipeline: pointer to the pipeline.
+ * LineBatch *batch: the batch.
+ * char *line: the line.
+ * int length: the length of the line.
+ *
+ * Returns:
+ * LineBatch *batch: the batch for the next line.
+*/
+LineBatch *addBatchLine(Pipeline *pipeline, LineBatch *batch, char *line, int length) {
+  memcpy(batch->lines[batch->count], line, length);
+  batch->lengths[batch->count++] = length;
+  if (batch->count == PIPELINE_BATCH_LINES) {
+    pushRingWait(&pipeline->batches, batch);
+    batch = (LineBatch *) popRingWait(&pipeline->freeBatches);
+    batch->count = 0;
+    batch->last = false;
+  }
+  return batch;
+}
+
+/* Feed the blocks of the reader to pass 1 as they are, when there is no lexer thread.
+ *
+ * Params:
+ * Pipeline *pipeline: pointer to the pipeline.
+ * AssemblerContext *context: the context of the assembler.
+*/
+void feedBlocks(Pipeline *pipeline, AssemblerContext *context) {
+  unsigned long length;
+  Block *block;
+
+  do {
+    block = (Block *) popRingWait(&pipeline->blocks);
+    length = block->length;
+    feedSource(context, block->data, length);
+    pushRingWait(&pipeline->freeBlocks, block);
+  } while (length > 0);
+}
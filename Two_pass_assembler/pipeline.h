@@ -0,0 +1,23 @@
+#ifndef MAMAN14_PIPELINE_H
+#define MAMAN14_PIPELINE_H
+
+#include <stdio.h>
+#include "libassembler.h"
+
+/*
+ * Pipelined assembly of one source - the stages run on their own threads and pass their work
+ * through lock-free rings:
+ * reader (reads blocks of the file) -> lexer (cuts the blocks into lines) -> pass 1 (on the calling
+ * thread, it encodes the data and the commands of each line as soon as it arrives).
+ * The blocks and the lines go back to their producers through rings of free items, so the pipeline
+ * allocates nothing while it runs.
+ */
+
+#define PIPELINE_BLOCK_SIZE 65536
+#define PIPELINE_BLOCKS 8
+#define PIPELINE_BATCH_LINES 512
+#define PIPELINE_BATCHES 8
+
+Boolean pipelineStream(FILE *fptr, AssemblerContext *context, AssemblerStatus *status);
+
+#endif
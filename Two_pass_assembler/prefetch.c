@@ -0,0 +1,221 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "prefetch.h"
+#include "options.h"
+#include "diskFiles.h"
+#include "trace.h"
+
+void *prefetchFiles(void *argument);
+
+void adviseFile(char *name);
+
+char *readPrefetchedContent(char *name, unsigned long *length);
+
+/* Start the thread that reads the input files (the arguments that the loop of main assembles) ahead.
+ * When the thread cannot start, the files are opened as usual.
+ *
+ * Params:
+ * Prefetcher *prefetcher: pointer to the prefetcher.
+ * int args: number of arguments.
+ * char *argv[]: the arguments.
+ * int depth: the number of files to read ahead.
+*/
+void startPrefetcher(Prefetcher *prefetcher, int args, char *argv[], int depth) {
+  int i;
+
+  prefetcher->numOfFiles = 0;
+  prefetcher->depth = depth;
+  prefetcher->current = 0;
+  prefetcher->started = false;
+  prefetcher->stop = false;
+  prefetcher->files = (PrefetchedFile *) calloc(args, sizeof(PrefetchedFile));
+  if (prefetcher->files == NULL) {
+    return;
+  }
+
+  for (i = 1; i < args; i++) {
+    if (isOption(argv[i]) == true || isAsFile(argv[i]) != true) {
+      continue;
+    }
+    prefetcher->files[prefetcher->numOfFiles].name = argv[i];
+    prefetcher->files[prefetcher->numOfFiles].content = NULL;
+    prefetcher->files[prefetcher->numOfFiles].ready = false;
+    prefetcher->numOfFiles++;
+  }
+
+  pthread_mutex_init(&prefetcher->lock, NULL);
+  pthread_cond_init(&prefetcher->changed, NULL);
+  if (pthread_create(&prefetcher->thread, NULL, prefetchFiles, prefetcher) == 0) {
+    prefetcher->started = true;
+  }
+}
+
+/* Get the content of the next input file, once the prefetch thread read it (wait until it is ready).
+ * The files are taken in the order of the arguments, and the content is assembled as is - it is not
+ * copied again. It belongs to the prefetcher, and is freed by releasePrefetchedFile.
+ *
+ * Params:
+ * Prefetcher *prefetcher: pointer to the prefetcher.
+ * unsigned long *length: pointer to store the length of the content.
+ *
+ * Returns:
+ * char *content: the content of the file, or NULL if it was not read (then the file is opened from the disk).
+*/
+char *getPrefetchedContent(Prefetcher *prefetcher, unsigned long *length) {
+  PrefetchedFile *file;
+
+  *length = 0;
+  if (prefetcher->started == false || prefetcher->current >= prefetcher->numOfFiles) {
+    return NULL;
+  }
+
+  file = &prefetcher->files[prefetcher->current];
+  pthread_mutex_lock(&prefetcher->lock);
+  while (file->ready == false) {
+    pthread_cond_wait(&prefetcher->changed, &prefetcher->lock);
+  }
+  pthread_mutex_unlock(&prefetcher->lock);
+
+  *length = file->length;
+  return file->content;
+}
+
+/* Free the content of the file that was taken last (after it is assembled), and let the
+ * prefetch thread read the next file.
+ *
+ * Params:
+ * Prefetcher *prefetcher: pointer to the prefetcher.
+*/
+void releasePrefetchedFile(Prefetcher *prefetcher) {
+  if (prefetcher->started == false || prefetcher->current >= prefetcher->numOfFiles) {
+    return;
+  }
+
+  pthread_mutex_lock(&prefetcher->lock);
+  free(prefetcher->files[prefetcher->current].content);
+  prefetcher->files[prefetcher->current].content = NULL;
+  prefetcher->current++;
+  pthread_cond_broadcast(&prefetcher->changed);
+  pthread_mutex_unlock(&prefetcher->lock);
+}
+
+/* Stop the prefetch thread and free the contents that were not assembled.
+ *
+ * Params:
+ * Prefetcher *prefetcher: pointer to the prefetcher.
+*/
+void stopPrefetcher(Prefetcher *prefetcher) {
+  int i;
+
+  if (prefetcher->files == NULL) {
+    return;
+  }
+  if (prefetcher->started == true) {
+    pthread_mutex_lock(&prefetcher->lock);
+    prefetcher->stop = true;
+    pthread_cond_broadcast(&prefetcher->changed);
+    pthread_mutex_unlock(&prefetcher->lock);
+    pthread_join(prefetcher->thread, NULL);
+  }
+  pthread_cond_destroy(&prefetcher->changed);
+  pthread_mutex_destroy(&prefetcher->lock);
+
+  for (i = 0; i < prefetcher->numOfFiles; i++) {
+    free(prefetcher->files[i].content);
+  }
+  free(prefetcher->files);
+  prefetcher->files = NULL;
+}
+
+/* The prefetch thread - ask the kernel to read the files of the window ahead, and read them in
+ * order into memory, while they are not more than depth files ahead of the assembled file.
+ *
+ * Params:
+ * void *argument: pointer to the prefetcher.
+ *
+ * Returns:
+ * void *result: NULL.
+*/
+void *prefetchFiles(void *argument) {
+  Prefetcher *prefetcher = (Prefetcher *) argument;
+  PrefetchedFile *file;
+  int advised = 0;
+  int window;
+  int i;
+
+  nameTraceThread("prefetch");
+  for (i = 0; i < prefetcher->numOfFiles; i++) {
+    pthread_mutex_lock(&prefetcher->lock);
+    while (prefetcher->stop == false && i >= prefetcher->current + prefetcher->depth) {
+      pthread_cond_wait(&prefetcher->changed, &prefetcher->lock);
+    }
+    if (prefetcher->stop == true) {
+      pthread_mutex_unlock(&prefetcher->lock);
+      break;
+    }
+    window = prefetcher->current + prefetcher->depth;
+    pthread_mutex_unlock(&prefetcher->lock);
+
+    /* The whole window is read by the kernel at the same time, not only the next file. */
+    while (advised < prefetcher->numOfFiles && advised < window) {
+      adviseFile(prefetcher->files[advised++].name);
+    }
+
+    file = &prefetcher->files[i];
+    traceBegin("read", "prefetch", file->name);
+    file->content = readPrefetchedContent(file->name, &file->length);
+    traceEnd("read", "prefetch", -1, (long) file->length);
+
+    pthread_mutex_lock(&prefetcher->lock);
+    file->ready = true;
+    pthread_cond_broadcast(&prefetcher->changed);
+    pthread_mutex_unlock(&prefetcher->lock);
+  }
+  return NULL;
+}
+
+/* Ask the kernel to start reading the file into the page cache, without waiting for it.
+ *
+ * Params:
+ * char *name: the name of the file.
+*/
+void adviseFile(char *name) {
+  int descriptor = open(name, O_RDONLY);
+
+  if (descriptor < 0) {
+    return;
+  }
+  posix_fadvise(descriptor, 0, 0, POSIX_FADV_WILLNEED);
+  close(descriptor);
+}
+
+/* Read the whole file into memory.
+ *
+ * Params:
+ * char *name: the name of the file.
+ * unsigned long *length: pointer to store the number of bytes read.
+ *
+ * Returns:
+ * char *content: the content of the file, or NULL if it cannot be read.
+*/
+char *readPrefetchedContent(char *name, unsigned long *length) {
+  int descriptor = open(name, O_RDONLY);
+  FILE *fp;
+  char *content;
+
+  *length = 0;
+  if (descriptor < 0) {
+    return NULL;
+  }
+  posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+  fp = fdopen(descriptor, "r");
+  if (fp == NULL) {
+    close(descriptor);
+    return NULL;
+  }
+  content = readStreamContent(fp, length);
+  fclose(fp);
+  return content;
+}
@@ -0,0 +1,40 @@
+#ifndef MAMAN14_PREFETCH_H
+#define MAMAN14_PREFETCH_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "Datatypes.h"
+
+#define DEFAULT_PREFETCH 4
+
+/* Data structure representing input file and its content, once the prefetch thread read it. */
+typedef struct prefetchedFile {
+    char *name;
+    char *content;
+    unsigned long length;
+    Boolean ready;
+} PrefetchedFile;
+
+/* Data structure representing thread that reads the next input files while the current one is
+ * assembled. At most depth files are read ahead of the file that is assembled. */
+typedef struct prefetcher {
+    PrefetchedFile *files;
+    int numOfFiles;
+    int depth;
+    int current;
+    Boolean started;
+    Boolean stop;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} Prefetcher;
+
+void startPrefetcher(Prefetcher *prefetcher, int args, char *argv[], int depth);
+
+char *getPrefetchedContent(Prefetcher *prefetcher, unsigned long *length);
+
+void releasePrefetchedFile(Prefetcher *prefetcher);
+
+void stopPrefetcher(Prefetcher *prefetcher);
+
+#endif
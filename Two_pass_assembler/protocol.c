@@ -0,0 +1,300 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <unistd.h>
+#include "protocol.h"
+
+Boolean readSection(Buffer *frame, unsigned long *offset, char **section, unsigned long *length);
+
+/* Write all the bytes into socket (or any other descriptor), even if it accepts only part of them at once.
+ *
+ * Params:
+ * int descriptor: the descriptor to write into.
+ * const char *data: the bytes to write.
+ * unsigned long length: number of bytes.
+ *
+ * Returns:
+ * Boolean status: true if all the bytes were written, otherwise (the other side is closed) - false.
+*/
+Boolean writeAll(int descriptor, const char *data, unsigned long length) {
+  ssize_t written;
+
+  while (length > 0) {
+    written = write(descriptor, data, length);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    length -= (unsigned long) written;
+  }
+  return true;
+}
+
+/* Read exactly the given number of bytes from socket (or any other descriptor).
+ *
+ * Params:
+ * int descriptor: the descriptor to read from.
+ * char *data: array to read the bytes into it.
+ * unsigned long length: number of bytes.
+ *
+ * Returns:
+ * Boolean status: true if all the bytes were read, otherwise (end of stream or error) - false.
+*/
+Boolean readAll(int descriptor, char *data, unsigned long length) {
+  ssize_t received;
+
+  while (length > 0) {
+    received = read(descriptor, data, length);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      return false;
+    }
+    data += received;
+    length -= (unsigned long) received;
+  }
+  return true;
+}
+
+/* Write the buffer as one frame - its length and then its content.
+ *
+ * Params:
+ * int descriptor: the descriptor to write into.
+ * Buffer *frame: the payload of the frame (may be empty).
+ *
+ * Returns:
+ * Boolean status: true if the frame was written, otherwise - false.
+*/
+Boolean writeFrame(int descriptor, Buffer *frame) {
+  Buffer header;
+  Boolean status;
+
+  initBuffer(&header);
+  appendField(&header, frame->length);
+  status = writeAll(descriptor, header.data, header.length);
+  if (status == true) {
+    status = writeAll(descriptor, frame->data, frame->length);
+  }
+  freeBuffer(&header);
+  return status;
+}
+
+/* Read one frame into the buffer, instead of its previous content.
+ *
+ * Params:
+ * int descriptor: the descriptor to read from.
+ * Buffer *frame: the buffer for the payload of the frame.
+ *
+ * Returns:
+ * Boolean status: true if whole frame was read, otherwise (end of stream, error or too long frame) - false.
+*/
+Boolean readFrame(int descriptor, Buffer *frame) {
+  unsigned char header[4];
+  unsigned long length;
+
+  resetBuffer(frame);
+  if (readAll(descriptor, (char *) header, 4) == false) {
+    return false;
+  }
+  length = readField(header, 0);
+  if (length > MAX_FRAME_LENGTH || reserveBuffer(frame, length) == false) {
+    return false;
+  }
+  if (readAll(descriptor, frame->data, length) == false) {
+    return false;
+  }
+  frame->length = length;
+  frame->data[length] = '\0';
+  return true;
+}
+
+/* Build the payload of request frame.
+ *
+ * Params:
+ * Buffer *frame: the buffer for the payload, its previous content is replaced.
+ * unsigned long type: REQUEST_PATH or REQUEST_INLINE.
+ * unsigned long flags: the flags of the request.
+ * char *name: the path of the source (for REQUEST_INLINE only for the diagnostics).
+ * char *source: the content of the source (only for REQUEST_INLINE).
+ * unsigned long sourceLength: the length of the source.
+*/
+void buildRequest(Buffer *frame, unsigned long type, unsigned long flags, char *name, char *source,
+                  unsigned long sourceLength) {
+  resetBuffer(frame);
+  appendField(frame, type);
+  appendField(frame, flags);
+  appendField(frame, strlen(name));
+  appendBuffer(frame, name, strlen(name));
+  if (type == REQUEST_INLINE) {
+    appendField(frame, sourceLength);
+    appendBuffer(frame, source, sourceLength);
+  }
+}
+
+/* Parse the payload of request frame.
+ *
+ * Params:
+ * Buffer *frame: the payload.
+ * Request *request: the request to fill, its strings point into the frame.
+ *
+ * Returns:
+ * Boolean status: true if the request is valid, otherwise - false.
+*/
+Boolean parseRequest(Buffer *frame, Request *request) {
+  const unsigned char *data = (const unsigned char *) frame->data;
+  unsigned long offset = 12;
+
+  if (frame->length < offset) {
+    return false;
+  }
+  request->type = readField(data, 0);
+  request->flags = readField(data, 4);
+  request->nameLength = readField(data, 8);
+  request->source = NULL;
+  request->sourceLength = 0;
+  if (request->nameLength > frame->length - offset) {
+    return false;
+  }
+  request->name = frame->data + offset;
+  offset += request->nameLength;
+
+  if (request->type == REQUEST_INLINE) {
+    if (frame->length - offset < 4) {
+      return false;
+    }
+    request->sourceLength = readField(data, offset);
+    offset += 4;
+    if (request->sourceLength > frame->length - offset) {
+      return false;
+    }
+    request->source = frame->data + offset;
+  } else if (request->type != REQUEST_PATH) {
+    return false;
+  }
+  return true;
+}
+
+/* Build the payload of response frame.
+ *
+ * Params:
+ * Buffer *frame: the buffer for the payload, its previous content is replaced.
+ * unsigned long index: the index of the request.
+ * unsigned long status: RESPONSE_OK, RESPONSE_ERRORS or RESPONSE_FAILED.
+ * Outputs *outputs: the contents of the output files (NULL if there are no outputs).
+ * char *diagnostics: the errors of the source (NULL if there are no errors).
+ * unsigned long diagnosticsLength: the length of the diagnostics.
+*/
+void buildResponse(Buffer *frame, unsigned long index, unsigned long status, Outputs *outputs,
+                   char *diagnostics, unsigned long diagnosticsLength) {
+  Buffer *buffers[4];
+  Boolean exists[4];
+  int i;
+
+  resetBuffer(frame);
+  appendField(frame, index);
+  appendField(frame, status);
+
+  if (outputs != NULL) {
+    buffers[0] = &outputs->object;
+    buffers[1] = &outputs->entries;
+    buffers[2] = &outputs->externals;
+    buffers[3] = &outputs->symbols;
+    exists[0] = outputs->hasObject;
+    exists[1] = outputs->hasEntries;
+    exists[2] = outputs->hasExternals;
+    exists[3] = outputs->hasSymbols;
+  }
+  for (i = 0; i < 4; i++) {
+    if (outputs != NULL && exists[i] == true) {
+      appendField(frame, buffers[i]->length);
+      appendBuffer(frame, buffers[i]->data, buffers[i]->length);
+    } else {
+      appendField(frame, SECTION_ABSENT);
+    }
+  }
+
+  if (diagnostics != NULL) {
+    appendField(frame, diagnosticsLength);
+    appendBuffer(frame, diagnostics, diagnosticsLength);
+  } else {
+    appendField(frame, SECTION_ABSENT);
+  }
+}
+
+/* Read one section of response.
+ *
+ * Params:
+ * Buffer *frame: the payload of the response.
+ * unsigned long *offset: pointer to the offset of the section, it is moved to the next section.
+ * char **section: pointer to store the content of the section (NULL if it is missing).
+ * unsigned long *length: pointer to store the length of the section.
+ *
+ * Returns:
+ * Boolean status: true if the section is valid, otherwise - false.
+*/
+Boolean readSection(Buffer *frame, unsigned long *offset, char **section, unsigned long *length) {
+  if (frame->length - *offset < 4) {
+    return false;
+  }
+  *length = readField((const unsigned char *) frame->data, *offset);
+  *offset += 4;
+  if (*length == SECTION_ABSENT) {
+    *section = NULL;
+    *length = 0;
+    return true;
+  }
+  if (*length > frame->length - *offset) {
+    return false;
+  }
+  *section = frame->data + *offset;
+  *offset += *length;
+  return true;
+}
+
+/* Parse the payload of response frame.
+ *
+ * Params:
+ * Buffer *frame: the payload.
+ * Response *response: the response to fill, its sections point into the frame.
+ *
+ * Returns:
+ * Boolean status: true if the response is valid, otherwise - false.
+*/
+Boolean parseResponse(Buffer *frame, Response *response) {
+  unsigned long offset = 8;
+  int i;
+
+  if (frame->length < offset) {
+    return false;
+  }
+  response->index = readField((const unsigned char *) frame->data, 0);
+  response->status = readField((const unsigned char *) frame->data, 4);
+  for (i = 0; i < NUM_OF_SECTIONS; i++) {
+    if (readSection(frame, &offset, &response->sections[i], &response->lengths[i]) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Get the default path of the socket of the daemon - in the private runtime directory of the user
+ * ($XDG_RUNTIME_DIR), or else in /tmp/assembler-UID, that the daemon creates only for the user.
+ *
+ * Returns:
+ * char *path: the path (in static array, the same one for every call).
+*/
+char *defaultSocketPath(void) {
+  static char path[MAX_SOCKET_PATH];
+  char *runtime = getenv("XDG_RUNTIME_DIR");
+
+  if (runtime != NULL && runtime[0] == '/' && strlen(runtime) + strlen(SOCKET_NAME) + 2 <= MAX_SOCKET_PATH) {
+    sprintf(path, "%s/%s", runtime, SOCKET_NAME);
+  } else {
+    sprintf(path, "/tmp/assembler-%lu/%s", (unsigned long) getuid(), SOCKET_NAME);
+  }
+  return path;
+}
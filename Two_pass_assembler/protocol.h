@@ -0,0 +1,87 @@
+#ifndef MAMAN14_PROTOCOL_H
+#define MAMAN14_PROTOCOL_H
+
+#include "Datatypes.h"
+#include "buffer.h"
+#include "files.h"
+
+/*
+ * Protocol between the assembler daemon and its clients over Unix domain socket.
+ * All the fields are 32 bits unsigned integers in little endian.
+ *
+ * frame:    length, and then length bytes of payload. Empty frame ends the requests of the client.
+ * request:  type (REQUEST_PATH / REQUEST_INLINE), flags, name length, name,
+ *           source length, source (only for REQUEST_INLINE).
+ * response: index of the request (in the order they were sent), status, and then the sections
+ *           object, entries, externals, symbols and diagnostics - each one is length and content,
+ *           missing section is SECTION_ABSENT without content.
+ *
+ * The responses are sent when the requests are done, not in the order of the requests.
+ * The daemon reads at most MAX_PENDING_REQUESTS requests of client that were not answered yet, so the client
+ * should read the responses while it sends more requests.
+ */
+#define SOCKET_NAME "assembler.sock"
+#define MAX_SOCKET_PATH 108
+#define MAX_FRAME_LENGTH 67108864UL
+#define SECTION_ABSENT 0xFFFFFFFFUL
+#define NUM_OF_SECTIONS 5
+#define MAX_PENDING_REQUESTS 32
+
+/* Types of requests. */
+#define REQUEST_PATH 1
+#define REQUEST_INLINE 2
+
+/* Flags of requests. */
+#define REQUEST_FLAG_SYM 1
+
+/* Status of responses. */
+#define RESPONSE_OK 0
+#define RESPONSE_ERRORS 1
+#define RESPONSE_FAILED 2
+
+/* Indexes of response sections. */
+#define SECTION_OBJECT 0
+#define SECTION_ENTRIES 1
+#define SECTION_EXTERNALS 2
+#define SECTION_SYMBOLS 3
+#define SECTION_DIAGNOSTICS 4
+
+/* Data structure representing request, its strings point into the frame (and are not '\0' terminated). */
+typedef struct request {
+    unsigned long type;
+    unsigned long flags;
+    char *name;
+    unsigned long nameLength;
+    char *source;
+    unsigned long sourceLength;
+} Request;
+
+/* Data structure representing response, its sections point into the frame. */
+typedef struct response {
+    unsigned long index;
+    unsigned long status;
+    char *sections[NUM_OF_SECTIONS];
+    unsigned long lengths[NUM_OF_SECTIONS];
+} Response;
+
+Boolean writeAll(int descriptor, const char *data, unsigned long length);
+
+Boolean readAll(int descriptor, char *data, unsigned long length);
+
+Boolean writeFrame(int descriptor, Buffer *frame);
+
+Boolean readFrame(int descriptor, Buffer *frame);
+
+void buildRequest(Buffer *frame, unsigned long type, unsigned long flags, char *name, char *source,
+                  unsigned long sourceLength);
+
+Boolean parseRequest(Buffer *frame, Request *request);
+
+void buildResponse(Buffer *frame, unsigned long index, unsigned long status, Outputs *outputs,
+                   char *diagnostics, unsigned long diagnosticsLength);
+
+Boolean parseResponse(Buffer *frame, Response *response);
+
+char *defaultSocketPath(void);
+
+#endif
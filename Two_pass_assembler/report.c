@@ -0,0 +1,316 @@
+#include "report.h"
+#include "constants.h"
+
+#define NUM_OF_COMMANDS 27
+/* The range of the 16 bits signed immediate of the branches. */
+#define MIN_IMMEDIATE (-32768L)
+#define MAX_IMMEDIATE 32767L
+
+/* Data structure representing the analytics of the commands, that are counted in one walk over them. */
+typedef struct commandAnalytics {
+    unsigned long instructions;
+    unsigned long formats[3];
+    unsigned long opcodes[NUM_OF_COMMANDS];
+    unsigned long branches;
+    unsigned long forward;
+    unsigned long backward;
+    unsigned long outOfRange;
+    long longestDistance;
+    unsigned long distanceBits[MAX_DISTANCE_BITS + 1];
+    unsigned long registerJumps;
+    unsigned long labelJumps;
+    unsigned long externalJumps;
+} CommandAnalytics;
+
+/* Data structure representing label with the number of commands that refer to it. */
+typedef struct labelFanIn {
+    char *name;
+    unsigned long references;
+} LabelFanIn;
+
+int getCommandIndex(Command *command);
+
+int getDistanceBits(long distance);
+
+void analyzeCommands(CommandAnalytics *analytics, Command *commands, LabelTable *labels, LabelFanIn *fanIn);
+
+void writeCommandAnalytics(Buffer *buffer, CommandAnalytics *analytics);
+
+void writeDataAnalytics(Buffer *buffer, DataItem *dataPicture);
+
+void writeLabelAnalytics(Buffer *buffer, LabelTable *labels, LabelFanIn *fanIn);
+
+int compareLabelFanIn(const void *first, const void *second);
+
+/*
+ * Creates the content of the report file - the analytics of the program as JSON.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * Command **commands: the commands linked list (after pass 2).
+ * DataItem **dataPicture: the dataPicture linked list.
+ * LabelTable *labels: a pointer to the labels table.
+ */
+void createReportFile(Outputs *outputs, Command **commands, DataItem **dataPicture, LabelTable *labels) {
+  Buffer *buffer = &outputs->report;
+  CommandAnalytics analytics;
+  LabelFanIn *fanIn;
+  SymbolId id;
+
+  fanIn = (LabelFanIn *) calloc(labels->length + 1, sizeof(LabelFanIn));
+  if (fanIn == NULL) {
+    return;
+  }
+  for (id = 0; id < labels->length; id++) {
+    fanIn[id].name = getLabelName(labels, id);
+  }
+
+  memset(&analytics, 0, sizeof(analytics));
+  analyzeCommands(&analytics, *commands, labels, fanIn);
+
+  bufferPrintf(buffer, "{\n");
+  writeCommandAnalytics(buffer, &analytics);
+  writeDataAnalytics(buffer, *dataPicture);
+  writeLabelAnalytics(buffer, labels, fanIn);
+  bufferPrintf(buffer, "}\n");
+  outputs->hasReport = true;
+  free(fanIn);
+}
+
+/* Get the index of encoded command in the commands table (the R commands share their opcode, and are
+ * told apart by funct).
+ *
+ * Params:
+ * Command *command: the encoded command.
+ *
+ * Returns:
+ * int index: the index in commandsTable, -1 if it is not found.
+*/
+int getCommandIndex(Command *command) {
+  int opcode, funct = 0;
+  int i;
+
+  if (command->type == r_cmd) {
+    opcode = ((RCommand *) command->bits)->opcode;
+    funct = ((RCommand *) command->bits)->funct;
+  } else if (command->type == i_cmd) {
+    opcode = ((ICommand *) command->bits)->opcode;
+  } else {
+    opcode = ((JCommand *) command->bits)->opcode;
+  }
+
+  for (i = 0; i < NUM_OF_COMMANDS; i++) {
+    if (opcodes[i] == opcode && (command->type != r_cmd || functs[i] == funct)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* Get the number of bits of the smallest signed immediate that holds distance.
+ *
+ * Params:
+ * long distance: the distance.
+ *
+ * Returns:
+ * int bits: the number of bits (at most MAX_DISTANCE_BITS).
+*/
+int getDistanceBits(long distance) {
+  int bits = 1;
+
+  while (bits < MAX_DISTANCE_BITS && (distance < -(1L << (bits - 1)) || distance > (1L << (bits - 1)) - 1)) {
+    bits++;
+  }
+  return bits;
+}
+
+/* Count the analytics of the commands, and the fan-in of the labels that they refer to.
+ *
+ * Params:
+ * CommandAnalytics *analytics: the analytics to count into.
+ * Command *commands: the commands linked list.
+ * LabelTable *labels: a pointer to the labels table.
+ * LabelFanIn *fanIn: the fan-in of every label by its SymbolId.
+*/
+void analyzeCommands(CommandAnalytics *analytics, Command *commands, LabelTable *labels, LabelFanIn *fanIn) {
+  Command *command;
+  Label *target;
+  long distance;
+  int index;
+
+  for (command = commands; command != NULL; command = command->next) {
+    if (command->bits == NULL) {
+      continue;
+    }
+    analytics->instructions++;
+    analytics->formats[command->type]++;
+    index = getCommandIndex(command);
+    if (index != -1) {
+      analytics->opcodes[index]++;
+    }
+
+    if (command->operand != NO_SYMBOL) {
+      fanIn[command->operand].references++;
+    }
+
+    if (command->type == i_cmd && command->operand != NO_SYMBOL &&
+        (labels->items[command->operand].attr & ATTR_EXTERNAL) == 0) {
+      /* Conditional branch - its distance against the range of the immediate. */
+      target = &labels->items[command->operand];
+      distance = (long) target->value - (long) command->address;
+      analytics->branches++;
+      if (distance < 0) {
+        analytics->backward++;
+      } else {
+        analytics->forward++;
+      }
+      if ((distance < 0 ? -distance : distance) > analytics->longestDistance) {
+        analytics->longestDistance = distance < 0 ? -distance : distance;
+      }
+      if (distance < MIN_IMMEDIATE || distance > MAX_IMMEDIATE) {
+        analytics->outOfRange++;
+      }
+      analytics->distanceBits[getDistanceBits(distance)]++;
+    } else if (command->type == j_cmd && ((JCommand *) command->bits)->reg == 1) {
+      analytics->registerJumps++;
+    } else if (command->type == j_cmd && command->operand != NO_SYMBOL) {
+      if (labels->items[command->operand].attr & ATTR_EXTERNAL) {
+        analytics->externalJumps++;
+      } else {
+        analytics->labelJumps++;
+      }
+    }
+  }
+}
+
+/* Write the analytics of the commands: instructions, opcodes, branches and jumps.
+ *
+ * Params:
+ * Buffer *buffer: the content of the report.
+ * CommandAnalytics *analytics: the analytics of the commands.
+*/
+void writeCommandAnalytics(Buffer *buffer, CommandAnalytics *analytics) {
+  char *separator = "";
+  int i;
+
+  bufferPrintf(buffer, "  \"instructions\": {\"count\": %lu, \"R\": %lu, \"I\": %lu, \"J\": %lu},\n",
+               analytics->instructions, analytics->formats[r_cmd], analytics->formats[i_cmd],
+               analytics->formats[j_cmd]);
+
+  bufferPrintf(buffer, "  \"opcodes\": {");
+  for (i = 0; i < NUM_OF_COMMANDS; i++) {
+    if (analytics->opcodes[i] > 0) {
+      bufferPrintf(buffer, "%s\"%s\": %lu", separator, commandsTable[i], analytics->opcodes[i]);
+      separator = ", ";
+    }
+  }
+  bufferPrintf(buffer, "},\n");
+
+  bufferPrintf(buffer, "  \"branches\": {\"count\": %lu, \"forward\": %lu, \"backward\": %lu, \"longest\": %ld, "
+                       "\"outOfRange\": %lu, \"immediateBits\": 16, \"bits\": {",
+               analytics->branches, analytics->forward, analytics->backward, analytics->longestDistance,
+               analytics->outOfRange);
+  separator = "";
+  for (i = 1; i <= MAX_DISTANCE_BITS; i++) {
+    if (analytics->distanceBits[i] > 0) {
+      bufferPrintf(buffer, "%s\"%d\": %lu", separator, i, analytics->distanceBits[i]);
+      separator = ", ";
+    }
+  }
+  bufferPrintf(buffer, "}},\n");
+
+  bufferPrintf(buffer, "  \"jumps\": {\"register\": %lu, \"label\": %lu, \"external\": %lu},\n",
+               analytics->registerJumps, analytics->labelJumps, analytics->externalJumps);
+}
+
+/* Write the bytes of the data image by the directives.
+ *
+ * Params:
+ * Buffer *buffer: the content of the report.
+ * DataItem *dataPicture: the dataPicture linked list.
+*/
+void writeDataAnalytics(Buffer *buffer, DataItem *dataPicture) {
+  unsigned long bytes[word + 1];
+  DataItem *item;
+  int i;
+
+  for (i = 0; i <= word; i++) {
+    bytes[i] = 0;
+  }
+  for (item = dataPicture; item != NULL; item = item->next) {
+    bytes[item->size] += item->size;
+  }
+  bufferPrintf(buffer, "  \"data\": {\"bytes\": %lu, \".db/.asciz\": %lu, \".dh\": %lu, \".dw\": %lu},\n",
+               bytes[byte] + bytes[half_word] + bytes[word], bytes[byte], bytes[half_word], bytes[word]);
+}
+
+/* Write the labels by their kind with their fan-in, and the references of the externals.
+ *
+ * Params:
+ * Buffer *buffer: the content of the report.
+ * LabelTable *labels: a pointer to the labels table.
+ * LabelFanIn *fanIn: the fan-in of every label by its SymbolId (it is sorted).
+*/
+void writeLabelAnalytics(Buffer *buffer, LabelTable *labels, LabelFanIn *fanIn) {
+  unsigned long code = 0, data = 0, entries = 0, externals = 0, unreferenced = 0;
+  char *separator = "";
+  Label *label;
+  SymbolId id;
+
+  for (id = 0; id < labels->length; id++) {
+    label = &labels->items[id];
+    if (label->attr & ATTR_EXTERNAL) {
+      externals++;
+    } else if (label->attr & ATTR_DATA) {
+      data++;
+    } else {
+      code++;
+    }
+    if (label->attr & ATTR_ENTRY) {
+      entries++;
+    }
+    if (fanIn[id].references == 0 && (label->attr & ATTR_EXTERNAL) == 0) {
+      unreferenced++;
+    }
+  }
+
+  bufferPrintf(buffer, "  \"externals\": {");
+  for (id = 0; id < labels->length; id++) {
+    label = &labels->items[id];
+    if (label->attr & ATTR_EXTERNAL) {
+      bufferPrintf(buffer, "%s\"%s\": %d", separator, getLabelName(labels, id), label->appearancesLength);
+      separator = ", ";
+    }
+  }
+  bufferPrintf(buffer, "},\n");
+
+  bufferPrintf(buffer, "  \"labels\": {\"count\": %lu, \"code\": %lu, \"data\": %lu, \"entries\": %lu, "
+                       "\"externals\": %lu, \"unreferenced\": %lu, \"fanIn\": {",
+               (unsigned long) labels->length, code, data, entries, externals, unreferenced);
+  qsort(fanIn, labels->length, sizeof(LabelFanIn), compareLabelFanIn);
+  separator = "";
+  for (id = 0; id < labels->length && fanIn[id].references > 0; id++) {
+    bufferPrintf(buffer, "%s\"%s\": %lu", separator, fanIn[id].name, fanIn[id].references);
+    separator = ", ";
+  }
+  bufferPrintf(buffer, "}}\n");
+}
+
+/* Compare two labels by their fan-in (the most first), and then by their names.
+ *
+ * Params:
+ * const void *first: pointer to the first LabelFanIn.
+ * const void *second: pointer to the second LabelFanIn.
+ *
+ * Returns:
+ * int result: negative, zero or positive like their order.
+*/
+int compareLabelFanIn(const void *first, const void *second) {
+  LabelFanIn *firstLabel = (LabelFanIn *) first;
+  LabelFanIn *secondLabel = (LabelFanIn *) second;
+
+  if (firstLabel->references != secondLabel->references) {
+    return firstLabel->references > secondLabel->references ? -1 : 1;
+  }
+  return strcmp(firstLabel->name, secondLabel->name);
+}
@@ -0,0 +1,29 @@
+#ifndef MAMAN14_REPORT_H
+#define MAMAN14_REPORT_H
+
+#include "Datatypes.h"
+#include "files.h"
+
+/*
+ * Static analytics of the assembled program, written as JSON into .json file:
+ *
+ * instructions   the number of commands, and their formats (R, I, J).
+ * opcodes        how many times every command appears (only the commands that appear).
+ * branches       the distances of the conditional branches in bytes (target - address): forward,
+ *                backward, the longest, the histogram of the bits of signed immediate that each one
+ *                needs, and how many are out of the range of the 16 bits immediate.
+ * jumps          the J commands by their operand - register, label of the file, or external.
+ * data           the bytes of the data image by the directives (.db and .asciz are both bytes).
+ * externals      the references of every external.
+ * labels         the labels by their kind, how many are not referenced by any command, and the
+ *                fan-in of every referenced label (the commands that refer to it), the most first.
+ *
+ * It is computed from the encoded commands, the data image and the labels table, after pass 2.
+ */
+
+/* The most bits that the histogram of branch distances counts. */
+#define MAX_DISTANCE_BITS 33
+
+void createReportFile(Outputs *outputs, Command **commands, DataItem **dataPicture, LabelTable *labels);
+
+#endif
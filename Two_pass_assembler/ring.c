@@ -0,0 +1,108 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <sched.h>
+#include "ring.h"
+
+/* Initialize empty ring.
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+ * unsigned long size: the number of slots, power of 2.
+ *
+ * Returns:
+ * Boolean status: true if the ring was initialized, false if there is no memory.
+*/
+Boolean initRing(Ring *ring, unsigned long size) {
+  ring->slots = (void **) calloc(size, sizeof(void *));
+  ring->size = size;
+  ring->head = 0;
+  ring->tail = 0;
+  if (ring->slots == NULL) {
+    return false;
+  }
+  return true;
+}
+
+/* Free the slots of the ring (but not the items in them).
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+*/
+void freeRing(Ring *ring) {
+  free(ring->slots);
+  ring->slots = NULL;
+}
+
+/* Push item to the ring, called only by the producer.
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+ * void *item: the item.
+ *
+ * Returns:
+ * Boolean status: true if the item was pushed, false if the ring is full.
+*/
+Boolean pushRing(Ring *ring, void *item) {
+  unsigned long tail = ring->tail;
+
+  if (tail - ring->head == ring->size) {
+    return false;
+  }
+  ring->slots[tail & (ring->size - 1)] = item;
+  /* The item is in its slot before the consumer can see the new tail. */
+  __sync_synchronize();
+  ring->tail = tail + 1;
+  return true;
+}
+
+/* Pop the oldest item from the ring, called only by the consumer.
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+ *
+ * Returns:
+ * void *item: the item, or NULL if the ring is empty.
+*/
+void *popRing(Ring *ring) {
+  unsigned long head = ring->head;
+  void *item;
+
+  if (ring->tail == head) {
+    return NULL;
+  }
+  __sync_synchronize();
+  item = ring->slots[head & (ring->size - 1)];
+  /* The slot is read before the producer can reuse it. */
+  __sync_synchronize();
+  ring->head = head + 1;
+  return item;
+}
+
+/* Push item to the ring, wait while the ring is full.
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+ * void *item: the item.
+*/
+void pushRingWait(Ring *ring, void *item) {
+  while (pushRing(ring, item) == false) {
+    sched_yield();
+  }
+}
+
+/* Pop the oldest item from the ring, wait while the ring is empty.
+ *
+ * Params:
+ * Ring *ring: pointer to the ring.
+ *
+ * Returns:
+ * void *item: the item.
+*/
+void *popRingWait(Ring *ring) {
+  void *item;
+
+  while ((item = popRing(ring)) == NULL) {
+    sched_yield();
+  }
+  return item;
+}
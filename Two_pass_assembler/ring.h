@@ -0,0 +1,32 @@
+#ifndef MAMAN14_RING_H
+#define MAMAN14_RING_H
+
+#include "Datatypes.h"
+
+/*
+ * Lock-free ring of pointers between exactly one producer thread and one consumer thread.
+ * Only the producer writes tail and only the consumer writes head, so no lock is needed - the
+ * memory barriers order the slot with the index that publishes it.
+ */
+
+/* Data structure representing single producer single consumer ring. */
+typedef struct ring {
+    void **slots;
+    unsigned long size;
+    volatile unsigned long head;
+    volatile unsigned long tail;
+} Ring;
+
+Boolean initRing(Ring *ring, unsigned long size);
+
+void freeRing(Ring *ring);
+
+Boolean pushRing(Ring *ring, void *item);
+
+void *popRing(Ring *ring);
+
+void pushRingWait(Ring *ring, void *item);
+
+void *popRingWait(Ring *ring);
+
+#endif
@@ -0,0 +1,411 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "stats.h"
+#include "allocations.h"
+#include "stringExtension.h"
+
+long getPeakMemory(void);
+
+void recordPhase(void *data, AssemblerPhase phase, Boolean begin);
+
+void countFileStats(FileStats *file, AssemblerContext *context);
+
+void printStatsTable(Stats *stats);
+
+void printStatsJson(Stats *stats);
+
+void printCountersRow(Stats *stats, char *name, double time, unsigned long *counters);
+
+void printJsonCounters(Stats *stats, unsigned long *counters);
+
+void printJsonString(char *string);
+
+/* Initialize empty statistics, and start counting the allocations.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+ * int format: STATS_TABLE or STATS_JSON.
+*/
+void initStats(Stats *stats, int format) {
+  int i;
+
+  stats->format = format;
+  stats->files = NULL;
+  stats->length = 0;
+  stats->capacity = 0;
+  stats->counters.numOfAvailable = 0;
+  for (i = 0; i < NUM_OF_COUNTERS; i++) {
+    stats->counters.descriptors[i] = -1;
+  }
+  startCountingAllocations();
+}
+
+/* Count the hardware counters of every phase too (--counters). When the counters are not allowed
+ * (like in most containers), it is reported once and only the others are counted.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+*/
+void enableStatsCounters(Stats *stats) {
+  if (openCounters(&stats->counters) == false) {
+    if (stats->counters.numOfAvailable == 0) {
+      fprintf(stderr, "Performance counters are not available, they are not reported \n");
+    } else {
+      fprintf(stderr, "Some hardware performance counters are not available, they are reported as n/a \n");
+    }
+  }
+}
+
+/* Free all the memory of the statistics.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+*/
+void freeStats(Stats *stats) {
+  int i;
+
+  for (i = 0; i < stats->length; i++) {
+    free(stats->files[i].name);
+  }
+  free(stats->files);
+  stats->files = NULL;
+  stats->length = 0;
+  stats->capacity = 0;
+  if (stats->counters.numOfAvailable > 0) {
+    closeCounters(&stats->counters);
+  }
+}
+
+/* Start the statistics of file - the phases of the context are recorded into it until it ends.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+ * char *filename: the name of the file.
+ * AssemblerContext *context: the context that assembles the file.
+*/
+void beginFileStats(Stats *stats, char *filename, AssemblerContext *context) {
+  FileStats *files;
+  FileStats *file;
+  int i;
+
+  if (stats->length == stats->capacity) {
+    files = (FileStats *) realloc(stats->files, (stats->capacity * 2 + 8) * sizeof(FileStats));
+    if (files == NULL) {
+      return;
+    }
+    stats->files = files;
+    stats->capacity = stats->capacity * 2 + 8;
+  }
+
+  file = &stats->files[stats->length++];
+  memset(file, 0, sizeof(FileStats));
+  file->name = duplicateStr(filename);
+  for (i = 0; i < NUM_OF_PHASES; i++) {
+    stats->openPhases[i] = false;
+  }
+  context->phaseHook = recordPhase;
+  context->phaseData = stats;
+  stats->allocationsBegin = getAllocationsCount();
+  stats->allocatedBytesBegin = getAllocatedBytes();
+  if (stats->counters.numOfAvailable > 0) {
+    readCounters(&stats->counters, stats->fileCountersBegin);
+  }
+  stats->fileBegin = getMonotonicTime();
+}
+
+/* End the statistics of the file that was begun last, and count what the context holds for it.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+ * AssemblerContext *context: the context that assembled the file (before it is reset).
+ * AssemblerStatus status: the status of the file.
+ * Boolean cached: true if the file was restored from the cache (the context is empty then).
+*/
+void endFileStats(Stats *stats, AssemblerContext *context, AssemblerStatus status, Boolean cached) {
+  FileStats *file;
+  unsigned long counters[NUM_OF_COUNTERS];
+  int i;
+
+  context->phaseHook = NULL;
+  context->phaseData = NULL;
+  if (stats->length == 0) {
+    return;
+  }
+
+  file = &stats->files[stats->length - 1];
+  file->time = getMonotonicTime() - stats->fileBegin;
+  if (stats->counters.numOfAvailable > 0) {
+    readCounters(&stats->counters, counters);
+    for (i = 0; i < NUM_OF_COUNTERS; i++) {
+      file->counters[i] = counters[i] - stats->fileCountersBegin[i];
+    }
+  }
+  file->status = status;
+  file->cached = cached;
+  file->allocations = getAllocationsCount() - stats->allocationsBegin;
+  file->allocatedBytes = getAllocatedBytes() - stats->allocatedBytesBegin;
+  file->peakMemory = getPeakMemory();
+  if (cached == false) {
+    countFileStats(file, context);
+  }
+}
+
+/* Print the statistics to stderr, in their format.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+*/
+void printStats(Stats *stats) {
+  if (stats->format == STATS_JSON) {
+    printStatsJson(stats);
+  } else {
+    printStatsTable(stats);
+  }
+}
+
+/* Get the time of monotonic clock.
+ *
+ * Returns:
+ * double time: the time in seconds.
+*/
+double getMonotonicTime(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/* Get the high-water mark of the resident memory of the process.
+ *
+ * Returns:
+ * long peak: the peak resident memory in KB.
+*/
+long getPeakMemory(void) {
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  return usage.ru_maxrss;
+}
+
+/* The phase hook of the context - add the time (and the counters) of every phase to the file that is
+ * assembled. Begin of phase that is already open would restart it, and end of phase that is not open
+ * would add the time since its last begin, so both are ignored.
+ *
+ * Params:
+ * void *data: pointer to the statistics.
+ * AssemblerPhase phase: the phase.
+ * Boolean begin: true at the begin of the phase, false at its end.
+*/
+void recordPhase(void *data, AssemblerPhase phase, Boolean begin) {
+  Stats *stats = (Stats *) data;
+  unsigned long counters[NUM_OF_COUNTERS];
+  FileStats *file;
+  int i;
+
+  if (stats->openPhases[phase] == begin) {
+    return;
+  }
+  stats->openPhases[phase] = begin;
+  if (begin == true) {
+    if (stats->counters.numOfAvailable > 0) {
+      readCounters(&stats->counters, stats->phaseCountersBegin[phase]);
+    }
+    stats->phaseBegin[phase] = getMonotonicTime();
+  } else if (stats->length > 0) {
+    file = &stats->files[stats->length - 1];
+    file->phases[phase] += getMonotonicTime() - stats->phaseBegin[phase];
+    if (stats->counters.numOfAvailable > 0) {
+      readCounters(&stats->counters, counters);
+      for (i = 0; i < NUM_OF_COUNTERS; i++) {
+        file->phaseCounters[phase][i] += counters[i] - stats->phaseCountersBegin[phase][i];
+      }
+    }
+  }
+}
+
+/* Count the lines, the commands, the data, the labels and the references to externals of file.
+ *
+ * Params:
+ * FileStats *file: the statistics of the file.
+ * AssemblerContext *context: the context that assembled the file.
+*/
+void countFileStats(FileStats *file, AssemblerContext *context) {
+  LabelTable *labels = &context->labels;
+  SymbolId id;
+
+  file->lines = context->numOfLines;
+  file->commands = (context->IC - 100) / 4;
+  file->dataBytes = context->DC;
+  file->labels = labels->length;
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_EXTERNAL) {
+      file->externalReferences += labels->items[id].appearancesLength;
+    }
+  }
+}
+
+/* Print the statistics as table for humans.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+*/
+void printStatsTable(Stats *stats) {
+  FileStats *file;
+  double time = 0;
+  unsigned long allocations = 0, allocatedBytes = 0;
+  int i, j;
+
+  for (i = 0; i < stats->length; i++) {
+    file = &stats->files[i];
+    fprintf(stderr, "%s: %s%s\n", file->name, file->status == assembled ? "assembled" : "errors",
+            file->cached == true ? " (restored from cache)" : "");
+    if (file->cached == false) {
+      fprintf(stderr, "  lines %lu, commands %lu, data bytes %lu, labels %lu, external references %lu\n",
+              file->lines, file->commands, file->dataBytes, file->labels, file->externalReferences);
+    }
+    fprintf(stderr, "  allocations %lu (%lu bytes), peak memory %ld KB\n",
+            file->allocations, file->allocatedBytes, file->peakMemory);
+    fprintf(stderr, "  %-16s %12s", "phase", "time (ms)");
+    for (j = 0; j < NUM_OF_COUNTERS && stats->counters.numOfAvailable > 0; j++) {
+      fprintf(stderr, " %14s", counterNames[j]);
+    }
+    if (isCounterAvailable(&stats->counters, COUNTER_CYCLES) == true &&
+        isCounterAvailable(&stats->counters, COUNTER_INSTRUCTIONS) == true) {
+      fprintf(stderr, " %6s", "IPC");
+    }
+    fputc('\n', stderr);
+    for (j = 0; j < NUM_OF_PHASES; j++) {
+      if (file->phases[j] > 0) {
+        printCountersRow(stats, phaseNames[j], file->phases[j], file->phaseCounters[j]);
+      }
+    }
+    printCountersRow(stats, "total", file->time, file->counters);
+    time += file->time;
+    allocations += file->allocations;
+    allocatedBytes += file->allocatedBytes;
+  }
+  fprintf(stderr, "total: %d files, %.3f ms, allocations %lu (%lu bytes), peak memory %ld KB\n",
+          stats->length, time * 1000, allocations, allocatedBytes, getPeakMemory());
+}
+
+/* Print the statistics as JSON object.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+*/
+void printStatsJson(Stats *stats) {
+  FileStats *file;
+  double time = 0;
+  unsigned long allocations = 0, allocatedBytes = 0;
+  int i, j;
+
+  fprintf(stderr, "{\"files\": [");
+  for (i = 0; i < stats->length; i++) {
+    file = &stats->files[i];
+    fprintf(stderr, "%s\n  {\"name\": ", i == 0 ? "" : ",");
+    printJsonString(file->name);
+    fprintf(stderr, ", \"status\": \"%s\", \"cached\": %s", file->status == assembled ? "assembled" : "errors",
+            file->cached == true ? "true" : "false");
+    fprintf(stderr, ", \"lines\": %lu, \"commands\": %lu, \"dataBytes\": %lu, \"labels\": %lu"
+                    ", \"externalReferences\": %lu",
+            file->lines, file->commands, file->dataBytes, file->labels, file->externalReferences);
+    fprintf(stderr, ", \"allocations\": %lu, \"allocatedBytes\": %lu, \"peakMemoryKb\": %ld",
+            file->allocations, file->allocatedBytes, file->peakMemory);
+    fprintf(stderr, ", \"timeMs\": %.3f, \"phasesMs\": {", file->time * 1000);
+    for (j = 0; j < NUM_OF_PHASES; j++) {
+      fprintf(stderr, "%s\"%s\": %.3f", j == 0 ? "" : ", ", phaseNames[j], file->phases[j] * 1000);
+    }
+    fprintf(stderr, "}");
+    if (stats->counters.numOfAvailable > 0) {
+      fprintf(stderr, ", \"counters\": ");
+      printJsonCounters(stats, file->counters);
+      fprintf(stderr, ", \"phaseCounters\": {");
+      for (j = 0; j < NUM_OF_PHASES; j++) {
+        fprintf(stderr, "%s\"%s\": ", j == 0 ? "" : ", ", phaseNames[j]);
+        printJsonCounters(stats, file->phaseCounters[j]);
+      }
+      fprintf(stderr, "}");
+    }
+    fprintf(stderr, "}");
+    time += file->time;
+    allocations += file->allocations;
+    allocatedBytes += file->allocatedBytes;
+  }
+  fprintf(stderr, "\n], \"total\": {\"files\": %d, \"timeMs\": %.3f, \"allocations\": %lu, \"allocatedBytes\": %lu"
+                  ", \"peakMemoryKb\": %ld}}\n",
+          stats->length, time * 1000, allocations, allocatedBytes, getPeakMemory());
+}
+
+/* Print row of the table - the time and the counters of phase (or of the whole file).
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+ * char *name: the name of the row.
+ * double time: the time in seconds.
+ * unsigned long *counters: the values of the counters.
+*/
+void printCountersRow(Stats *stats, char *name, double time, unsigned long *counters) {
+  int i;
+
+  fprintf(stderr, "  %-16s %12.3f", name, time * 1000);
+  for (i = 0; i < NUM_OF_COUNTERS && stats->counters.numOfAvailable > 0; i++) {
+    if (isCounterAvailable(&stats->counters, i) == true) {
+      fprintf(stderr, " %14lu", counters[i]);
+    } else {
+      fprintf(stderr, " %14s", "n/a");
+    }
+  }
+  if (isCounterAvailable(&stats->counters, COUNTER_CYCLES) == true &&
+      isCounterAvailable(&stats->counters, COUNTER_INSTRUCTIONS) == true) {
+    fprintf(stderr, " %6.2f",
+            counters[COUNTER_CYCLES] == 0 ? 0.0 : (double) counters[COUNTER_INSTRUCTIONS] / counters[COUNTER_CYCLES]);
+  }
+  fputc('\n', stderr);
+}
+
+/* Print the counters as JSON object, counter that is not available is null.
+ *
+ * Params:
+ * Stats *stats: pointer to the statistics.
+ * unsigned long *counters: the values of the counters.
+*/
+void printJsonCounters(Stats *stats, unsigned long *counters) {
+  int i;
+
+  fputc('{', stderr);
+  for (i = 0; i < NUM_OF_COUNTERS; i++) {
+    fprintf(stderr, "%s\"%s\": ", i == 0 ? "" : ", ", counterNames[i]);
+    if (isCounterAvailable(&stats->counters, i) == true) {
+      fprintf(stderr, "%lu", counters[i]);
+    } else {
+      fprintf(stderr, "null");
+    }
+  }
+  fputc('}', stderr);
+}
+
+/* Print string to stderr as JSON string (in quotes, with escapes).
+ *
+ * Params:
+ * char *string: the string.
+*/
+void printJsonString(char *string) {
+  fputc('"', stderr);
+  for (; *string != '\0'; string++) {
+    if (*string == '"' || *string == '\\') {
+      fprintf(stderr, "\\%c", *string);
+    } else if ((unsigned char) *string < 0x20) {
+      fprintf(stderr, "\\u%04x", (unsigned char) *string);
+    } else {
+      fputc(*string, stderr);
+    }
+  }
+  fputc('"', stderr);
+}
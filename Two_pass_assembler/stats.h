@@ -0,0 +1,63 @@
+#ifndef MAMAN14_STATS_H
+#define MAMAN14_STATS_H
+
+#include "libassembler.h"
+#include "counters.h"
+
+/* Formats of the statistics report. */
+#define STATS_NONE 0
+#define STATS_TABLE 1
+#define STATS_JSON 2
+
+/* Data structure representing the statistics of one file. */
+typedef struct fileStats {
+    char *name;
+    AssemblerStatus status;
+    Boolean cached;
+    double phases[NUM_OF_PHASES];
+    unsigned long phaseCounters[NUM_OF_PHASES][NUM_OF_COUNTERS];
+    double time;
+    unsigned long counters[NUM_OF_COUNTERS];
+    unsigned long lines;
+    unsigned long commands;
+    unsigned long dataBytes;
+    unsigned long labels;
+    unsigned long externalReferences;
+    unsigned long allocations;
+    unsigned long allocatedBytes;
+    long peakMemory;
+} FileStats;
+
+/* Data structure representing the statistics of all the files of one run. */
+typedef struct stats {
+    int format;
+    FileStats *files;
+    int length;
+    int capacity;
+    double phaseBegin[NUM_OF_PHASES];
+    /* The phases of the file that are open - phase is timed and counted from its first begin to its end. */
+    Boolean openPhases[NUM_OF_PHASES];
+    double fileBegin;
+    /* The hardware counters of --counters, numOfAvailable is 0 without it. */
+    Counters counters;
+    unsigned long phaseCountersBegin[NUM_OF_PHASES][NUM_OF_COUNTERS];
+    unsigned long fileCountersBegin[NUM_OF_COUNTERS];
+    unsigned long allocationsBegin;
+    unsigned long allocatedBytesBegin;
+} Stats;
+
+void initStats(Stats *stats, int format);
+
+void freeStats(Stats *stats);
+
+void enableStatsCounters(Stats *stats);
+
+void beginFileStats(Stats *stats, char *filename, AssemblerContext *context);
+
+void endFileStats(Stats *stats, AssemblerContext *context, AssemblerStatus status, Boolean cached);
+
+void printStats(Stats *stats);
+
+double getMonotonicTime(void);
+
+#endif
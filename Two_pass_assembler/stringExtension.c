@@ -19,7 +19,6 @@ char *duplicateStr(char *src) {
   duplicate = (char *) calloc(strlen(src) + 1, sizeof(char));
 
   if (duplicate == NULL) {
-    printf("Error: Allocation Error! \n");
     return NULL;
   }
 
@@ -102,40 +101,42 @@ char *trimStr(char *string) {
 char **strSplit(char *str, const char del) {
   char **result = 0;
   size_t count = 0;
+  size_t length;
   char *tmp = str;
-  char *last_comma = 0;
   char delim[2];
   delim[0] = del;
   delim[1] = 0;
 
-  /* Count how many elements will be extracted. */
+  /* Count how many elements can be extracted, each one follows a delimiter or the start. */
   while (*tmp) {
     if (del == *tmp) {
       count++;
-      last_comma = tmp;
     }
     tmp++;
   }
 
-  /* Add space for trailing token. */
-  count += last_comma < (str + strlen(str) - 1);
-
-  /* Add space for terminating null string so caller
+  /* Add space for trailing token and for terminating null string so caller
      knows where the list of returned strings ends. */
-  count++;
+  count += 2;
 
   result = malloc(sizeof(char *) * count);
 
   if (result) {
     size_t idx = 0;
-    char *token = strtok(str, delim);
 
-    while (token) {
-      assert(idx < count);
-      *(result + idx++) = duplicateStr(token);
-      token = strtok(0, delim);
+    /* Like strtok, empty tokens are skipped, but no state is kept between calls
+       so strings can be split in more than one thread at once. */
+    tmp = str + strspn(str, delim);
+    while (*tmp) {
+      length = strcspn(tmp, delim);
+      if (tmp[length] != '\0') {
+        tmp[length++] = '\0';
+      }
+      assert(idx < count - 1);
+      *(result + idx++) = duplicateStr(tmp);
+      tmp += length;
+      tmp += strspn(tmp, delim);
     }
-    assert(idx == count - 1);
     *(result + idx) = 0;
   }
 
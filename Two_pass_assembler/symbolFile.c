@@ -0,0 +1,278 @@
+#include "symbolFile.h"
+
+/* Data structure representing symbol that is written into .sym file. */
+typedef struct symbolFileItem {
+    char *name;
+    SymbolId id;
+} SymbolFileItem;
+
+int compareSymbolFileItems(const void *first, const void *second);
+
+/* Compare two symbols by their names, for sorting the sections of .sym file.
+ *
+ * Params:
+ * const void *first: pointer to the first SymbolFileItem.
+ * const void *second: pointer to the second SymbolFileItem.
+ *
+ * Returns:
+ * int result: negative, zero or positive like strcmp.
+*/
+int compareSymbolFileItems(const void *first, const void *second) {
+  return strcmp(((SymbolFileItem *) first)->name, ((SymbolFileItem *) second)->name);
+}
+
+/*
+ * Creates the content of .sym file - sorted and hashed binary table of the entries, the externals and
+ * the appearances of the externals.
+ *
+ * Params:
+ * Outputs *outputs: the contents of the output files.
+ * LabelTable *labels: a pointer to the labels table.
+ */
+void createSymbolFile(Outputs *outputs, LabelTable *labels) {
+  unsigned long numOfEntries = 0, numOfExternals = 0, numOfReferences = 0, stringsSize = 0;
+  unsigned long numOfRecords, firstExternal, numOfBuckets = 2, i, bucket, nameOffset = 0, firstReference = 0;
+  unsigned long *buckets;
+  SymbolFileItem *items;
+  Label *label;
+  Buffer *buffer = &outputs->symbols;
+  SymbolId id;
+  int j;
+
+  for (id = 0; id < labels->length; id++) {
+    label = &labels->items[id];
+    if (label->attr & ATTR_ENTRY) {
+      numOfEntries++;
+    } else if (label->attr & ATTR_EXTERNAL) {
+      numOfExternals++;
+      numOfReferences += label->appearancesLength;
+    } else {
+      continue;
+    }
+    stringsSize += strlen(getLabelName(labels, id)) + 1;
+  }
+
+  numOfRecords = numOfEntries + numOfExternals;
+  firstExternal = numOfEntries;
+  while (numOfBuckets < numOfRecords * 2) {
+    numOfBuckets *= 2;
+  }
+
+  items = (SymbolFileItem *) calloc(numOfRecords + 1, sizeof(SymbolFileItem));
+  buckets = (unsigned long *) calloc(numOfBuckets, sizeof(unsigned long));
+  if (items == NULL || buckets == NULL) {
+    free(items);
+    free(buckets);
+    return;
+  }
+
+  /* Entries section comes first, then externals section, each one sorted by name. */
+  numOfEntries = 0;
+  numOfExternals = 0;
+  for (id = 0; id < labels->length; id++) {
+    if (labels->items[id].attr & ATTR_ENTRY) {
+      i = numOfEntries++;
+    } else if (labels->items[id].attr & ATTR_EXTERNAL) {
+      i = firstExternal + numOfExternals++;
+    } else {
+      continue;
+    }
+    items[i].name = getLabelName(labels, id);
+    items[i].id = id;
+  }
+  qsort(items, numOfEntries, sizeof(SymbolFileItem), compareSymbolFileItems);
+  qsort(items + numOfEntries, numOfExternals, sizeof(SymbolFileItem), compareSymbolFileItems);
+
+  for (i = 0; i < numOfBuckets; i++) {
+    buckets[i] = SYM_EMPTY_BUCKET;
+  }
+  for (i = 0; i < numOfRecords; i++) {
+    bucket = labels->items[items[i].id].hash & (numOfBuckets - 1);
+    while (buckets[bucket] != SYM_EMPTY_BUCKET) {
+      bucket = (bucket + 1) & (numOfBuckets - 1);
+    }
+    buckets[bucket] = i;
+  }
+
+  outputs->hasSymbols = true;
+  appendBuffer(buffer, SYM_MAGIC, 4);
+  appendField(buffer, SYM_VERSION);
+  appendField(buffer, numOfEntries);
+  appendField(buffer, numOfExternals);
+  appendField(buffer, numOfReferences);
+  appendField(buffer, numOfBuckets);
+  appendField(buffer, stringsSize);
+  appendField(buffer, 0);
+
+  for (i = 0; i < numOfRecords; i++) {
+    label = &labels->items[items[i].id];
+    appendField(buffer, label->hash);
+    appendField(buffer, nameOffset);
+    if (i < numOfEntries) {
+      appendField(buffer, label->value);
+      appendField(buffer, label->attr);
+    } else {
+      appendField(buffer, firstReference);
+      appendField(buffer, label->appearancesLength);
+      firstReference += label->appearancesLength;
+    }
+    nameOffset += strlen(items[i].name) + 1;
+  }
+
+  for (i = numOfEntries; i < numOfRecords; i++) {
+    label = &labels->items[items[i].id];
+    for (j = 0; j < label->appearancesLength; j++) {
+      appendField(buffer, label->appearances[j]);
+    }
+  }
+
+  for (i = 0; i < numOfBuckets; i++) {
+    appendField(buffer, buckets[i]);
+  }
+
+  for (i = 0; i < numOfRecords; i++) {
+    appendBuffer(buffer, items[i].name, strlen(items[i].name) + 1);
+  }
+
+  free(items);
+  free(buckets);
+}
+
+/* Read 32 bits little endian field from .sym image.
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * unsigned long offset: the offset of the field in bytes.
+ *
+ * Returns:
+ * unsigned long value: the value of the field.
+*/
+unsigned long readSymbolField(const unsigned char *image, unsigned long offset) {
+  return readField(image, offset);
+}
+
+/* Check that the image is a .sym file that this version can read, and that all its sections are in it.
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * unsigned long length: the length of the image in bytes.
+ *
+ * Returns:
+ * Boolean status: true if the image is valid, otherwise - false.
+*/
+Boolean isSymbolImage(const unsigned char *image, unsigned long length) {
+  unsigned long size;
+
+  if (length < SYM_HEADER_SIZE || memcmp(image, SYM_MAGIC, 4) != 0 ||
+      readSymbolField(image, 4 * SYM_FIELD_VERSION) != SYM_VERSION) {
+    return false;
+  }
+
+  size = SYM_HEADER_SIZE +
+         SYM_RECORD_SIZE * (readSymbolField(image, 4 * SYM_FIELD_ENTRIES) +
+                            readSymbolField(image, 4 * SYM_FIELD_EXTERNALS)) +
+         4 * (readSymbolField(image, 4 * SYM_FIELD_REFERENCES) + readSymbolField(image, 4 * SYM_FIELD_BUCKETS)) +
+         readSymbolField(image, 4 * SYM_FIELD_STRINGS);
+  if (size > length) {
+    return false;
+  }
+  return true;
+}
+
+/* Get record by its index (entries first, then externals).
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * unsigned long index: the index of the record.
+ *
+ * Returns:
+ * const unsigned char *record: pointer to the record in the image.
+*/
+const unsigned char *getSymbolRecord(const unsigned char *image, unsigned long index) {
+  return image + SYM_HEADER_SIZE + SYM_RECORD_SIZE * index;
+}
+
+/* Get the name of the symbol of record.
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * const unsigned char *record: pointer to the record in the image.
+ *
+ * Returns:
+ * const char *name: the name of the symbol.
+*/
+const char *getSymbolRecordName(const unsigned char *image, const unsigned char *record) {
+  unsigned long numOfRecords = readSymbolField(image, 4 * SYM_FIELD_ENTRIES) +
+                               readSymbolField(image, 4 * SYM_FIELD_EXTERNALS);
+  unsigned long strings = SYM_HEADER_SIZE + SYM_RECORD_SIZE * numOfRecords +
+                          4 * (readSymbolField(image, 4 * SYM_FIELD_REFERENCES) +
+                               readSymbolField(image, 4 * SYM_FIELD_BUCKETS));
+  return (const char *) image + strings + readSymbolField(record, 4 * SYM_RECORD_NAME);
+}
+
+/* Find symbol record by hash probe.
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * char *name: the name of the symbol.
+ *
+ * Returns:
+ * long index: the index of the record, or -1 if there is no symbol with this name.
+*/
+long findSymbolRecord(const unsigned char *image, char *name) {
+  unsigned long numOfRecords = readSymbolField(image, 4 * SYM_FIELD_ENTRIES) +
+                               readSymbolField(image, 4 * SYM_FIELD_EXTERNALS);
+  unsigned long numOfBuckets = readSymbolField(image, 4 * SYM_FIELD_BUCKETS);
+  unsigned long buckets = SYM_HEADER_SIZE + SYM_RECORD_SIZE * numOfRecords +
+                          4 * readSymbolField(image, 4 * SYM_FIELD_REFERENCES);
+  unsigned long hash = hashSymbol(name), bucket, index, probes;
+  const unsigned char *record;
+
+  bucket = hash & (numOfBuckets - 1);
+  for (probes = 0; probes < numOfBuckets; probes++) {
+    index = readSymbolField(image, buckets + 4 * bucket);
+    if (index == SYM_EMPTY_BUCKET) {
+      return -1;
+    }
+    record = getSymbolRecord(image, index);
+    if (readSymbolField(record, 4 * SYM_RECORD_HASH) == hash &&
+        strcmp(getSymbolRecordName(image, record), name) == 0) {
+      return (long) index;
+    }
+    bucket = (bucket + 1) & (numOfBuckets - 1);
+  }
+  return -1;
+}
+
+/* Find symbol record by binary search in the entries section or in the externals section.
+ *
+ * Params:
+ * const unsigned char *image: the content of .sym file.
+ * char *name: the name of the symbol.
+ * Boolean externals: true to search the externals section, false to search the entries section.
+ *
+ * Returns:
+ * long index: the index of the record, or -1 if there is no symbol with this name.
+*/
+long searchSymbolRecord(const unsigned char *image, char *name, Boolean externals) {
+  unsigned long low = 0, high = readSymbolField(image, 4 * SYM_FIELD_ENTRIES), middle;
+  int result;
+
+  if (externals == true) {
+    low = high;
+    high += readSymbolField(image, 4 * SYM_FIELD_EXTERNALS);
+  }
+
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    result = strcmp(name, getSymbolRecordName(image, getSymbolRecord(image, middle)));
+    if (result == 0) {
+      return (long) middle;
+    } else if (result < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return -1;
+}
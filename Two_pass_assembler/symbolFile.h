@@ -0,0 +1,58 @@
+#ifndef MAMAN14_SYMBOLFILE_H
+#define MAMAN14_SYMBOLFILE_H
+
+#include "Datatypes.h"
+#include "files.h"
+
+/*
+ * Layout of .sym file - binary symbols table that can be mapped into memory and searched as is.
+ * All the fields are 32 bits unsigned integers in little endian.
+ *
+ * header:     magic "ASYM", version, entries count, externals count, references count,
+ *             hash buckets count (power of 2), strings size, reserved.
+ * records:    entries and then externals, each section sorted by name, every record is
+ *             hash, name offset (in strings), value, flags (entries) /
+ *             hash, name offset (in strings), first reference, references count (externals).
+ * references: addresses of the appearances of all externals, in the order of externals section.
+ * buckets:    open addressing hash table (linear probing) of record indexes, empty bucket is SYM_EMPTY_BUCKET.
+ * strings:    the names of the symbols, each one ends with '\0'.
+ *
+ * The hash of name is FNV-1a 32 bits (hashSymbol).
+ */
+#define SYM_MAGIC "ASYM"
+#define SYM_VERSION 1
+#define SYM_HEADER_SIZE 32
+#define SYM_RECORD_SIZE 16
+#define SYM_EMPTY_BUCKET 0xFFFFFFFFUL
+
+/* Indexes of header fields. */
+#define SYM_FIELD_VERSION 1
+#define SYM_FIELD_ENTRIES 2
+#define SYM_FIELD_EXTERNALS 3
+#define SYM_FIELD_REFERENCES 4
+#define SYM_FIELD_BUCKETS 5
+#define SYM_FIELD_STRINGS 6
+
+/* Indexes of record fields. */
+#define SYM_RECORD_HASH 0
+#define SYM_RECORD_NAME 1
+#define SYM_RECORD_VALUE 2
+#define SYM_RECORD_FLAGS 3
+#define SYM_RECORD_FIRST_REFERENCE 2
+#define SYM_RECORD_REFERENCES 3
+
+void createSymbolFile(Outputs *outputs, LabelTable *labels);
+
+unsigned long readSymbolField(const unsigned char *image, unsigned long offset);
+
+Boolean isSymbolImage(const unsigned char *image, unsigned long length);
+
+const unsigned char *getSymbolRecord(const unsigned char *image, unsigned long index);
+
+const char *getSymbolRecordName(const unsigned char *image, const unsigned char *record);
+
+long findSymbolRecord(const unsigned char *image, char *name);
+
+long searchSymbolRecord(const unsigned char *image, char *name, Boolean externals);
+
+#endif
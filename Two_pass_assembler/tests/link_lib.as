@@ -0,0 +1,11 @@
+; The library module of the linker test, uses MAIN of link_main.as.
+.entry sum
+.entry TABLE
+.extern MAIN
+sum: add $1,$2,$3
+ la MSG
+ bgt $1,$2,DONE
+ jmp MAIN
+DONE: jmp $31
+MSG: .asciz "hi"
+TABLE: .dh 1,2,3
@@ -0,0 +1,14 @@
+; The main module of the linker test, uses sum and TABLE of link_lib.as.
+.entry MAIN
+.extern sum
+.extern TABLE
+MAIN: la TABLE
+ call sum
+ lw $1,0,$2
+LOOP: addi $1,-1,$1
+ bne $1,$0,LOOP
+ blt $1,$2,sum
+ jmp LOOP
+ la COUNT
+ stop
+COUNT: .dw 3
@@ -0,0 +1,15 @@
+.entry X11
+.extern R5
+MAIN: jmp $0
+ add $0,$1,$31
+ move $0,$2
+ bne $0,$31,X11
+ jmp X11
+ call R5
+ la R12
+ jmp R5
+X11: addi $0,-1,$0
+ jmp $31
+ stop
+R12: .dw 5,-5
+ la X11
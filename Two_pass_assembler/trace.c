@@ -0,0 +1,315 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace.h"
+#include "stats.h"
+
+/* The trace of the run, NULL when it is not traced. */
+Tracer *tracer = NULL;
+
+TraceThread *getTraceThread(void);
+
+void addTraceEvent(char *name, char *category, char phase, char *file, long lines, long bytes);
+
+void appendJsonString(Buffer *buffer, char *string);
+
+void tracePhase(void *data, AssemblerPhase phase, Boolean begin);
+
+void traceEndPhase(Tracer *trace, AssemblerPhase phase);
+
+/* Start tracing the run into file, the calling thread is named "main".
+ *
+ * Params:
+ * char *path: the path of the trace file.
+ *
+ * Returns:
+ * Boolean status: true if the trace started, false if the file cannot be created.
+*/
+Boolean startTrace(char *path) {
+  Tracer *newTracer = (Tracer *) malloc(sizeof(Tracer));
+
+  if (newTracer == NULL) {
+    return false;
+  }
+  newTracer->file = fopen(path, "w");
+  if (newTracer->file == NULL || pthread_key_create(&newTracer->key, NULL) != 0) {
+    if (newTracer->file != NULL) {
+      fclose(newTracer->file);
+    }
+    free(newTracer);
+    fprintf(stderr, "Cannot create trace file %s \n", path);
+    return false;
+  }
+  pthread_mutex_init(&newTracer->lock, NULL);
+  newTracer->pid = (int) getpid();
+  newTracer->start = getMonotonicTime();
+  newTracer->threads = NULL;
+  newTracer->numOfThreads = 0;
+  newTracer->context = NULL;
+  newTracer->nextHook = NULL;
+  newTracer->nextData = NULL;
+  tracer = newTracer;
+  nameTraceThread("main");
+  return true;
+}
+
+/* Write the events of all the threads to the trace file and stop tracing.
+ * The other threads must be done by now.
+*/
+void finishTrace(void) {
+  TraceThread *thread;
+  TraceThread *next;
+
+  if (tracer == NULL) {
+    return;
+  }
+
+  fprintf(tracer->file, "{\"traceEvents\": [\n");
+  fprintf(tracer->file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"args\": {\"name\": \"assembler\"}}",
+          tracer->pid);
+  for (thread = tracer->threads; thread != NULL; thread = thread->next) {
+    fprintf(tracer->file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, "
+                          "\"args\": {\"name\": \"%s\"}}", tracer->pid, thread->id, thread->name);
+  }
+  for (thread = tracer->threads; thread != NULL; thread = thread->next) {
+    fwrite(thread->events.data, 1, thread->events.length, tracer->file);
+  }
+  fprintf(tracer->file, "\n], \"displayTimeUnit\": \"ms\"}\n");
+  fclose(tracer->file);
+
+  for (thread = tracer->threads; thread != NULL; thread = next) {
+    next = thread->next;
+    freeBuffer(&thread->events);
+    free(thread);
+  }
+  pthread_key_delete(tracer->key);
+  pthread_mutex_destroy(&tracer->lock);
+  free(tracer);
+  tracer = NULL;
+}
+
+/* Name the calling thread in the trace.
+ *
+ * Params:
+ * char *name: the name of the thread.
+*/
+void nameTraceThread(char *name) {
+  TraceThread *thread;
+
+  if (tracer == NULL || (thread = getTraceThread()) == NULL) {
+    return;
+  }
+  strncpy(thread->name, name, sizeof(thread->name) - 1);
+  thread->name[sizeof(thread->name) - 1] = '\0';
+}
+
+/* Begin span on the calling thread.
+ *
+ * Params:
+ * char *name: the name of the span.
+ * char *category: the category of the span.
+ * char *file: the file that the span is about, or NULL.
+*/
+void traceBegin(char *name, char *category, char *file) {
+  if (tracer == NULL) {
+    return;
+  }
+  addTraceEvent(name, category, 'B', file, -1, -1);
+}
+
+/* End the last span that was begun on the calling thread.
+ *
+ * Params:
+ * char *name: the name of the span.
+ * char *category: the category of the span.
+ * long lines: the number of lines that the span handled, or -1.
+ * long bytes: the number of bytes that the span handled, or -1.
+*/
+void traceEnd(char *name, char *category, long lines, long bytes) {
+  if (tracer == NULL) {
+    return;
+  }
+  addTraceEvent(name, category, 'E', NULL, lines, bytes);
+}
+
+/* Begin the span of file, and trace the phases of the context until the file ends.
+ * The phase hook that is already installed (of --stats) is still called.
+ *
+ * Params:
+ * char *filename: the name of the file.
+ * AssemblerContext *context: the context that assembles the file.
+*/
+void beginFileTrace(char *filename, AssemblerContext *context) {
+  int i;
+
+  if (tracer == NULL) {
+    return;
+  }
+  for (i = 0; i < NUM_OF_PHASES; i++) {
+    tracer->openPhases[i] = false;
+  }
+  traceBegin(filename, "file", filename);
+  tracer->context = context;
+  tracer->nextHook = context->phaseHook;
+  tracer->nextData = context->phaseData;
+  context->phaseHook = tracePhase;
+  context->phaseData = tracer;
+}
+
+/* End the span of file, and restore the phase hook of the context.
+ *
+ * Params:
+ * char *filename: the name of the file.
+ * AssemblerContext *context: the context that assembled the file (before it is reset).
+ * long bytes: the size of the source, or -1.
+*/
+void endFileTrace(char *filename, AssemblerContext *context, long bytes) {
+  if (tracer == NULL) {
+    return;
+  }
+  context->phaseHook = tracer->nextHook;
+  context->phaseData = tracer->nextData;
+  tracer->context = NULL;
+  traceEnd(filename, "file", context->numOfLines, bytes);
+}
+
+/* Get the events of the calling thread, they are created at the first event of the thread.
+ *
+ * Returns:
+ * TraceThread *thread: the events of the thread, or NULL if there is no memory.
+*/
+TraceThread *getTraceThread(void) {
+  TraceThread *thread = (TraceThread *) pthread_getspecific(tracer->key);
+
+  if (thread != NULL) {
+    return thread;
+  }
+  thread = (TraceThread *) malloc(sizeof(TraceThread));
+  if (thread == NULL) {
+    return NULL;
+  }
+  initBuffer(&thread->events);
+  pthread_mutex_lock(&tracer->lock);
+  thread->id = ++tracer->numOfThreads;
+  thread->next = tracer->threads;
+  tracer->threads = thread;
+  pthread_mutex_unlock(&tracer->lock);
+  sprintf(thread->name, "thread %d", thread->id);
+  pthread_setspecific(tracer->key, thread);
+  return thread;
+}
+
+/* Add event to the buffer of the calling thread, the time is in microseconds since the start.
+ *
+ * Params:
+ * char *name: the name of the span.
+ * char *category: the category of the span.
+ * char phase: 'B' for begin, 'E' for end.
+ * char *file: the file argument, or NULL.
+ * long lines: the lines argument, or -1.
+ * long bytes: the bytes argument, or -1.
+*/
+void addTraceEvent(char *name, char *category, char phase, char *file, long lines, long bytes) {
+  double now = getMonotonicTime();
+  TraceThread *thread = getTraceThread();
+  Buffer *events;
+  char *separator = "";
+
+  if (thread == NULL) {
+    return;
+  }
+  events = &thread->events;
+  appendBuffer(events, ",\n{\"name\": ", 11);
+  appendJsonString(events, name);
+  bufferPrintf(events, ", \"cat\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d, \"args\": {",
+               category, phase, (now - tracer->start) * 1e6, tracer->pid, thread->id);
+  if (file != NULL) {
+    appendBuffer(events, "\"file\": ", 8);
+    appendJsonString(events, file);
+    separator = ", ";
+  }
+  if (lines >= 0) {
+    bufferPrintf(events, "%s\"lines\": %ld", separator, lines);
+    separator = ", ";
+  }
+  if (bytes >= 0) {
+    bufferPrintf(events, "%s\"bytes\": %ld", separator, bytes);
+  }
+  appendBuffer(events, "}}", 2);
+}
+
+/* Append string to buffer as JSON string (in quotes, with escapes).
+ *
+ * Params:
+ * Buffer *buffer: the buffer.
+ * char *string: the string.
+*/
+void appendJsonString(Buffer *buffer, char *string) {
+  appendBuffer(buffer, "\"", 1);
+  for (; *string != '\0'; string++) {
+    if (*string == '"' || *string == '\\') {
+      bufferPrintf(buffer, "\\%c", *string);
+    } else if ((unsigned char) *string < 0x20) {
+      bufferPrintf(buffer, "\\u%04x", (unsigned char) *string);
+    } else {
+      appendBuffer(buffer, string, 1);
+    }
+  }
+  appendBuffer(buffer, "\"", 1);
+}
+
+/* The phase hook of the traced file - span for every phase. Begin of phase that is already open, and
+ * end of phase that is not open, are not written (they would break the nesting of the spans).
+ *
+ * Params:
+ * void *data: pointer to the tracer.
+ * AssemblerPhase phase: the phase.
+ * Boolean begin: true at the begin of the phase, false at its end.
+*/
+void tracePhase(void *data, AssemblerPhase phase, Boolean begin) {
+  Tracer *trace = (Tracer *) data;
+
+  if (trace->openPhases[phase] != begin) {
+    trace->openPhases[phase] = begin;
+    if (begin == true) {
+      traceBegin(phaseNames[phase], "phase", NULL);
+    } else {
+      traceEndPhase(trace, phase);
+    }
+  }
+  if (trace->nextHook != NULL) {
+    trace->nextHook(trace->nextData, phase, begin);
+  }
+}
+
+/* End the span of phase, with the lines that were read so far and the size of the output that the
+ * phase wrote.
+ *
+ * Params:
+ * Tracer *trace: pointer to the tracer.
+ * AssemblerPhase phase: the phase.
+*/
+void traceEndPhase(Tracer *trace, AssemblerPhase phase) {
+  Outputs *outputs = &trace->context->outputs;
+  long bytes = -1;
+
+  if (phase == object_phase) {
+    bytes = (long) outputs->object.length;
+  } else if (phase == entries_phase) {
+    bytes = (long) outputs->entries.length;
+  } else if (phase == externals_file_phase) {
+    bytes = (long) outputs->externals.length;
+  } else if (phase == symbols_phase) {
+    bytes = (long) outputs->symbols.length;
+  } else if (phase == report_phase) {
+    bytes = (long) outputs->report.length;
+  } else if (phase == listing_phase) {
+    bytes = (long) outputs->listing.length;
+  } else if (phase == debug_phase) {
+    bytes = (long) outputs->debug.length;
+  }
+  traceEnd(phaseNames[phase], "phase", trace->context->numOfLines, bytes);
+}
@@ -0,0 +1,54 @@
+#ifndef MAMAN14_TRACE_H
+#define MAMAN14_TRACE_H
+
+#include <pthread.h>
+#include "libassembler.h"
+#include "buffer.h"
+
+/*
+ * Timeline of the run in the Chrome trace event format (it is opened by chrome://tracing or by
+ * Perfetto). Every file and every phase is a span of begin and end events, on the thread that ran it.
+ * Every thread writes its events into its own buffer, and the buffers are written to the file when
+ * the trace is finished. When the trace is not started, every function returns at once.
+ */
+
+/* Data structure representing the events of one thread - only the thread itself writes to it. */
+typedef struct traceThread {
+    int id;
+    char name[32];
+    Buffer events;
+    struct traceThread *next;
+} TraceThread;
+
+/* Data structure representing the trace of the run. */
+typedef struct tracer {
+    FILE *file;
+    int pid;
+    double start;
+    pthread_key_t key;
+    pthread_mutex_t lock;
+    TraceThread *threads;
+    int numOfThreads;
+    /* The file that is assembled, and the phase hook that was installed before the trace. */
+    AssemblerContext *context;
+    PhaseHook nextHook;
+    void *nextData;
+    /* The phases of the file that are open, so every span has one begin and one end. */
+    Boolean openPhases[NUM_OF_PHASES];
+} Tracer;
+
+Boolean startTrace(char *path);
+
+void finishTrace(void);
+
+void nameTraceThread(char *name);
+
+void traceBegin(char *name, char *category, char *file);
+
+void traceEnd(char *name, char *category, long lines, long bytes);
+
+void beginFileTrace(char *filename, AssemblerContext *context);
+
+void endFileTrace(char *filename, AssemblerContext *context, long bytes);
+
+#endif
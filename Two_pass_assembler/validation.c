@@ -7,14 +7,13 @@
 #define DW_MAX_MINUS "-2147483648"
 
 
-ErrorType validateParameters(Label *labels, CmdSubtype type, char **splitedParams);
+ErrorType validateParameters(LabelTable *labels, CmdSubtype type, char **splitedParams);
 
 ErrorType
-runCommandValidation(char *command, Label *labels, CmdSubtype type, char *cmdName, char *label,
+runCommandValidation(char *command, LabelTable *labels, CmdSubtype type, char *cmdName, char *label,
                      char *params);
 
-ErrorType runOrderValidation(Label *labels, int paramNum, OrderType type, char **params,
-                             char *orderName, char *label, char *paramStr);
+ErrorType runOrderValidation(LabelTable *labels, OrderType type, char *orderName, char *label, char *params);
 
 /*
  * Check whether the name of the order sent is correct.
@@ -68,15 +67,15 @@ ErrorType checkCommandName(char *commandName) {
  * Verify the number of parameters by type of command.
  *
  * Params:
- * char *command: the whole command.
+ * char *params: the parameters of the command.
  * CmdSubtype: the type of the command.
  *
  * Returns:
  * ErrorType status: valid if the number of registers is exact, number_of_parameters if ain't.
  */
-ErrorType checkParamNum(char *command, CmdSubtype type) {
+ErrorType checkParamNum(char *params, CmdSubtype type) {
   int check;
-  check = getNumOfParamData(command);
+  check = getNumOfParams(params);
   switch (type) {
     case r_arithmetic_cmd:
     case i_arithmetic_cmd:
@@ -131,31 +130,40 @@ ErrorType checkParamNum(char *command, CmdSubtype type) {
  * Params:
  * char *parameters: the parameters string.
  * CmdSubtype: the type of the command.
- * Label *labels:  labels table.
+ * LabelTable *labels:  labels table.
  *
  * Returns:
  * ErrorType status: valid if the command meets the standard, otherwise the correct error type
  */
-ErrorType checkParamStandard(char *parameters, Label *labels, CmdSubtype type) {
-  char **params;
-  ErrorType status;
-  params = strSplit(parameters, ',');
-  status = validateParameters(labels, type, params);
-  freeStringArray(params);
-  return status;
+ErrorType checkParamStandard(char *parameters, LabelTable *labels, CmdSubtype type) {
+  char storage[LINE_PARTS_SIZE];
+  char *params[MAX_COMMAND_PARAMS + 1];
+  char *iterator = storage;
+  int i = 0;
+
+  /* The number of the parameters and the commas are already checked, they are cut in a copy on the stack. */
+  if (strlen(parameters) >= sizeof(storage)) {
+    return wrong_parameters;
+  }
+  strcpy(storage, parameters);
+  while (i < MAX_COMMAND_PARAMS && (params[i] = myStrsep(&iterator, ",")) != NULL) {
+    i++;
+  }
+  params[i] = NULL;
+  return validateParameters(labels, type, params);
 }
 
 /* Validate parameters is suitable to command type.
  *
  * Params:
- * Label *labels: labels linked list.
+ * LabelTable *labels: labels linked list.
  * CmdSubType type: sub type of cmd.
  * char **params: array string of split parameters.
  *
  * Return:
  * ErrorType status: valid - if parameters suitable to command, otherwise - suitable error.
 */
-ErrorType validateParameters(Label *labels, CmdSubtype type, char **params) {
+ErrorType validateParameters(LabelTable *labels, CmdSubtype type, char **params) {
   switch (type) {
     case r_arithmetic_cmd: {
       if ((checkRegisterName(trimStr(*(params))) == valid) &&
@@ -230,26 +238,25 @@ ErrorType validateParameters(Label *labels, CmdSubtype type, char **params) {
  * ErrorType status: valid if the command is correct, otherwise - missing comma / multiple comma.
  */
 ErrorType checkCommas(char *params) {
-  int i;
-  char *copy, *param, *iterator;
-  /*Check the command word */
-  copy = duplicateStr(params);
-  iterator = copy;
-  while ((param = myStrsep(&iterator, ",")) != NULL) {
-    param = trimStr(param);
+  char *begin, *end;
+
+  /* Every parameter is checked in place, between its commas. */
+  while (params != NULL) {
+    end = params + strcspn(params, ",");
+    begin = params;
+    params = *end == ',' ? end + 1 : NULL;
+    while (begin < end && isspace((unsigned char) *begin)) begin++;
+    while (end > begin && isspace((unsigned char) *(end - 1))) end--;
     /* if found is empty string, it means that args have to , without number. */
-    if (strcmp(param, "") == 0) {
-      free(copy);
+    if (begin == end) {
       return multiple_commas;
     }
-    for (i = 0; i < strlen(param); i++) {
-      if (isspace(param[i])) {
-        free(copy);
+    for (; begin < end; begin++) {
+      if (isspace((unsigned char) *begin)) {
         return missing_comma;
       }
     }
   }
-  free(copy);
   return valid;
 }
 
@@ -277,36 +284,33 @@ Boolean checkParamValue(char *param) {
  *
  * Params:
  * char* command: the whole command.
- * Label *labels: array of all labels.
+ * LabelTable *labels: array of all labels.
  *
  * Returns:
  * ErrorType - valid if the command is correct, the specific error if ain't.
  */
-ErrorType validateCommand(char *command, Label *labels) {
-  ErrorType check;
+ErrorType validateCommand(char *command, LabelTable *labels) {
+  char storage[LINE_PARTS_SIZE];
+  LineParts lineParts;
   CmdSubtype type;
-  char *cmdName = NULL, *label, *params = NULL;
-  LineParts *lineParts = getCommandParts(command);
-  cmdName = lineParts->cmdName;
-  label = lineParts->labelName;
-  params = lineParts->params;
-  type = sortCmd(cmdName);
 
   if (command[0] == ':') {
-    freeLinePart(lineParts);
     return empty_label;
   }
+  /* The parts are cut in a copy on the stack - the lines are at most MAX_LINE_LENGTH. */
+  if (splitCommandParts(command, &lineParts, storage, sizeof(storage)) == false) {
+    return command_name;
+  }
+  type = sortCmd(lineParts.cmdName);
 
-  check = runCommandValidation(command, labels, type, cmdName, label, params);
-  freeLinePart(lineParts);
-  return check;
+  return runCommandValidation(command, labels, type, lineParts.cmdName, lineParts.labelName, lineParts.params);
 }
 
 /* Run all checks for validate commnd.
  *
  * Params:
  * char *command: the whole command.
- * Label *labels: array of all labels.
+ * LabelTable *labels: array of all labels.
  * CmSubtype type: the command sub typee.
  * char *cmdName: the order name.
  * char *label: label name if exists.
@@ -316,7 +320,7 @@ ErrorType validateCommand(char *command, Label *labels) {
  * ErrorType check: the correct status of line.
 */
 ErrorType
-runCommandValidation(char *command, Label *labels, CmdSubtype type, char *cmdName, char *label,
+runCommandValidation(char *command, LabelTable *labels, CmdSubtype type, char *cmdName, char *label,
                      char *params) {
   ErrorType check;
   check = checkLabelName(label);
@@ -335,7 +339,7 @@ runCommandValidation(char *command, Label *labels, CmdSubtype type, char *cmdNam
       return check;
     }
 
-    check = checkParamNum(command, type);
+    check = checkParamNum(params, type);
     if (check != valid) {
       return check;
     }
@@ -344,6 +348,8 @@ runCommandValidation(char *command, Label *labels, CmdSubtype type, char *cmdNam
     if (check != valid) {
       return check;
     }
+  } else if (type != stop_cmd) {
+    return missing_param;
   }
 
   return valid;
@@ -365,7 +371,7 @@ ErrorType checkLabelName(char *label) {
     return valid;
   }
 
-  if (strlen(label) > 31) {
+  if (strlen(label) > MAX_LABEL_LENGTH) {
     return label_syntax;
   }
   if (!isalpha(label[0])) {
@@ -450,53 +456,42 @@ ErrorType checkOrderParamValue(char *param, OrderType type) {
  *
  * Params:
  * char* order: the whole order line.
- * Label *labels: array of all labels.
+ * LabelTable *labels: array of all labels.
  *
  * Returns:
  * ErrorType status: valid if the command is correct, otherwise - the specific error.
  */
-ErrorType validateOrder(char *order, Label *labels) {
-  int paramNum;
-  OrderType type;
-  ErrorType check = valid;
-  char *orderName, *label, *params, **paramStr;
-  LineParts *lineParts = getCommandParts(order);
-  orderName = lineParts->cmdName;
-  label = lineParts->labelName;
-  params = lineParts->params;
-  paramNum = getNumOfParamData(order);
-  type = sortOrder(orderName);
+ErrorType validateOrder(char *order, LabelTable *labels) {
+  char storage[LINE_PARTS_SIZE];
+  LineParts lineParts;
 
   if (order[0] == ':') {
     return empty_label;
   }
-
-  if (params != NULL) {
-    paramStr = strSplit(params, ',');
-    check = runOrderValidation(labels, paramNum, type, paramStr, orderName, label, params);
-    freeStringArray(paramStr);
+  /* The parts are cut in a copy on the stack - the lines are at most MAX_LINE_LENGTH. */
+  if (splitCommandParts(order, &lineParts, storage, sizeof(storage)) == false) {
+    return directive_name;
   }
-  freeLinePart(lineParts);
-  return check;
+
+  return runOrderValidation(labels, sortOrder(lineParts.cmdName), lineParts.cmdName, lineParts.labelName,
+                            lineParts.params);
 }
 
 /* Run all checks for validate order.
  *
  * Params:
- * Label *labels: array of all labels.
- * int paramNum: number of parameters in order.
+ * LabelTable *labels: array of all labels.
  * OrderType type: the order type.
- * char **paramStr: string array of params.
  * char *orderName: the order name.
  * char *label: label name if exists.
- * char *params: the whole string of params.
+ * char *params: the whole string of params (NULL if there are none).
  *
  * Returns:
  * ErrorType check: the correct status of line.
 */
-ErrorType runOrderValidation(Label *labels, int paramNum, OrderType type,char **paramStr,
-                             char *orderName, char *label, char *params) {
-  int i;
+ErrorType runOrderValidation(LabelTable *labels, OrderType type, char *orderName, char *label, char *params) {
+  char storage[LINE_PARTS_SIZE];
+  char *param, *iterator = storage;
   ErrorType check;
   check = checkLabelName(label);
   if (check != valid) {
@@ -508,12 +503,17 @@ ErrorType runOrderValidation(Label *labels, int paramNum, OrderType type,char **
     return check;
   }
 
+  /* Directive without parameters. */
+  if (params == NULL) {
+    return number_of_parameters;
+  }
+
   if (type == asciz) {
     return checkAsciz(params);
   }
 
   if (type == entry || type == external) {
-    if (paramNum != 1) {
+    if (getNumOfParams(params) != 1) {
       return number_of_parameters;
     }
 
@@ -528,9 +528,13 @@ ErrorType runOrderValidation(Label *labels, int paramNum, OrderType type,char **
     return check;
   }
 
-
-  for (i = 0; i < paramNum; i++) {
-    check = (checkOrderParamValue(trimStr(*(paramStr + i)), type));
+  /* There are no empty parameters after the check of the commas, they are cut in a copy on the stack. */
+  if (strlen(params) >= sizeof(storage)) {
+    return value_out_of_range;
+  }
+  strcpy(storage, params);
+  while ((param = myStrsep(&iterator, ",")) != NULL) {
+    check = (checkOrderParamValue(trimStr(param), type));
     if (check != valid) {
       return check;
     }
@@ -544,12 +548,12 @@ ErrorType runOrderValidation(Label *labels, int paramNum, OrderType type,char **
  *
  * Params:
  * char* line: the whole line to check.
- * Label* labels: linked list of labels.
+ * LabelTable *labels: linked list of labels.
  *
  * Returns:
  * ErrorType status: valid if the line meet its settings, if ain't - the specific error will be returned.
  */
-ErrorType checkLine(char *line, Label *labels) {
+ErrorType checkLine(char *line, LabelTable *labels) {
   char *labelName, *cmdName;
   LineParts *lineParts;
   if (isEmptyLine(line) == true || isCommentLine(line) == true) {
@@ -685,6 +689,10 @@ char *getMessageErrorType(ErrorType type) {
       return "empty label is invalid.";
     case label_with_invalid_line:
       return "label defined in invalid or empty line.";
+    case branch_out_of_range:
+      return "the distance to the label of the branch does not fit 16 bits immediate.";
+    case address_out_of_range:
+      return "the address of the label does not fit 25 bits address field.";
     default:
       return "unknown error occurred.";
   }
@@ -8,15 +8,18 @@
 #include "stringExtension.h"
 
 
+/* The most parameters of command (R arithmetic, I arithmetic and branch commands have 3). */
+#define MAX_COMMAND_PARAMS 3
+
 ErrorType checkRegisterName(char *reg);
 
 ErrorType checkCommandName(char *commandName);
 
-ErrorType checkParamNum(char *command, CmdSubtype type);
+ErrorType checkParamNum(char *params, CmdSubtype type);
 
 ErrorType checkLabelName(char *label);
 
-ErrorType checkParamStandard(char *command, Label *labels, CmdSubtype type);
+ErrorType checkParamStandard(char *command, LabelTable *labels, CmdSubtype type);
 
 ErrorType checkCommas(char *params);
 
@@ -24,19 +27,19 @@ Boolean checkParamValue(char *param);
 
 ErrorType checkOrderParamValue(char *param, OrderType type);
 
-ErrorType validateCommand(char *command, Label *labels);
+ErrorType validateCommand(char *command, LabelTable *labels);
 
 CmdSubtype sortCmd(char *commandName);
 
 ErrorType checkAsciz(char *ascizStr);
 
-ErrorType validateOrder(char *order, Label *labels);
+ErrorType validateOrder(char *order, LabelTable *labels);
 
 ErrorType checkOrderName(char *order);
 
 OrderType sortOrder(char *orderName);
 
-ErrorType checkLine(char *line, Label *labels);
+ErrorType checkLine(char *line, LabelTable *labels);
 
 char *getMessageErrorType(ErrorType type);
 
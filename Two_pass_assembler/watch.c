@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <unistd.h>
+#include <sys/inotify.h>
+#include "watch.h"
+#include "diskFiles.h"
+#include "assembler.h"
+
+#define WATCH_EVENTS (IN_CLOSE_WRITE | IN_MOVED_TO)
+#define EVENTS_BUFFER_SIZE 4096
+
+/* Data structure representing source file that is watched. */
+typedef struct watchedFile {
+    char *name;
+    char *base;
+    int descriptor;
+    Boolean changed;
+} WatchedFile;
+
+int addWatchedFile(int inotify, WatchedFile *file, char *name);
+
+void reassembleFile(WatchedFile *file, Options *options, AssemblerContext *context);
+
+void markChangedFiles(WatchedFile *files, int numOfFiles, struct inotify_event *event);
+
+/* Start watching the directory of source file (editors usually replace the file itself).
+ *
+ * Params:
+ * int inotify: the inotify instance.
+ * WatchedFile *file: the watched file to fill.
+ * char *name: the name of the source file.
+ *
+ * Returns:
+ * int status: 0 if succeeded, otherwise - -1.
+*/
+int addWatchedFile(int inotify, WatchedFile *file, char *name) {
+  char *slash = strrchr(name, '/');
+  char *dir;
+
+  file->name = name;
+  file->changed = true;
+  if (slash == NULL) {
+    file->base = name;
+    file->descriptor = inotify_add_watch(inotify, ".", WATCH_EVENTS);
+    return file->descriptor < 0 ? -1 : 0;
+  }
+
+  file->base = slash + 1;
+  dir = duplicateStr(name);
+  if (dir == NULL) {
+    return -1;
+  }
+  dir[slash - name == 0 ? 1 : slash - name] = '\0';
+  file->descriptor = inotify_add_watch(inotify, dir, WATCH_EVENTS);
+  free(dir);
+  return file->descriptor < 0 ? -1 : 0;
+}
+
+/* Assemble again the watched file, the output files are written only if their content changed.
+ *
+ * Params:
+ * WatchedFile *file: the watched file.
+ * Options *options: the options of the assembler.
+ * AssemblerContext *context: the warm context that is shared between all the files.
+*/
+void reassembleFile(WatchedFile *file, Options *options, AssemblerContext *context) {
+  FILE *fptr = fopen(file->name, "r");
+
+  file->changed = false;
+  if (fptr == NULL) {
+    printf("Cannot open file %s \n", file->name);
+    return;
+  }
+  assembleFile(file->name, fptr, NULL, 0, options, NULL, context, NULL);
+  fclose(fptr);
+  printf("Assembled: %s \n", file->name);
+  fflush(stdout);
+}
+
+/* Mark the watched files that the inotify event is about.
+ *
+ * Params:
+ * WatchedFile *files: the watched files.
+ * int numOfFiles: the number of watched files.
+ * struct inotify_event *event: the event.
+*/
+void markChangedFiles(WatchedFile *files, int numOfFiles, struct inotify_event *event) {
+  int i;
+
+  if (event->len == 0) {
+    return;
+  }
+  for (i = 0; i < numOfFiles; i++) {
+    if (files[i].descriptor == event->wd && strcmp(files[i].base, event->name) == 0) {
+      files[i].changed = true;
+    }
+  }
+}
+
+/* Assemble all the files, and then stay resident and assemble again every file that is changed.
+ *
+ * Params:
+ * int args: number of arguments.
+ * char *argv[]: the arguments (options and names of files).
+ * Options *options: the options of the assembler.
+ *
+ * Returns:
+ * int status: exit status - returns only if watching failed.
+*/
+int watchFiles(int args, char *argv[], Options *options) {
+  union {
+      struct inotify_event event;
+      char bytes[EVENTS_BUFFER_SIZE];
+  } events;
+  WatchedFile *files;
+  AssemblerContext context;
+  struct inotify_event *event;
+  int inotify, numOfFiles = 0, i;
+  long length, offset;
+
+  files = (WatchedFile *) calloc(args, sizeof(WatchedFile));
+  inotify = inotify_init();
+  if (files == NULL || inotify < 0) {
+    printf("Cannot watch the files \n");
+    free(files);
+    return 1;
+  }
+
+  for (i = 1; i < args; i++) {
+    if (isOption(argv[i]) == true) {
+      continue;
+    }
+    if (isAsFile(argv[i]) != true) {
+      printf("File is not as file");
+      continue;
+    }
+    if (addWatchedFile(inotify, &files[numOfFiles], argv[i]) != 0) {
+      printf("Cannot watch file %s \n", argv[i]);
+      continue;
+    }
+    numOfFiles++;
+  }
+
+  initAssemblerContext(&context);
+  while (numOfFiles > 0) {
+    for (i = 0; i < numOfFiles; i++) {
+      if (files[i].changed == true) {
+        reassembleFile(&files[i], options, &context);
+      }
+    }
+
+    /* Block until next events, all the events that came together are handled at once. */
+    length = (long) read(inotify, events.bytes, sizeof(events.bytes));
+    if (length <= 0) {
+      break;
+    }
+    offset = 0;
+    while (offset < length) {
+      event = (struct inotify_event *) (events.bytes + offset);
+      markChangedFiles(files, numOfFiles, event);
+      offset += (long) sizeof(struct inotify_event) + (long) event->len;
+    }
+  }
+
+  freeAssemblerContext(&context);
+  close(inotify);
+  free(files);
+  return 1;
+}
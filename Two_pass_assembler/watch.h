@@ -0,0 +1,8 @@
+#ifndef MAMAN14_WATCH_H
+#define MAMAN14_WATCH_H
+
+#include "options.h"
+
+int watchFiles(int args, char *argv[], Options *options);
+
+#endif
@@ -0,0 +1,312 @@
+#include "libassembler.h"
+#include "incremental.h"
+#include "encoding.h"
+#include "validation.h"
+#include "generator.h"
+
+#define DEFAULT_LINES 500000
+/* The commands between the branch and its label - at the edges of the 16 bits immediate. Forward, 8190 commands
+ * are 32764 bytes (the last multiple of 4 in the range) and 8191 are 32768; backward, 8191 commands are -32768
+ * bytes (the first distance in the range) and 8192 are -32772. */
+#define NEAR_FORWARD_COMMANDS 8190
+#define FAR_FORWARD_COMMANDS 8191
+#define NEAR_BACKWARD_COMMANDS 8191
+#define FAR_BACKWARD_COMMANDS 8192
+/* The address of the branch of checkBranchDistance, far enough from 0 for the backward labels. */
+#define BRANCH_ADDRESS 40000L
+
+Boolean checkWideProgram(unsigned long seed, unsigned long numOfLines);
+
+int checkAddressColumn(Buffer *output, int column, Boolean consecutive, char *name);
+
+Boolean checkFarBranch(unsigned long commands, Boolean backward, Boolean expectError);
+
+Boolean checkBranchDistance(void);
+
+Boolean checkJumpAddress(void);
+
+/*
+ * Wide addresses gate: assemble generated program of some megabytes, whose addresses are longer than
+ * 4 digits, and check that every line of the object, entries and externals files prints its address
+ * with the same width (and that the addresses of the object file are consecutive). Then check that
+ * branch whose label is out of the range of the 16 bits immediate, and J command whose label is out of
+ * the 25 bits address, are errors of the line of the command - with assembleSource and with
+ * reassembleSource.
+ *
+ * Usage: widegate [--seed=N] [--lines=N]
+ */
+int main(int args, char *argv[]) {
+  unsigned long seed = 1;
+  unsigned long numOfLines = DEFAULT_LINES;
+  int failures = 0;
+  int i;
+
+  for (i = 1; i < args; i++) {
+    if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, NULL, 10);
+    } else if (strncmp(argv[i], "--lines=", 8) == 0 && atol(argv[i] + 8) > 0) {
+      numOfLines = strtoul(argv[i] + 8, NULL, 10);
+    } else {
+      fprintf(stderr, "Unknown option: %s \n", argv[i]);
+      exit(1);
+    }
+  }
+
+  failures += checkWideProgram(seed, numOfLines) == true ? 0 : 1;
+  failures += checkFarBranch(NEAR_FORWARD_COMMANDS, false, false) == true ? 0 : 1;
+  failures += checkFarBranch(NEAR_BACKWARD_COMMANDS, true, false) == true ? 0 : 1;
+  failures += checkFarBranch(FAR_FORWARD_COMMANDS, false, true) == true ? 0 : 1;
+  failures += checkFarBranch(FAR_BACKWARD_COMMANDS, true, true) == true ? 0 : 1;
+  failures += checkBranchDistance() == true ? 0 : 1;
+  failures += checkJumpAddress() == true ? 0 : 1;
+
+  if (failures > 0) {
+    printf("Error! %d checks of wide addresses failed. \n", failures);
+    return 1;
+  }
+  return 0;
+}
+
+/* Assemble generated program, and check the widths of the addresses of its outputs.
+ *
+ * Params:
+ * unsigned long seed: the seed of the generated source.
+ * unsigned long numOfLines: the number of lines of the generated source.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkWideProgram(unsigned long seed, unsigned long numOfLines) {
+  AssemblerContext context;
+  GeneratorMix mix;
+  Buffer source;
+  int objectWidth, entriesWidth, externalsWidth;
+  Boolean status = true;
+
+  initGeneratorMix(&mix);
+  initBuffer(&source);
+  if (generateSource(&source, seed, numOfLines, &mix) == false) {
+    printf("Error: Allocation Error! \n");
+    return false;
+  }
+
+  initAssemblerContext(&context);
+  if (assembleSource(&context, source.data, source.length) != assembled) {
+    printf("The generated source was not assembled (%d errors, the first in line %d: %s) \n",
+           context.numOfErrors, context.errors != NULL ? context.errors->lineNumber : 0,
+           context.errors != NULL ? context.errors->message : "");
+    freeAssemblerContext(&context);
+    freeBuffer(&source);
+    return false;
+  }
+
+  objectWidth = checkAddressColumn(&context.outputs.object, 0, true, "object");
+  entriesWidth = checkAddressColumn(&context.outputs.entries, 1, false, "entries");
+  externalsWidth = checkAddressColumn(&context.outputs.externals, 1, false, "externals");
+  printf("%lu lines, %.1f MB of source, %lu bytes of code: the addresses of the object file have %d digits, "
+         "of the entries %d, of the externals %d \n", numOfLines, source.length / 1048576.0, context.IC - 100,
+         objectWidth, entriesWidth, externalsWidth);
+  if (objectWidth <= MIN_ADDRESS_WIDTH || entriesWidth == -1 || externalsWidth == -1) {
+    printf("Error! the addresses of the outputs are not printed in one wide column. \n");
+    status = false;
+  }
+
+  freeAssemblerContext(&context);
+  freeBuffer(&source);
+  return status;
+}
+
+/* Check that the addresses of output file are in one column of the same width. The first line of the
+ * object file (the lengths of the images) is skipped.
+ *
+ * Params:
+ * Buffer *output: the content of the output file.
+ * int column: the index of the address in the words of every line.
+ * Boolean consecutive: true if every address has to follow the previous one by 4.
+ * char *name: the name of the output, for the messages.
+ *
+ * Returns:
+ * int width: the width of the addresses, -1 if they are not in one column.
+*/
+int checkAddressColumn(Buffer *output, int column, Boolean consecutive, char *name) {
+  unsigned long position = 0, end, lineNumber = 0;
+  unsigned long address, previous = 0;
+  int width = 0, length, word;
+  char *text;
+
+  while (position < output->length) {
+    for (end = position; end < output->length && output->data[end] != '\n'; end++) {
+    }
+    lineNumber++;
+    text = output->data + position;
+    position = end + 1;
+    if (consecutive == true && lineNumber == 1) {
+      continue;
+    }
+
+    for (word = 0; word < column; word++) {
+      while (*text != ' ') {
+        text++;
+      }
+      text++;
+    }
+    for (length = 0; text[length] >= '0' && text[length] <= '9'; length++) {
+    }
+    address = strtoul(text, NULL, 10);
+
+    if (width == 0) {
+      width = length;
+    } else if (length != width) {
+      printf("Error! line %lu of the %s file has address of %d digits, instead of %d. \n", lineNumber, name,
+             length, width);
+      return -1;
+    }
+    if (consecutive == true && previous != 0 && address != previous + 4) {
+      printf("Error! line %lu of the %s file has address %lu after %lu. \n", lineNumber, name, address, previous);
+      return -1;
+    }
+    previous = address;
+  }
+  return width;
+}
+
+/* Assemble branch whose label is some commands forward or backward, with assembleSource and with
+ * reassembleSource, and check if it is error of its line.
+ *
+ * Params:
+ * unsigned long commands: the number of commands between the branch and its label.
+ * Boolean backward: true if the label is before the branch.
+ * Boolean expectError: true if the label is out of the range of the branch.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkFarBranch(unsigned long commands, Boolean backward, Boolean expectError) {
+  AssemblerContext context;
+  IncrementalSource incremental;
+  AssemblerStatus statuses[2];
+  Error *errors[2];
+  Buffer source;
+  int branchLine = backward == true ? (int) commands + 2 : 1;
+  Boolean status = true;
+  unsigned long i;
+  int run;
+
+  initBuffer(&source);
+  bufferPrintf(&source, backward == true ? "FAR: add $1, $2, $3\n" : "bne $1, $2, FAR\n");
+  for (i = 0; i < commands; i++) {
+    bufferPrintf(&source, "add $1, $2, $3\n");
+  }
+  bufferPrintf(&source, backward == true ? "bne $1, $2, FAR\n" : "FAR: stop\n");
+  if (source.overflow == true) {
+    freeBuffer(&source);
+    return false;
+  }
+
+  initAssemblerContext(&context);
+  statuses[0] = assembleSource(&context, source.data, source.length);
+  errors[0] = context.errors;
+  initIncrementalSource(&incremental);
+  loadIncrementalSource(&incremental, source.data, source.length);
+  statuses[1] = reassembleSource(&incremental);
+  errors[1] = incremental.context.errors;
+
+  for (run = 0; run < 2; run++) {
+    if (expectError == false && statuses[run] != assembled) {
+      printf("Error! %s branch over %lu commands was not assembled. \n", backward == true ? "backward" : "forward",
+             commands);
+      status = false;
+    } else if (expectError == true && (statuses[run] != source_errors || errors[run] == NULL ||
+                                       errors[run]->lineNumber != branchLine || errors[run]->next != NULL ||
+                                       strcmp(errors[run]->message, getMessageErrorType(branch_out_of_range)) != 0)) {
+      printf("Error! %s branch over %lu commands is not error of line %d. \n", backward == true ? "backward" : "forward",
+             commands, branchLine);
+      status = false;
+    }
+  }
+
+  freeIncrementalSource(&incremental);
+  freeAssemblerContext(&context);
+  freeBuffer(&source);
+  return status;
+}
+
+/* Check that branch to label at the first and the last distances of the 16 bits immediate (-32768 and 32767
+ * bytes) is valid, and one byte out of them is error. The commands of program are 4 bytes apart, so those
+ * distances are put in the table as the values of the labels.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkBranchDistance(void) {
+  char lines[4][MAX_LINE_LENGTH] = {"bne $1, $2, LAST", "bne $1, $2, AFTER", "bne $1, $2, FIRST", "bne $1, $2, BEFORE"};
+  long distances[4] = {MAX_BRANCH_DISTANCE, MAX_BRANCH_DISTANCE + 1, MIN_BRANCH_DISTANCE, MIN_BRANCH_DISTANCE - 1};
+  ErrorType expected[4] = {valid, branch_out_of_range, valid, branch_out_of_range};
+  LabelTable labels;
+  Command *command;
+  Boolean status = true;
+  int i;
+
+  initLabelTable(&labels);
+  addNewLabel(&labels, "LAST", BRANCH_ADDRESS + distances[0], ATTR_CODE);
+  addNewLabel(&labels, "AFTER", BRANCH_ADDRESS + distances[1], ATTR_CODE);
+  addNewLabel(&labels, "FIRST", BRANCH_ADDRESS + distances[2], ATTR_CODE);
+  addNewLabel(&labels, "BEFORE", BRANCH_ADDRESS + distances[3], ATTR_CODE);
+
+  for (i = 0; i < 4; i++) {
+    command = initNewCommand(lines[i], BRANCH_ADDRESS);
+    if (command == NULL) {
+      status = false;
+      continue;
+    }
+    encodeICmd(command, &labels);
+    if (checkCommandRange(command, &labels) != expected[i]) {
+      printf("Error! branch over %ld bytes is %s. \n", distances[i], expected[i] == valid ? "error" : "not error");
+      status = false;
+    } else if (expected[i] == valid && command->encoding.i.immed != distances[i]) {
+      printf("Error! branch over %ld bytes has immediate %d. \n", distances[i], command->encoding.i.immed);
+      status = false;
+    }
+    freeCommands(&command);
+  }
+
+  freeLabelTable(&labels);
+  return status;
+}
+
+/* Check that J command whose label is out of the 25 bits address is error. Program that long does
+ * not fit the memory of the assembler, so the label is put in the table with that value.
+ *
+ * Returns:
+ * Boolean status: true if the check passed, otherwise - false.
+*/
+Boolean checkJumpAddress(void) {
+  char lines[2][MAX_LINE_LENGTH] = {"jmp NEAR", "jmp FAR"};
+  ErrorType expected[2] = {valid, address_out_of_range};
+  LabelTable labels;
+  Command *command;
+  Boolean status = true;
+  int i;
+
+  initLabelTable(&labels);
+  addNewLabel(&labels, "NEAR", MAX_ADDRESS, ATTR_CODE);
+  addNewLabel(&labels, "FAR", MAX_ADDRESS + 1, ATTR_CODE);
+
+  for (i = 0; i < 2; i++) {
+    command = initNewCommand(lines[i], 100);
+    if (command == NULL) {
+      status = false;
+      continue;
+    }
+    encodeJCmd(command, &labels);
+    if (checkCommandRange(command, &labels) != expected[i]) {
+      printf("Error! %s to address %lu is %s. \n", lines[i], labels.items[command->operand].value,
+             expected[i] == valid ? "error" : "not error");
+      status = false;
+    }
+    freeCommands(&command);
+  }
+
+  freeLabelTable(&labels);
+  return status;
+}